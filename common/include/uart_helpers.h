@@ -1,16 +1,90 @@
 #ifndef UART_HELPERS_H
 #define UART_HELPERS_H
 
-// NRF APPS
-#include "app_uart.h"   // app_uart_event_handler_t
+/*      INCLUDES                                                    */
 
-// Sending and reception buffers sizes.
-#define RX_FIFO_SIZE    256
-#define TX_FIFO_SIZE    256
+// C STANDARD
+#include <stdbool.h>    // bool
+#include <stdint.h>     // uint*_t
+
+// NRF
+#include "nrf_uarte.h"  // NRF_UARTE_BAUDRATE_*
+
+/*      DEFINES                                                     */
+
+// Baudrate of the UART channel.
+#ifndef UART_BAUDRATE
+#define UART_BAUDRATE       NRF_UARTE_BAUDRATE_115200
+#endif /* ! UART_BAUDRATE */
+
+// Reception ring size: large enough to hold a full command.
+#define RX_FIFO_SIZE        1024
+
+/* Size of each of the two reception EasyDMA buffers. A buffer is copied
+** to the reception ring when it is full, or when the line stays idle.
+*/
+#define RX_DMA_BUFFER_SIZE  64
+
+// Time without received byte after which the line is considered idle.
+#define RX_IDLE_TIMEOUT_MS  2
+
+/* TIMER instance counting received bytes, which shall be enabled in the
+** configuration along with PPI.
+*/
+#ifndef RX_COUNTER_TIMER
+#define RX_COUNTER_TIMER    1
+#endif /* ! RX_COUNTER_TIMER */
+
+/* Sending ring size: large enough to hold a full routing table JSON, so
+** that sending it never waits for the UART.
+*/
+#define TX_RING_SIZE    2048
+
+/*      TYPEDEFS                                                    */
+
+// UART events signaled to the user.
+typedef enum
+{
+    /* Received bytes are ready to be read: a reception buffer is full,
+    ** or the line is idle.
+    */
+    UART_EVT_RX_DATA_READY,
+
+    // Every queued byte was sent.
+    UART_EVT_TX_DONE,
+
+    /* Communication error. Bytes not read yet from the receiving buffer
+    ** are dropped, and reception starts again.
+    */
+    UART_EVT_ERROR,
+
+} uart_evt_t;
+
+// UART event handler, called from the UART interrupt.
+typedef void (*uart_event_handler_t)(uart_evt_t event);
 
 /* Initializes the UART channel with predefined parameters and an event
-** callback function.
+** callback function, and starts reception.
 */
-void uart_init(const app_uart_event_handler_t handler);
+void uart_init(uart_event_handler_t handler);
+
+/* Queues the given bytes for asynchronous sending and returns the number
+** of queued bytes, lower than the given length if the sending ring is
+** full. Never blocks. Shall only be called from the main context.
+*/
+uint32_t uart_send(const uint8_t* data, uint32_t length);
+
+/* Queues all the given bytes for asynchronous sending. Only waits while
+** the sending ring is full, which happens when output is produced faster
+** than the UART baudrate for a long time. Shall only be called from the
+** main context.
+*/
+void uart_write(const uint8_t* data, uint32_t length);
+
+// Returns the number of bytes that can currently be queued for sending.
+uint32_t uart_tx_available(void);
+
+// Returns true if every queued byte was sent.
+bool uart_tx_idle(void);
 
 #endif /* ! UART_HELPERS_H */
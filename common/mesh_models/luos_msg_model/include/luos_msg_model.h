@@ -69,6 +69,9 @@ struct luos_msg_model_s
 
     // User callback called on SET command.
     luos_msg_model_set_cb_t     set_cb;
+
+    // Number of received SET commands dropped as already handled.
+    uint32_t                    nb_duplicates;
 };
 
 // Initializes the given instance with the given parameters.
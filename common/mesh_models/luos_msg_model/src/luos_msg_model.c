@@ -156,6 +156,8 @@ static void luos_msg_model_set_cb(access_model_handle_t handle,
     if (set_cmd->transaction_id <= s_curr_transaction_id)
     {
         // Transaction either already occured or is currently occuring.
+        instance->nb_duplicates++;
+
         return;
     }
 
@@ -3,56 +3,443 @@
 // C STANDARD
 #include <stdbool.h>            // bool
 #include <stdint.h>             // uint32_t
-#include <string.h>             // memset
+#include <string.h>             // memcpy
 
 // NRF
-#include "boards.h"             /* RX_PIN_NUMBER, TX_PIN_NUMBER,
-                                ** APP_UART_FLOW_CONTROL_DISABLED
-                                */
-#include "nrf_uart.h"           // NRF_UART_BAUDRATE_115200
+#include "boards.h"             // RX_PIN_NUMBER, TX_PIN_NUMBER
+#include "nrf_uarte.h"          // NRF_UARTE_EVENT_RXDRDY
+#include "nrfx_ppi.h"           // nrfx_ppi_*
+#include "nrfx_timer.h"         // nrfx_timer_*
+#include "nrfx_uarte.h"         // nrfx_uarte_*
 
 // NRF APPS
 #include "app_error.h"          // APP_ERROR_CHECK
-#include "app_uart.h"           // app_uart_*, APP_UART_FIFO_INIT
-#include "app_util_platform.h"  // APP_IRQ_PRIORITY_LOWEST
-
-void uart_init(const app_uart_event_handler_t handler)
-{
-    app_uart_comm_params_t params;
-    memset(&params, 0, sizeof(app_uart_comm_params_t));
-
-    params.rx_pin_no    = RX_PIN_NUMBER;
-    params.tx_pin_no    = TX_PIN_NUMBER;
-    params.rts_pin_no   = RTS_PIN_NUMBER;
-    params.cts_pin_no   = CTS_PIN_NUMBER;
-    params.flow_control = APP_UART_FLOW_CONTROL_DISABLED;
-    params.use_parity   = false;
-    params.baud_rate    = NRF_UART_BAUDRATE_115200;
-
-    uint32_t err_code;
-    APP_UART_FIFO_INIT(
-        &params,
-        RX_FIFO_SIZE,
-        TX_FIFO_SIZE,
-        handler,
-        APP_IRQ_PRIORITY_LOWEST,
-        err_code
-    );
+#include "app_timer.h"          /* app_timer_*,
+                                ** APP_TIMER_CONFIG_IRQ_PRIORITY
+                                */
+#include "app_util_platform.h"  // CRITICAL_REGION_*
+
+// LUOS
+#include "luos_utils.h"         // LUOS_ASSERT
+
+// Maximum size of a single EasyDMA transfer.
+#define UARTE_MAX_TRANSFER  ((1 << UARTE0_EASYDMA_MAXCNT_SIZE) - 1)
+
+_Static_assert((TX_RING_SIZE & (TX_RING_SIZE - 1)) == 0,
+               "UART sending ring size must be a power of two!");
+_Static_assert((RX_FIFO_SIZE & (RX_FIFO_SIZE - 1)) == 0,
+               "UART reception FIFO size must be a power of two!");
+
+/* Priority of the UART, byte counter and app timer interrupts. Sharing
+** it, the reception handlers and the idle check never preempt each
+** other, and the user handler is never reentered.
+*/
+#define UART_IRQ_PRIORITY   APP_TIMER_CONFIG_IRQ_PRIORITY
+
+// UARTE driver instance.
+static const nrfx_uarte_t   s_uarte = NRFX_UARTE_INSTANCE(0);
+
+// TIMER driver instance counting received bytes.
+static const nrfx_timer_t   s_rx_counter = NRFX_TIMER_INSTANCE(RX_COUNTER_TIMER);
+
+// User event handler.
+static uart_event_handler_t s_handler;
+
+/* Sending ring. Bytes are queued at `head` from the main context, and
+** sent by EasyDMA directly from the ring, one contiguous segment at a
+** time starting at `tail`: no copy is needed between the ring and the
+** DMA transfers.
+*/
+static struct
+{
+    uint8_t             data[TX_RING_SIZE];
+
+    // Next byte to queue (free-running), only moved by `uart_send`.
+    volatile uint32_t   head;
+
+    // Next byte to send (free-running), only moved by the interrupt.
+    volatile uint32_t   tail;
+
+    // Size of the current DMA transfer, 0 if none.
+    volatile uint32_t   in_flight;
+
+} s_tx;
+
+/* Reception path. EasyDMA receives in two buffers used alternately, so
+** that reception never stops, and a TIMER counts received bytes through
+** PPI. Bytes are copied to the ring when a buffer is full, or when the
+** line stays idle: the count then tells how much of the receiving buffer
+** is filled. The idle check only runs while bytes are arriving.
+*/
+static struct
+{
+    // Reception ring, filled from the interrupt and emptied by `_read`.
+    uint8_t             data[RX_FIFO_SIZE];
+    volatile uint32_t   head;
+    volatile uint32_t   tail;
+
+    /* EasyDMA buffers. Being contiguous, they form a ring of the received
+    ** stream: its n-th byte is at `n % (2 * RX_DMA_BUFFER_SIZE)`.
+    */
+    uint8_t             dma_buf[2][RX_DMA_BUFFER_SIZE];
+
+    // Number of received bytes copied to the ring (free-running).
+    uint32_t            nb_copied;
+
+    // Number of received bytes once the receiving buffer is full.
+    uint32_t            buffer_end;
+
+    // Number of received bytes at the last idle check.
+    uint32_t            nb_checked;
+
+} s_rx;
+
+// Timer checking the line idleness while bytes are arriving.
+APP_TIMER_DEF(s_rx_idle_timer);
+
+/* Starts sending the next contiguous segment of the sending ring if no
+** transfer is ongoing. Shall be called with UART interrupts masked.
+*/
+static void tx_start(void);
+
+// Starts counting received bytes and reception in both EasyDMA buffers.
+static void rx_start(void);
+
+// Copies received bytes to the reception ring, dropping overflowing ones.
+static void rx_push(const uint8_t* data, uint32_t length);
+
+/* Copies received bytes from the EasyDMA buffers to the reception ring,
+** up to the given number of received bytes.
+*/
+static void rx_copy(uint32_t nb_received);
+
+// Starts the idle check on the first byte of a burst.
+static void rx_counter_event_handler(nrf_timer_event_t event,
+                                     void* context);
+
+/* Copies the partially filled buffer to the ring if no byte was received
+** since the last check, or checks again later.
+*/
+static void rx_idle_check(void* context);
+
+// Manages UARTE driver events.
+static void uarte_event_handler(const nrfx_uarte_event_t* event,
+                                void* context);
+
+void uart_init(uart_event_handler_t handler)
+{
+    s_handler = handler;
+
+    nrfx_uarte_config_t config = NRFX_UARTE_DEFAULT_CONFIG;
+    config.pseltxd              = TX_PIN_NUMBER;
+    config.pselrxd              = RX_PIN_NUMBER;
+    config.pselcts              = NRF_UARTE_PSEL_DISCONNECTED;
+    config.pselrts              = NRF_UARTE_PSEL_DISCONNECTED;
+    config.hwfc                 = NRF_UARTE_HWFC_DISABLED;
+    config.parity               = NRF_UARTE_PARITY_EXCLUDED;
+    config.baudrate             = UART_BAUDRATE;
+    config.interrupt_priority   = UART_IRQ_PRIORITY;
+
+    nrfx_err_t err_code = nrfx_uarte_init(&s_uarte, &config,
+                                          uarte_event_handler);
+    APP_ERROR_CHECK(err_code);
+
+    nrfx_timer_config_t counter_config  = NRFX_TIMER_DEFAULT_CONFIG;
+    counter_config.mode                 = NRF_TIMER_MODE_LOW_POWER_COUNTER;
+    counter_config.bit_width            = NRF_TIMER_BIT_WIDTH_32;
+    counter_config.interrupt_priority   = UART_IRQ_PRIORITY;
+
+    err_code = nrfx_timer_init(&s_rx_counter, &counter_config,
+                               rx_counter_event_handler);
     APP_ERROR_CHECK(err_code);
+
+    // Each received byte increments the counter.
+    nrf_ppi_channel_t   ppi_channel;
+    err_code = nrfx_ppi_channel_alloc(&ppi_channel);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrfx_ppi_channel_assign(ppi_channel,
+        nrfx_uarte_event_address_get(&s_uarte, NRF_UARTE_EVENT_RXDRDY),
+        nrfx_timer_task_address_get(&s_rx_counter, NRF_TIMER_TASK_COUNT));
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrfx_ppi_channel_enable(ppi_channel);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_create(&s_rx_idle_timer,
+                                APP_TIMER_MODE_SINGLE_SHOT, rx_idle_check);
+    APP_ERROR_CHECK(err_code);
+
+    rx_start();
 }
 
-// Sends the given amount of bytes on the UART.
-int _write(int fd, char* str, int len)
+uint32_t uart_send(const uint8_t* data, uint32_t length)
 {
-    for (int index = 0; index < len; index++)
+    /* `head` is only moved from the main context, and an interrupt
+    ** waiting for room in `uart_write` would never let it be freed.
+    */
+    LUOS_ASSERT(__get_IPSR() == 0);
+
+    uint32_t available  = uart_tx_available();
+    if (length > available)
+    {
+        length = available;
+    }
+
+    // Copy bytes in the ring, in two parts if it wraps around.
+    uint32_t offset     = s_tx.head & (TX_RING_SIZE - 1);
+    uint32_t first_part = TX_RING_SIZE - offset;
+    if (first_part > length)
     {
-        uint32_t err_code;
-        do
+        first_part = length;
+    }
+    memcpy(s_tx.data + offset, data, first_part);
+    memcpy(s_tx.data, data + first_part, length - first_part);
+
+    // Bytes shall be in the ring before the interrupt can send them.
+    __DMB();
+    s_tx.head += length;
+
+    CRITICAL_REGION_ENTER();
+    tx_start();
+    CRITICAL_REGION_EXIT();
+
+    return length;
+}
+
+uint32_t uart_tx_available(void)
+{
+    return TX_RING_SIZE - (s_tx.head - s_tx.tail);
+}
+
+bool uart_tx_idle(void)
+{
+    return (s_tx.head == s_tx.tail);
+}
+
+static void tx_start(void)
+{
+    if ((s_tx.in_flight > 0) || (s_tx.head == s_tx.tail))
+    {
+        // Transfer ongoing, or nothing to send.
+        return;
+    }
+
+    // Largest contiguous segment, within the EasyDMA limit.
+    uint32_t offset = s_tx.tail & (TX_RING_SIZE - 1);
+    uint32_t size   = s_tx.head - s_tx.tail;
+    if (size > (TX_RING_SIZE - offset))
+    {
+        size = TX_RING_SIZE - offset;
+    }
+    if (size > UARTE_MAX_TRANSFER)
+    {
+        size = UARTE_MAX_TRANSFER;
+    }
+
+    s_tx.in_flight  = size;
+
+    nrfx_err_t err_code = nrfx_uarte_tx(&s_uarte, s_tx.data + offset,
+                                        size);
+    APP_ERROR_CHECK(err_code);
+}
+
+static void rx_start(void)
+{
+    s_rx.nb_copied  = 0;
+    s_rx.buffer_end = RX_DMA_BUFFER_SIZE;
+    s_rx.nb_checked = 0;
+
+    // Signal the first received byte.
+    nrfx_timer_clear(&s_rx_counter);
+    nrfx_timer_compare(&s_rx_counter, NRF_TIMER_CC_CHANNEL0, 1, true);
+    nrfx_timer_enable(&s_rx_counter);
+
+    // Second call queues the secondary buffer.
+    nrfx_err_t err_code = nrfx_uarte_rx(&s_uarte, s_rx.dma_buf[0],
+                                        RX_DMA_BUFFER_SIZE);
+    APP_ERROR_CHECK(err_code);
+
+    err_code = nrfx_uarte_rx(&s_uarte, s_rx.dma_buf[1],
+                             RX_DMA_BUFFER_SIZE);
+    APP_ERROR_CHECK(err_code);
+}
+
+static void rx_push(const uint8_t* data, uint32_t length)
+{
+    uint32_t available  = RX_FIFO_SIZE - (s_rx.head - s_rx.tail);
+    if (length > available)
+    {
+        length = available;
+    }
+
+    uint32_t offset     = s_rx.head & (RX_FIFO_SIZE - 1);
+    uint32_t first_part = RX_FIFO_SIZE - offset;
+    if (first_part > length)
+    {
+        first_part = length;
+    }
+    memcpy(s_rx.data + offset, data, first_part);
+    memcpy(s_rx.data, data + first_part, length - first_part);
+
+    // Bytes shall be in the ring before `_read` can see them.
+    __DMB();
+    s_rx.head += length;
+}
+
+static void rx_copy(uint32_t nb_received)
+{
+    uint8_t*    stream  = (uint8_t*)s_rx.dma_buf;
+
+    // Free-running counts: compare their difference.
+    while ((int32_t)(nb_received - s_rx.nb_copied) > 0)
+    {
+        uint32_t offset = s_rx.nb_copied % sizeof(s_rx.dma_buf);
+        uint32_t length = nb_received - s_rx.nb_copied;
+        if (length > (sizeof(s_rx.dma_buf) - offset))
+        {
+            length  = sizeof(s_rx.dma_buf) - offset;
+        }
+
+        rx_push(stream + offset, length);
+        s_rx.nb_copied  += length;
+    }
+}
+
+static void rx_counter_event_handler(nrf_timer_event_t event,
+                                     void* context)
+{
+    if (event == NRF_TIMER_EVENT_COMPARE0)
+    {
+        s_rx.nb_checked = nrfx_timer_capture(&s_rx_counter,
+                                             NRF_TIMER_CC_CHANNEL1);
+
+        ret_code_t err_code = app_timer_start(s_rx_idle_timer,
+            APP_TIMER_TICKS(RX_IDLE_TIMEOUT_MS), NULL);
+        APP_ERROR_CHECK(err_code);
+    }
+}
+
+static void rx_idle_check(void* context)
+{
+    uint32_t    nb_received = nrfx_timer_capture(&s_rx_counter,
+                                                 NRF_TIMER_CC_CHANNEL1);
+
+    /* Bytes past the receiving buffer may not be in memory until its
+    ** RX_DONE event starts the other buffer: check again after it.
+    */
+    if ((nb_received == s_rx.nb_checked)
+        && ((int32_t)(nb_received - s_rx.buffer_end) <= 0))
+    {
+        /* Line idle: copy what the receiving buffer holds so far, while
+        ** it goes on receiving.
+        */
+        bool    copied  = (nb_received != s_rx.nb_copied);
+        rx_copy(nb_received);
+
+        // Signal the first byte of the next burst.
+        nrfx_timer_compare(&s_rx_counter, NRF_TIMER_CC_CHANNEL0,
+                           nb_received + 1, true);
+
+        if (copied && (s_handler != NULL))
+        {
+            s_handler(UART_EVT_RX_DATA_READY);
+        }
+
+        s_rx.nb_checked = nrfx_timer_capture(&s_rx_counter,
+                                             NRF_TIMER_CC_CHANNEL1);
+        if (s_rx.nb_checked == nb_received)
+        {
+            // No byte was received before the compare was set.
+            return;
+        }
+    }
+    else
+    {
+        s_rx.nb_checked = nb_received;
+    }
+
+    // Line still active.
+    ret_code_t err_code = app_timer_start(s_rx_idle_timer,
+        APP_TIMER_TICKS(RX_IDLE_TIMEOUT_MS), NULL);
+    APP_ERROR_CHECK(err_code);
+}
+
+static void uarte_event_handler(const nrfx_uarte_event_t* event,
+                                void* context)
+{
+    switch (event->type)
+    {
+    case NRFX_UARTE_EVT_TX_DONE:
+        s_tx.tail       += s_tx.in_flight;
+        s_tx.in_flight  = 0;
+
+        tx_start();
+
+        if ((s_tx.in_flight == 0) && (s_handler != NULL))
+        {
+            s_handler(UART_EVT_TX_DONE);
+        }
+        break;
+
+    case NRFX_UARTE_EVT_RX_DONE:
+    {
+        /* Buffer full: copy what the idle check left of it. Reception
+        ** goes on in the other buffer: queue this one again behind it.
+        */
+        bool    copied  = (s_rx.buffer_end != s_rx.nb_copied);
+        rx_copy(s_rx.buffer_end);
+        s_rx.buffer_end += RX_DMA_BUFFER_SIZE;
+
+        nrfx_err_t err_code = nrfx_uarte_rx(&s_uarte,
+                                            event->data.rxtx.p_data,
+                                            RX_DMA_BUFFER_SIZE);
+        APP_ERROR_CHECK(err_code);
+
+        if (copied && (s_handler != NULL))
         {
-            err_code = app_uart_put(str[index]);
-        } while (err_code != NRF_SUCCESS);
+            s_handler(UART_EVT_RX_DATA_READY);
+        }
+        break;
     }
 
+    case NRFX_UARTE_EVT_ERROR:
+    {
+        /* The driver cleared the error source and dropped both buffers:
+        ** restart reception from the beginning of the stream, dropping
+        ** the bytes not copied yet, the faulty one among them.
+        */
+        ret_code_t err_code = app_timer_stop(s_rx_idle_timer);
+        APP_ERROR_CHECK(err_code);
+
+        rx_start();
+
+        if (s_handler != NULL)
+        {
+            s_handler(UART_EVT_ERROR);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+void uart_write(const uint8_t* data, uint32_t length)
+{
+    uint32_t nb_queued = 0;
+    while (nb_queued < length)
+    {
+        nb_queued += uart_send(data + nb_queued, length - nb_queued);
+    }
+}
+
+// Queues the given amount of bytes for sending.
+int _write(int fd, char* str, int len)
+{
+    uart_write((const uint8_t*)str, len);
+
     return len;
 }
 
@@ -61,15 +448,12 @@ int _read(int fd, char* str, int len)
 {
     int index = 0;
 
-    uint32_t err_code;
-    do
+    while ((s_rx.tail != s_rx.head) && (index < len))
     {
-        err_code = app_uart_get((uint8_t*)(str + index));
-        if (err_code == NRF_SUCCESS)
-        {
-            index++;
-        }
-    } while (err_code == NRF_SUCCESS && index < len);
+        str[index] = s_rx.data[s_rx.tail & (RX_FIFO_SIZE - 1)];
+        s_rx.tail++;
+        index++;
+    }
 
     return index;
 }
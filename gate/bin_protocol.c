@@ -0,0 +1,394 @@
+#include "bin_protocol.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>            // bool
+#include <stdint.h>             // uint*_t
+#include <string.h>             // memcpy, strnlen
+
+// NRF APPS
+#include "crc16.h"              // crc16_compute
+
+// LUOS
+#include "luos.h"               // Luos_Send*
+#include "luos_utils.h"         // LUOS_ASSERT
+#include "routing_table.h"      // RoutingTB_*
+
+// CUSTOM
+#include "cmd.h"                // detection_ask
+#include "convert.h"            // routing_table_set_sent
+#include "gate.h"               // json_send
+#include "uart_helpers.h"       // uart_write
+
+/*      DEFINES                                                     */
+
+// Size of a telemetry record without its data.
+#define TELEMETRY_RECORD_HEADER_SIZE    4
+
+// Routing table entry tags.
+#define RTB_ENTRY_NODE                  0
+#define RTB_ENTRY_CONTAINER             1
+
+// Size of a routing table node entry.
+#define RTB_NODE_ENTRY_SIZE             (4 + NBR_PORT * sizeof(uint16_t))
+
+// Size of a routing table container entry without its alias.
+#define RTB_CONTAINER_ENTRY_HEADER_SIZE 5
+
+_Static_assert(MAX_DATA_MSG_SIZE <= UINT8_MAX,
+               "Telemetry record size shall fit on one byte!");
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+// Describes if binary frames are used on the pilot link.
+static volatile bool    s_enabled   = false;
+
+// Telemetry frame payload being filled, only used from the main loop.
+static struct
+{
+    uint8_t     payload[BIN_FRAME_MAX_PAYLOAD];
+    uint16_t    size;
+
+} s_telemetry;
+
+/*      STATIC FUNCTIONS                                            */
+
+// Writes the given value at the given location, in little-endian.
+static void put_u16(uint8_t* dst, uint16_t value);
+
+// Reads a little-endian value at the given location.
+static uint16_t get_u16(const uint8_t* src);
+
+/* COBS-encodes the given bytes in the given destination, which shall
+** hold BIN_FRAME_MAX_ENCODED bytes, and returns the encoded size.
+*/
+static uint32_t cobs_encode(const uint8_t* src, uint32_t size,
+                            uint8_t* dst);
+
+/* COBS-decodes the given bytes in place and returns the decoded size, or
+** 0 if the bytes are not a valid encoding.
+*/
+static uint32_t cobs_decode(uint8_t* data, uint32_t size);
+
+// Checks and applies the given decoded frame.
+static void handle_frame(container_t* container, const uint8_t* frame,
+                         uint32_t size);
+
+// Sends the Luos message carried by the given payload.
+static void handle_msg_frame(container_t* container,
+                             const uint8_t* payload, uint16_t size);
+
+bool bin_protocol_is_enabled(void)
+{
+    return s_enabled;
+}
+
+void bin_protocol_enable(bool enable)
+{
+    s_telemetry.size    = 0;
+    s_enabled           = enable;
+}
+
+void bin_protocol_send(bin_frame_type_t type, const uint8_t* payload,
+                       uint16_t size)
+{
+    // Check parameters.
+    LUOS_ASSERT(size <= BIN_FRAME_MAX_PAYLOAD);
+    LUOS_ASSERT((payload != NULL) || (size == 0));
+
+    uint8_t     frame[BIN_FRAME_MAX_SIZE];
+    frame[0]    = (uint8_t)type;
+    put_u16(frame + 1, size);
+    if (size > 0)
+    {
+        memcpy(frame + BIN_FRAME_HEADER_SIZE, payload, size);
+    }
+
+    uint32_t    frame_size  = BIN_FRAME_HEADER_SIZE + size;
+    uint16_t    crc         = crc16_compute(frame, frame_size, NULL);
+    put_u16(frame + frame_size, crc);
+    frame_size              += BIN_FRAME_CRC_SIZE;
+
+    uint8_t     encoded[BIN_FRAME_MAX_ENCODED];
+    uint32_t    encoded_size    = cobs_encode(frame, frame_size, encoded);
+    encoded[encoded_size++]     = BIN_FRAME_DELIMITER;
+
+    uart_write(encoded, encoded_size);
+}
+
+void bin_protocol_add_telemetry(const msg_t* msg)
+{
+    // Check parameter.
+    LUOS_ASSERT(msg != NULL);
+
+    // Larger data is not kept in a single message.
+    uint16_t    data_size   = msg->header.size;
+    if (data_size > MAX_DATA_MSG_SIZE)
+    {
+        data_size = MAX_DATA_MSG_SIZE;
+    }
+
+    uint16_t    record_size = TELEMETRY_RECORD_HEADER_SIZE + data_size;
+    if (s_telemetry.size + record_size > BIN_FRAME_MAX_PAYLOAD)
+    {
+        bin_protocol_flush_telemetry();
+    }
+
+    uint8_t*    record  = s_telemetry.payload + s_telemetry.size;
+    put_u16(record, msg->header.source);
+    record[2]           = msg->header.cmd;
+    record[3]           = (uint8_t)data_size;
+    memcpy(record + TELEMETRY_RECORD_HEADER_SIZE, msg->data, data_size);
+
+    s_telemetry.size    += record_size;
+}
+
+void bin_protocol_flush_telemetry(void)
+{
+    if (s_telemetry.size == 0)
+    {
+        return;
+    }
+
+    bin_protocol_send(BIN_FRAME_TELEMETRY, s_telemetry.payload,
+                      s_telemetry.size);
+    s_telemetry.size    = 0;
+}
+
+void bin_protocol_send_routing_table(void)
+{
+    routing_table_t*    routing_table   = RoutingTB_Get();
+    uint16_t            last_entry      = RoutingTB_GetLastEntry();
+
+    uint8_t             payload[BIN_FRAME_MAX_PAYLOAD];
+    uint16_t            size            = 1;
+
+    for (uint16_t i = 0; i < last_entry; i++)
+    {
+        const routing_table_t*  entry       = routing_table + i;
+        uint16_t                entry_size;
+        uint8_t                 alias_size  = 0;
+
+        switch (entry->mode)
+        {
+        case NODE:
+            entry_size  = RTB_NODE_ENTRY_SIZE;
+            break;
+        case CONTAINER:
+            alias_size  = strnlen(entry->alias, MAX_ALIAS_SIZE);
+            entry_size  = RTB_CONTAINER_ENTRY_HEADER_SIZE + alias_size;
+            break;
+        default:
+            continue;
+        }
+
+        if (size + entry_size > BIN_FRAME_MAX_PAYLOAD)
+        {
+            // More parts follow.
+            payload[0]  = false;
+            bin_protocol_send(BIN_FRAME_ROUTING_TABLE, payload, size);
+            size        = 1;
+        }
+
+        uint8_t*    dst = payload + size;
+        if (entry->mode == NODE)
+        {
+            dst[0]  = RTB_ENTRY_NODE;
+            put_u16(dst + 1, entry->node_id);
+            dst[3]  = entry->certified;
+            for (uint8_t port = 0; port < NBR_PORT; port++)
+            {
+                put_u16(dst + 4 + port * sizeof(uint16_t),
+                        entry->port_table[port]);
+            }
+        }
+        else
+        {
+            dst[0]  = RTB_ENTRY_CONTAINER;
+            put_u16(dst + 1, entry->id);
+            dst[3]  = (uint8_t)entry->type;
+            dst[4]  = alias_size;
+            memcpy(dst + RTB_CONTAINER_ENTRY_HEADER_SIZE, entry->alias,
+                   alias_size);
+        }
+
+        size        += entry_size;
+    }
+
+    // Last part, possibly without entry.
+    payload[0]  = true;
+    bin_protocol_send(BIN_FRAME_ROUTING_TABLE, payload, size);
+
+    // Following JSON tables may be sent as differences from this one.
+    routing_table_set_sent();
+}
+
+void bin_protocol_handle_frames(container_t* container, uint8_t* data,
+                                uint32_t size)
+{
+    // Check parameters.
+    LUOS_ASSERT(container != NULL);
+    LUOS_ASSERT(data != NULL);
+
+    uint32_t    frame_start = 0;
+    for (uint32_t index = 0; index < size; index++)
+    {
+        if (data[index] != BIN_FRAME_DELIMITER)
+        {
+            continue;
+        }
+
+        uint32_t    encoded_size    = index - frame_start;
+        if ((encoded_size > 0) && (encoded_size < BIN_FRAME_MAX_ENCODED))
+        {
+            uint32_t    frame_size  = cobs_decode(data + frame_start,
+                                                  encoded_size);
+            handle_frame(container, data + frame_start, frame_size);
+        }
+
+        frame_start = index + 1;
+    }
+}
+
+static void put_u16(uint8_t* dst, uint16_t value)
+{
+    dst[0]  = (uint8_t)value;
+    dst[1]  = (uint8_t)(value >> 8);
+}
+
+static uint16_t get_u16(const uint8_t* src)
+{
+    return (uint16_t)(src[0] | (src[1] << 8));
+}
+
+static uint32_t cobs_encode(const uint8_t* src, uint32_t size,
+                            uint8_t* dst)
+{
+    uint32_t    code_index  = 0;
+    uint32_t    dst_index   = 1;
+    uint8_t     code        = 1;
+
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (src[i] != 0)
+        {
+            dst[dst_index++]    = src[i];
+            code++;
+        }
+
+        if ((src[i] == 0) || (code == 0xFF))
+        {
+            // End of block: write its code and start the next one.
+            dst[code_index] = code;
+            code_index      = dst_index++;
+            code            = 1;
+        }
+    }
+
+    dst[code_index] = code;
+
+    return dst_index;
+}
+
+static uint32_t cobs_decode(uint8_t* data, uint32_t size)
+{
+    // Decoded bytes are never written ahead of the encoded ones.
+    uint32_t    read_index  = 0;
+    uint32_t    write_index = 0;
+
+    while (read_index < size)
+    {
+        uint8_t code    = data[read_index++];
+        if ((code == 0) || (read_index + code - 1 > size))
+        {
+            return 0;
+        }
+
+        for (uint8_t i = 1; i < code; i++)
+        {
+            data[write_index++] = data[read_index++];
+        }
+
+        if ((code < 0xFF) && (read_index < size))
+        {
+            data[write_index++] = 0;
+        }
+    }
+
+    return write_index;
+}
+
+static void handle_frame(container_t* container, const uint8_t* frame,
+                         uint32_t size)
+{
+    if (size < BIN_FRAME_HEADER_SIZE + BIN_FRAME_CRC_SIZE)
+    {
+        return;
+    }
+
+    uint16_t    payload_size    = get_u16(frame + 1);
+    uint32_t    crc_offset      = BIN_FRAME_HEADER_SIZE + payload_size;
+    if ((crc_offset + BIN_FRAME_CRC_SIZE != size)
+        || (crc16_compute(frame, crc_offset, NULL)
+            != get_u16(frame + crc_offset)))
+    {
+        // Corrupted frame.
+        return;
+    }
+
+    const uint8_t*  payload = frame + BIN_FRAME_HEADER_SIZE;
+    switch ((bin_frame_type_t)frame[0])
+    {
+    case BIN_FRAME_MSG:
+        handle_msg_frame(container, payload, payload_size);
+        break;
+
+    case BIN_FRAME_DETECTION:
+        detection_ask++;
+        break;
+
+    case BIN_FRAME_PROTOCOL:
+        if ((payload_size == 1) && (payload[0] == BIN_PROTOCOL_JSON))
+        {
+            bin_protocol_enable(false);
+
+            char ack_json[] = "{\"protocol\":\"json\"}\n";
+            json_send(ack_json);
+        }
+        break;
+
+    default:
+        // Frames only sent by the Gate.
+        break;
+    }
+}
+
+static void handle_msg_frame(container_t* container,
+                             const uint8_t* payload, uint16_t size)
+{
+    if (size < sizeof(header_t))
+    {
+        return;
+    }
+
+    msg_t   msg;
+    memcpy(&(msg.header), payload, sizeof(header_t));
+
+    uint16_t    data_size   = size - sizeof(header_t);
+    if (msg.header.size != data_size)
+    {
+        return;
+    }
+
+    if (data_size == 0)
+    {
+        Luos_SendMsg(container, &msg);
+    }
+    else
+    {
+        // Data larger than a message is split by Luos.
+        Luos_SendData(container, &msg, (void*)(payload + sizeof(header_t)),
+                      data_size);
+    }
+}
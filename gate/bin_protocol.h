@@ -0,0 +1,117 @@
+#ifndef BIN_PROTOCOL_H
+#define BIN_PROTOCOL_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t
+
+// LUOS
+#include "luos.h"           // container_t, msg_t
+
+/*      DEFINES                                                     */
+
+/* Binary frames are COBS-encoded, so that they never contain the
+** delimiter byte, which ends each of them.
+*/
+#define BIN_FRAME_DELIMITER     0x00
+
+// Maximum payload size of a frame.
+#define BIN_FRAME_MAX_PAYLOAD   256
+
+// Size of the frame header: type and little-endian payload length.
+#define BIN_FRAME_HEADER_SIZE   3
+
+// Size of the little-endian CRC-16/CCITT ending each frame.
+#define BIN_FRAME_CRC_SIZE      2
+
+// Maximum size of a decoded frame.
+#define BIN_FRAME_MAX_SIZE      (BIN_FRAME_HEADER_SIZE                  \
+                                 + BIN_FRAME_MAX_PAYLOAD                \
+                                 + BIN_FRAME_CRC_SIZE)
+
+// Maximum size of an encoded frame, delimiter included.
+#define BIN_FRAME_MAX_ENCODED   (BIN_FRAME_MAX_SIZE                     \
+                                 + (BIN_FRAME_MAX_SIZE / 254) + 2)
+
+/*      TYPEDEFS                                                    */
+
+// Binary frame types.
+typedef enum
+{
+    /* Raw Luos message, header followed by data. Sent by the pilot to
+    ** reach any container.
+    */
+    BIN_FRAME_MSG           = 0x01,
+
+    /* Messages received from containers, as a sequence of compact
+    ** records: source (u16), command (u8), size (u8), data. Sent by the
+    ** Gate; an empty one is a keep-alive.
+    */
+    BIN_FRAME_TELEMETRY     = 0x02,
+
+    /* Routing table part: last part flag (u8) followed by entries. A
+    ** node entry is tag 0 (u8), node ID (u16), certified (u8) and its
+    ** port table (NBR_PORT x u16). A container entry is tag 1 (u8), ID
+    ** (u16), type (u8), alias length (u8) and alias. Sent by the Gate.
+    */
+    BIN_FRAME_ROUTING_TABLE = 0x03,
+
+    // ID (u16) of a container excluded from the network. Sent by the Gate.
+    BIN_FRAME_EXCLUDED      = 0x04,
+
+    // Network detection request, without payload. Sent by the pilot.
+    BIN_FRAME_DETECTION     = 0x05,
+
+    /* Protocol switch (u8, see `bin_protocol_mode_t`). Sent by the pilot
+    ** to go back to JSON.
+    */
+    BIN_FRAME_PROTOCOL      = 0x06,
+
+    /* Number (u16) of commands dropped by the Gate since the previous
+    ** one, as its reception ring was full. Sent by the Gate.
+    */
+    BIN_FRAME_OVERFLOW      = 0x07,
+
+} bin_frame_type_t;
+
+// Protocols used on the pilot link.
+typedef enum
+{
+    // Pyluos-compatible JSON, default.
+    BIN_PROTOCOL_JSON       = 0x00,
+
+    // Binary frames.
+    BIN_PROTOCOL_BINARY     = 0x01,
+
+} bin_protocol_mode_t;
+
+// Returns true if binary frames are used on the pilot link.
+bool bin_protocol_is_enabled(void);
+
+// Switches the pilot link protocol to binary frames or back to JSON.
+void bin_protocol_enable(bool enable);
+
+// Encodes a frame of the given type and payload and sends it.
+void bin_protocol_send(bin_frame_type_t type, const uint8_t* payload,
+                       uint16_t size);
+
+/* Appends a record for the given message to the telemetry frame, which
+** is sent first if the record does not fit.
+*/
+void bin_protocol_add_telemetry(const msg_t* msg);
+
+// Sends the telemetry frame if it holds records.
+void bin_protocol_flush_telemetry(void);
+
+// Sends the routing table, in as many frames as needed.
+void bin_protocol_send_routing_table(void);
+
+/* Decodes and applies each frame held by the given buffer, which is
+** decoded in place. Frames with a wrong CRC or length are dropped.
+*/
+void bin_protocol_handle_frames(container_t* container, uint8_t* data,
+                                uint32_t size);
+
+#endif /* ! BIN_PROTOCOL_H */
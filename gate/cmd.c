@@ -1,199 +1,807 @@
 #include "cmd.h"
 #include "convert.h"
 #include <stdio.h>
+#include <string.h>
 #include "gate.h"
+#include "mesh_bench.h"
+#include "stream.h"
+#include "bin_protocol.h"
+#include "json_parser.h"
+#include "app_util_platform.h"
+#include "app_luos_list.h" // LUOS_MESH_BRIDGE
 
 #include "boards.h"
 
-// There is no stack here we use the latest command
-volatile char buf[JSON_BUF_NUM][JSON_BUFF_SIZE] = {0};
-volatile int current_table = 0;
-volatile char cmd_ready = 0;
+// Maximum number of JSON tokens in a command
+#define JSON_MAX_TOKENS 128
+
+// Handler of a command key, given the index of its value
+typedef void (*cmd_handler_t)(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+
+typedef struct
+{
+    const char *key;
+    cmd_handler_t handler;
+} cmd_key_t;
+
+static void cmd_baudrate(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_benchmark(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_containers(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_delta(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_detection(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+#ifdef LUOS_MESH_BRIDGE
+static void cmd_mesh_benchmark(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+#endif /* LUOS_MESH_BRIDGE */
+static void cmd_protocol(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_refresh_period(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_routing_table(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_routing_table_diff(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+static void cmd_stream(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin);
+
+// Command keys, sorted in strcmp order for binary search
+static const cmd_key_t CMD_KEYS[] = {
+    {"baudrate", cmd_baudrate},
+    {"benchmark", cmd_benchmark},
+    {"containers", cmd_containers},
+    {"delta", cmd_delta},
+    {"detection", cmd_detection},
+#ifdef LUOS_MESH_BRIDGE
+    {"mesh_benchmark", cmd_mesh_benchmark},
+#endif /* LUOS_MESH_BRIDGE */
+    {"protocol", cmd_protocol},
+    {"refresh_period", cmd_refresh_period},
+    {"routing_table", cmd_routing_table},
+    {"routing_table_diff", cmd_routing_table_diff},
+    {"stream", cmd_stream},
+};
+#define CMD_NB_KEYS (sizeof(CMD_KEYS) / sizeof(cmd_key_t))
+
+// Tokens of the command being parsed, the parser never allocates
+static json_token_t tokens[JSON_MAX_TOKENS];
+
 volatile char detection_ask = 0;
 
-char *get_json_buf(void)
+// Reception states
+typedef enum
+{
+    RX_COMMAND, // Command, until the '\r' ending its JSON in JSON mode
+    RX_PAYLOAD, // Binary data announced by the JSON of a command, following it
+    RX_DROP,    // Overflowed command, dropped until its end
+} rx_state_t;
+
+// Scan states of the JSON being received, looking for `"key":[size]`
+typedef enum
+{
+    SCAN_NONE,         // Outside of strings, no key pending
+    SCAN_STRING,       // In a string
+    SCAN_STRING_END,   // After a string, a key if followed by ':'
+    SCAN_KEY_END,      // After a key, an announcement if followed by '['
+    SCAN_ARRAY,        // After "key":[, expecting the size
+    SCAN_SIZE,         // In the size digits
+    SCAN_SIZE_END,     // After the size, expecting ']'
+} rx_scan_state_t;
+
+// Received command, contiguous in the ring
+typedef struct
+{
+    uint16_t start;
+    uint16_t size;
+    uint16_t json_size;
+} rx_frame_t;
+
+// Commands are received in a single byte ring, the loop handles them from the frame index.
+// A command never wraps around the ring: the one being received is moved to its beginning.
+// Only the reception writes head and frame_head, only send_cmds writes frame_tail.
+static struct
+{
+    char data[GATE_CMD_RING_SIZE];
+    uint16_t head;
+    // Set once the command being received was moved to the beginning of the ring
+    bool wrapped;
+    rx_state_t state;
+    rx_frame_t current;
+    // Binary data bytes the command being received still announces, stored or dropped
+    uint32_t payload_left;
+    // Light scan of the JSON being received for the binary data it announces, the full parse is left to send_cmds
+    struct
+    {
+        rx_scan_state_t state;
+        bool escape;
+        // Last string and key, from the start of the command
+        uint16_t str_start;
+        uint16_t key_start;
+        uint16_t key_length;
+        uint32_t size;
+        // First announced binary data size, 0 if none
+        uint32_t announced;
+    } scan;
+    rx_frame_t frames[GATE_CMD_MAX_FRAMES];
+    volatile uint32_t frame_head;
+    volatile uint32_t frame_tail;
+    // Dropped commands, and how many of them the pilot knows about
+    volatile uint32_t nb_overflows;
+    uint32_t nb_reported;
+} s_rx = {0};
+
+static bool rx_put(char byte)
+{
+    // Unhandled commands start at the oldest one, send_cmds only frees more space meanwhile
+    uint32_t frame_tail = s_rx.frame_tail;
+    bool empty = (s_rx.frame_head == frame_tail);
+    uint16_t oldest = empty ? GATE_CMD_RING_SIZE : s_rx.frames[frame_tail % GATE_CMD_MAX_FRAMES].start;
+    if (s_rx.wrapped && (empty || (oldest <= s_rx.current.start)))
+    {
+        // Commands left at the end of the ring were handled
+        s_rx.wrapped = false;
+    }
+    if (s_rx.wrapped)
+    {
+        if (s_rx.head >= oldest)
+        {
+            return false;
+        }
+    }
+    else if (s_rx.head >= GATE_CMD_RING_SIZE)
+    {
+        // Move the command being received to the beginning of the ring, before the unhandled ones
+        uint16_t size = s_rx.head - s_rx.current.start;
+        if ((s_rx.current.start == 0) || (size >= oldest))
+        {
+            return false;
+        }
+        memmove(s_rx.data, &s_rx.data[s_rx.current.start], size);
+        s_rx.current.start = 0;
+        s_rx.head = size;
+        s_rx.wrapped = !empty;
+    }
+    s_rx.data[s_rx.head++] = byte;
+    return true;
+}
+
+static void rx_start(void)
+{
+    s_rx.current.start = s_rx.head;
+    s_rx.current.json_size = 0;
+    s_rx.payload_left = 0;
+    memset(&s_rx.scan, 0, sizeof(s_rx.scan));
+    s_rx.state = RX_COMMAND;
+}
+
+static void rx_overflow(void)
 {
-    return (char *)buf[current_table];
+    // Drop the command being received until its end
+    s_rx.head = s_rx.current.start;
+    s_rx.state = RX_DROP;
+    s_rx.nb_overflows++;
 }
-static void next_json(void)
+
+static void rx_commit(void)
 {
-    current_table++;
-    if (current_table >= JSON_BUF_NUM)
+    if ((s_rx.frame_head - s_rx.frame_tail) >= GATE_CMD_MAX_FRAMES)
     {
-        current_table = 0;
+        rx_overflow();
+        rx_start();
+        return;
     }
+    s_rx.current.size = s_rx.head - s_rx.current.start;
+    s_rx.frames[s_rx.frame_head % GATE_CMD_MAX_FRAMES] = s_rx.current;
+    // The frame is complete before send_cmds sees it
+    __DMB();
+    s_rx.frame_head++;
+    rx_start();
 }
 
-bool check_json(uint16_t carac_nbr)
+static void rx_receive_bin(char byte)
 {
-    if ((current_table > (JSON_BUF_NUM - 1)) ||
-        (current_table < 0) ||
-        (carac_nbr > (JSON_BUFF_SIZE - 1)))
+    if (s_rx.state == RX_DROP)
+    {
+        if (byte == BIN_FRAME_DELIMITER)
+        {
+            rx_start();
+        }
+        return;
+    }
+    if (!rx_put(byte))
     {
-        bsp_board_leds_on();
-        while (true);
+        rx_overflow();
     }
-    if (buf[current_table][carac_nbr] == '\r')
+    // Binary frames end with a delimiter, kept for bin_protocol_handle_frames
+    if (byte != BIN_FRAME_DELIMITER)
     {
-        buf[current_table][carac_nbr] = '\0';
-
-        // We have a complete Json here
-        cmd_ready++;
-        next_json();
-        return true;
+        return;
+    }
+    if (s_rx.state == RX_DROP)
+    {
+        rx_start();
     }
     else
     {
-        // It could be a binary
-        return false;
+        rx_commit();
     }
 }
 
-void send_cmds(container_t *container)
+// Returns true if the key found by the scan announces binary data: "data", or a container key accepting it
+static bool rx_scan_key_is_binary(void)
 {
-    msg_t msg;
+    const char *key = &s_rx.data[s_rx.current.start + s_rx.scan.key_start];
+    if ((s_rx.scan.key_length == sizeof("data") - 1) && (memcmp(key, "data", sizeof("data") - 1) == 0))
+    {
+        return true;
+    }
+    return json_key_str_is_binary(key, s_rx.scan.key_length);
+}
 
-    // check if we have a complete received command
-    while (cmd_ready > 0)
+// Scans the given JSON byte, stored at the given position of the command, for an array whose only item is a size
+static void rx_scan(char byte, uint16_t position)
+{
+    if (s_rx.scan.state == SCAN_STRING)
     {
-        int concerned_table = current_table - cmd_ready;
-        if (concerned_table < 0)
+        if (s_rx.scan.escape)
+        {
+            s_rx.scan.escape = false;
+        }
+        else if (byte == '\\')
+        {
+            s_rx.scan.escape = true;
+        }
+        else if (byte == '"')
+        {
+            s_rx.scan.key_length = position - s_rx.scan.str_start;
+            s_rx.scan.state = SCAN_STRING_END;
+        }
+        return;
+    }
+    if (byte == '"')
+    {
+        s_rx.scan.str_start = position + 1;
+        s_rx.scan.state = SCAN_STRING;
+        return;
+    }
+    bool space = (byte == ' ') || (byte == '\t') || (byte == '\n');
+    switch (s_rx.scan.state)
+    {
+    case SCAN_STRING_END:
+        if (byte == ':')
+        {
+            s_rx.scan.key_start = s_rx.scan.str_start;
+            s_rx.scan.state = SCAN_KEY_END;
+            return;
+        }
+        break;
+    case SCAN_KEY_END:
+        if (byte == '[')
+        {
+            s_rx.scan.state = SCAN_ARRAY;
+            return;
+        }
+        break;
+    case SCAN_ARRAY:
+        if ((byte >= '0') && (byte <= '9'))
         {
-            concerned_table = JSON_BUF_NUM + concerned_table;
+            s_rx.scan.size = (uint32_t)(byte - '0');
+            s_rx.scan.state = SCAN_SIZE;
+            return;
         }
-        cJSON *root = cJSON_Parse((char *)buf[concerned_table]);
-        // check json integrity
-        if (root == NULL)
+        break;
+    case SCAN_SIZE:
+        if ((byte >= '0') && (byte <= '9'))
         {
-            // Error
-            cJSON_Delete(root);
-            cmd_ready--;
+            // Larger sizes never fit in the ring anyway
+            s_rx.scan.size = (s_rx.scan.size > UINT16_MAX) ? s_rx.scan.size : s_rx.scan.size * 10 + (uint32_t)(byte - '0');
             return;
         }
-        // check if this is a detection cmd
-        if (cJSON_GetObjectItem(root, "detection") != NULL)
+        if (space)
         {
-            detection_ask++;
+            s_rx.scan.state = SCAN_SIZE_END;
+            return;
         }
-        if (cJSON_GetObjectItem(root, "baudrate") != NULL)
+        // fall through
+    case SCAN_SIZE_END:
+        if (byte == ']')
         {
-            //create a message to setup the new baudrate
-            if (cJSON_IsNumber(cJSON_GetObjectItem(root, "baudrate")))
+            // A command carries a single binary data
+            if ((s_rx.scan.announced == 0) && rx_scan_key_is_binary())
             {
-                uint32_t baudrate = (float)cJSON_GetObjectItem(root, "baudrate")->valueint;
-                Luos_SendBaudrate(container, baudrate);
+                s_rx.scan.announced = s_rx.scan.size;
             }
+            s_rx.scan.state = SCAN_NONE;
+            return;
+        }
+        break;
+    case SCAN_NONE:
+    default:
+        return;
+    }
+    if (!space)
+    {
+        s_rx.scan.state = SCAN_NONE;
+    }
+}
+
+static void rx_receive_json(char byte)
+{
+    bool end = false;
+    switch (s_rx.state)
+    {
+    case RX_COMMAND:
+        if (byte == '\r')
+        {
+            // End of the JSON, followed by the binary data it announces
+            s_rx.current.json_size = s_rx.head - s_rx.current.start;
+            s_rx.payload_left = s_rx.scan.announced;
+            end = (s_rx.payload_left == 0);
+            byte = '\0';
+        }
+        else
+        {
+            rx_scan(byte, s_rx.head - s_rx.current.start);
+        }
+        break;
+    case RX_PAYLOAD:
+        s_rx.payload_left--;
+        end = (s_rx.payload_left == 0);
+        break;
+    case RX_DROP:
+    default:
+        // Dropped until the end of its binary data, or of its JSON if it was not complete
+        if ((s_rx.payload_left > 0) ? (--s_rx.payload_left == 0) : (byte == '\r'))
+        {
+            rx_start();
+        }
+        return;
+    }
+    bool stored = rx_put(byte);
+    if (!stored)
+    {
+        rx_overflow();
+    }
+    if (end)
+    {
+        if (stored)
+        {
+            rx_commit();
+        }
+        else
+        {
+            rx_start();
+        }
+    }
+    else if (stored && (s_rx.payload_left > 0))
+    {
+        s_rx.state = RX_PAYLOAD;
+    }
+}
+
+// Stores received bytes, may be called from interrupts
+void cmd_receive(const uint8_t *data, uint32_t size)
+{
+    bool binary = bin_protocol_is_enabled();
+    for (uint32_t i = 0; i < size; i++)
+    {
+        if (binary)
+        {
+            rx_receive_bin((char)data[i]);
         }
-        if (cJSON_GetObjectItem(root, "benchmark") != NULL)
+        else
         {
-            //manage benchmark
-            if (cJSON_IsObject(cJSON_GetObjectItem(root, "benchmark")))
+            rx_receive_json((char)data[i]);
+        }
+    }
+}
+
+// Returns true if received commands or overflows wait for send_cmds
+bool cmds_pending(void)
+{
+    return (s_rx.frame_head != s_rx.frame_tail) || (s_rx.nb_overflows != s_rx.nb_reported);
+}
+
+// Tells the pilot that commands were dropped
+static void report_overflows(void)
+{
+    uint32_t nb_overflows = s_rx.nb_overflows;
+    if (nb_overflows == s_rx.nb_reported)
+    {
+        return;
+    }
+    uint32_t nb_dropped = nb_overflows - s_rx.nb_reported;
+    s_rx.nb_reported = nb_overflows;
+    if (bin_protocol_is_enabled())
+    {
+        uint8_t payload[2];
+        uint16_t count = (nb_dropped > UINT16_MAX) ? UINT16_MAX : (uint16_t)nb_dropped;
+        payload[0] = (uint8_t)count;
+        payload[1] = (uint8_t)(count >> 8);
+        bin_protocol_send(BIN_FRAME_OVERFLOW, payload, sizeof(payload));
+        return;
+    }
+    char json[32];
+    snprintf(json, sizeof(json), "{\"overflow\":%lu}\n", (unsigned long)nb_dropped);
+    json_send(json);
+}
+
+void send_cmds(container_t *container)
+{
+    report_overflows();
+    // handle every complete received command
+    while (s_rx.frame_tail != s_rx.frame_head)
+    {
+        rx_frame_t frame = s_rx.frames[s_rx.frame_tail % GATE_CMD_MAX_FRAMES];
+        char *cmd_buf = &s_rx.data[frame.start];
+        if (bin_protocol_is_enabled())
+        {
+            bin_protocol_handle_frames(container, (uint8_t *)cmd_buf, frame.size);
+        }
+        else
+        {
+            json_parser_t parser;
+            // Binary data following the JSON and its '\r'
+            cmd_bin_t bin = {
+                .data = cmd_buf + frame.json_size + 1,
+                .size = frame.size - frame.json_size - 1,
+            };
+            // check json integrity, skip invalid commands
+            if (json_parser_parse(&parser, cmd_buf, frame.json_size, tokens, JSON_MAX_TOKENS) &&
+                json_parser_is(&parser, 0, JSON_TOKEN_OBJECT))
             {
-                // Get all parameters
-                cJSON *parameters = cJSON_GetObjectItem(root, "benchmark");
-                uint32_t repetition = 0;
-                if (cJSON_IsNumber(cJSON_GetObjectItem(parameters, "repetitions")))
+                // Dispatch each key of the command to its handler
+                uint16_t key = 1;
+                for (uint16_t i = 0; i < tokens[0].size; i++)
                 {
-                    repetition = (int)cJSON_GetObjectItem(parameters, "repetitions")->valueint;
-                }
-                uint32_t target_id = (int)cJSON_GetObjectItem(parameters, "target")->valueint;
-                cJSON *item = cJSON_GetObjectItem(parameters, "data");
-                uint32_t size = (int)cJSON_GetArrayItem(item, 0)->valueint;
-                if (size > 0)
-                {
-                    // find the first \r of the current buf
-                    char *bin_data = (char *)buf[concerned_table];
-                    int index = 0;
-                    for (index = 0; index < JSON_BUFF_SIZE; index++)
-                    {
-                        if (bin_data[index] == '\r')
-                        {
-                            index++;
-                            break;
-                        }
-                    }
-                    if (index < JSON_BUFF_SIZE - 1)
+                    const cmd_key_t *cmd_key = json_parser_lookup(&parser, key, CMD_KEYS, CMD_NB_KEYS, sizeof(cmd_key_t));
+                    if (cmd_key != NULL)
                     {
-                        // create a message from parameters
-                        msg.header.cmd = REVISION;
-                        msg.header.target_mode = IDACK;
-                        msg.header.target = target_id;
-                        // save current time
-                        uint32_t begin_systick = Luos_GetSystick();
-                        uint32_t failed_msg_nb = 0;
-                        // Before trying to send anything make sure to finish any transmission
-                        while (Luos_TxComplete() == FAILED)
-                            ;
-                        // Wait 10ms allowing receiving messages to finish
-                        uint32_t tickstart = Luos_GetSystick();
-                        while ((Luos_GetSystick() - tickstart) < 10)
-                            ;
-                        // Flush every messages pending
-                        Luos_Flush();
-                        // To get the number of message failed we will use statistics
-                        // We have to reinit the number of dropped message before start
-                        uint8_t drop_back = container->node_statistics->memory.msg_drop_number;
-                        container->node_statistics->memory.msg_drop_number = 0;
-                        uint8_t retry_back = *container->ll_container->ll_stat.max_retry;
-                        *container->ll_container->ll_stat.max_retry = 0;
-                        // send this message multiple time
-                        int i = 0;
-                        for (i = 0; i < repetition; i++)
-                        {
-                            Luos_SendData(container, &msg, &bin_data[index], (unsigned int)size);
-                        }
-                        // Wait transmission end
-                        while (Luos_TxComplete() == FAILED)
-                            ;
-                        // Get the number of failures on transmission
-                        failed_msg_nb = container->node_statistics->memory.msg_drop_number;
-                        // Get the number of retry
-                        // If retry == max retry number consider all messages as lost
-                        if (*container->ll_container->ll_stat.max_retry >= NBR_RETRY)
-                        {
-                            // We failed to transmit this message count all as failed
-                            failed_msg_nb = repetition;
-                        }
-                        container->node_statistics->memory.msg_drop_number = drop_back;
-                        *container->ll_container->ll_stat.max_retry = retry_back;
-                        uint32_t end_systick = Luos_GetSystick();
-                        float data_rate = (float)size * (float)(repetition - failed_msg_nb) / (((float)end_systick - (float)begin_systick) / 1000.0) * 8;
-                        float fail_rate = (float)failed_msg_nb * 100.0 / (float)repetition;
-                        char json[60] = {0};
-                        sprintf(json, "{\"benchmark\":{\"data_rate\":%.2f,\"fail_rate\":%.2f}}\n", data_rate, fail_rate);
-                        json_send(json);
+                        cmd_key->handler(container, &parser, key + 1, &bin);
                     }
+                    key = json_parser_skip(&parser, key + 1);
                 }
             }
         }
-        cJSON *containers = cJSON_GetObjectItem(root, "containers");
-        // Get containers
-        if (cJSON_IsObject(containers))
+        // Release the command space, once handled
+        __DMB();
+        s_rx.frame_tail++;
+    }
+}
+
+static void cmd_baudrate(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    //create a message to setup the new baudrate
+    if (json_parser_is_number(parser, value))
+    {
+        uint32_t baudrate = (uint32_t)json_parser_get_int(parser, value);
+        Luos_SendBaudrate(container, baudrate);
+    }
+}
+
+static void cmd_benchmark(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    msg_t msg;
+
+    //manage benchmark
+    if (json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        // Get all parameters
+        int32_t parameters = value;
+        uint32_t repetition = 0;
+        if (json_parser_is_number(parser, json_parser_find(parser, parameters, "repetitions")))
+        {
+            repetition = json_parser_get_int(parser, json_parser_find(parser, parameters, "repetitions"));
+        }
+        uint32_t target_id = json_parser_get_int(parser, json_parser_find(parser, parameters, "target"));
+#ifdef LUOS_MESH_BRIDGE
+        char *mode = json_parser_get_string(parser, json_parser_find(parser, parameters, "mode"));
+        if ((mode != NULL) && (strcmp(mode, "echo") == 0))
         {
-            // Loop into containers
-            cJSON *container_jsn = containers->child;
-            while (container_jsn != NULL)
+            // Round-trip measurement, meaningful for remote containers
+            mesh_bench_params_t echo_params;
+            memset(&echo_params, 0, sizeof(mesh_bench_params_t));
+            echo_params.targets[0] = target_id;
+            echo_params.nb_targets = 1;
+            echo_params.repetitions = repetition;
+            echo_params.target_mode = json_parser_is_true(parser, json_parser_find(parser, parameters, "ack")) ? IDACK : ID;
+            echo_params.window = 1;
+            if (json_parser_is_number(parser, json_parser_find(parser, parameters, "window")))
+            {
+                echo_params.window = (uint16_t)json_parser_get_int(parser, json_parser_find(parser, parameters, "window"));
+            }
+            if (json_parser_is_number(parser, json_parser_find(parser, parameters, "timeout")))
+            {
+                echo_params.timeout_ms = (uint32_t)json_parser_get_int(parser, json_parser_find(parser, parameters, "timeout"));
+            }
+            if (json_parser_is_number(parser, json_parser_find(parser, parameters, "size")))
             {
-                // Create msg
-                char *alias = container_jsn->string;
-                uint16_t id = RoutingTB_IDFromAlias(alias);
-                if (id == 65535)
+                echo_params.payload_size = (uint8_t)json_parser_get_int(parser, json_parser_find(parser, parameters, "size"));
+            }
+            if (repetition > 0)
+            {
+                mesh_bench_echo(container, &echo_params);
+            }
+        }
+#endif /* LUOS_MESH_BRIDGE */
+        int32_t item = json_parser_find(parser, parameters, "data");
+        uint32_t size = 0;
+        if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+        {
+            size = (uint32_t)json_parser_get_int(parser, json_parser_array_item(parser, item, 0));
+        }
+        if (size > 0)
+        {
+            // the data follows the JSON
+            if (size <= bin->size)
+            {
+                // create a message from parameters
+                msg.header.cmd = REVISION;
+                msg.header.target_mode = IDACK;
+                msg.header.target = target_id;
+                // save current time
+                uint32_t begin_systick = Luos_GetSystick();
+                uint32_t failed_msg_nb = 0;
+                // Before trying to send anything make sure to finish any transmission
+                while (Luos_TxComplete() == FAILED)
+                    ;
+                // Wait 10ms allowing receiving messages to finish
+                uint32_t tickstart = Luos_GetSystick();
+                while ((Luos_GetSystick() - tickstart) < 10)
+                    ;
+                // Flush every messages pending
+                Luos_Flush();
+                // To get the number of message failed we will use statistics
+                // We have to reinit the number of dropped message before start
+                uint8_t drop_back = container->node_statistics->memory.msg_drop_number;
+                container->node_statistics->memory.msg_drop_number = 0;
+                uint8_t retry_back = *container->ll_container->ll_stat.max_retry;
+                *container->ll_container->ll_stat.max_retry = 0;
+                // send this message multiple time
+                int i = 0;
+                for (i = 0; i < repetition; i++)
                 {
-                    // If alias doesn't exist in our list id_from_alias send us back -1 = 65535
-                    // So here there is an error in alias.
-                    cJSON_Delete(root);
-                    cmd_ready--;
-
-                    printf("Container %s does not exist!\n", alias);
-                    return;
+                    Luos_SendData(container, &msg, (void *)bin->data, (unsigned int)size);
                 }
-                luos_type_t type = RoutingTB_TypeFromID(id);
-                json_to_msg(container, id, type, container_jsn, &msg, (char *)buf[concerned_table]);
-                // Get next container
-                container_jsn = container_jsn->next;
+                // Wait transmission end
+                while (Luos_TxComplete() == FAILED)
+                    ;
+                // Get the number of failures on transmission
+                failed_msg_nb = container->node_statistics->memory.msg_drop_number;
+                // Get the number of retry
+                // If retry == max retry number consider all messages as lost
+                if (*container->ll_container->ll_stat.max_retry >= NBR_RETRY)
+                {
+                    // We failed to transmit this message count all as failed
+                    failed_msg_nb = repetition;
+                }
+                container->node_statistics->memory.msg_drop_number = drop_back;
+                *container->ll_container->ll_stat.max_retry = retry_back;
+                uint32_t end_systick = Luos_GetSystick();
+                float data_rate = (float)size * (float)(repetition - failed_msg_nb) / (((float)end_systick - (float)begin_systick) / 1000.0) * 8;
+                float fail_rate = (float)failed_msg_nb * 100.0 / (float)repetition;
+                char json[60] = {0};
+                sprintf(json, "{\"benchmark\":{\"data_rate\":%.2f,\"fail_rate\":%.2f}}\n", data_rate, fail_rate);
+                json_send(json);
+            }
+        }
+    }
+}
+
+static void cmd_containers(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    msg_t msg;
+
+    // Get containers
+    if (json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        // Loop into containers
+        uint16_t container_key = value + 1;
+        for (uint16_t i = 0; i < parser->tokens[value].size; i++)
+        {
+            // Create msg
+            char *alias = json_parser_get_string(parser, container_key);
+            uint16_t id = RoutingTB_IDFromAlias(alias);
+            if (id == 65535)
+            {
+                // If alias doesn't exist in our list id_from_alias send us back -1 = 65535
+                // So here there is an error in alias.
+                printf("Container %s does not exist!\n", alias);
+                return;
             }
+            luos_type_t type = RoutingTB_TypeFromID(id);
+            json_to_msg(container, id, type, parser, container_key + 1, &msg, bin);
+            // Get next container
+            container_key = json_parser_skip(parser, container_key + 1);
+        }
+    }
+}
+
+static void cmd_delta(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    // Only send changed fields, {"delta":false} sends every field again
+    if (json_parser_is_bool(parser, value))
+    {
+        delta_enable(json_parser_is_true(parser, value));
+        return;
+    }
+    if (!json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        return;
+    }
+    int32_t item = json_parser_find(parser, value, "keyframe");
+    if (json_parser_is_number(parser, item) && (json_parser_get_int(parser, item) > 0))
+    {
+        delta_set_keyframe_period((uint32_t)json_parser_get_int(parser, item));
+    }
+    // Deadbands of float fields, by key
+    item = json_parser_find(parser, value, "deadbands");
+    if (json_parser_is(parser, item, JSON_TOKEN_OBJECT))
+    {
+        uint16_t key = item + 1;
+        for (uint16_t i = 0; i < parser->tokens[item].size; i++)
+        {
+            int16_t cmd = json_key_to_msg_cmd(json_parser_get_string(parser, key));
+            if ((cmd >= 0) && json_parser_is_number(parser, key + 1))
+            {
+                delta_set_deadband((uint8_t)cmd, (float)json_parser_get_double(parser, key + 1));
+            }
+            key = json_parser_skip(parser, key + 1);
+        }
+    }
+    delta_enable(true);
+}
+
+static void cmd_detection(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    detection_ask++;
+}
+
+#ifdef LUOS_MESH_BRIDGE
+static void cmd_mesh_benchmark(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    if (!json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        return;
+    }
+    int32_t parameters = value;
+    mesh_bench_sweep_t sweep;
+    memset(&sweep, 0, sizeof(mesh_bench_sweep_t));
+    // Get destinations, only the first ones are used
+    int32_t item = json_parser_find(parser, parameters, "targets");
+    if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+    {
+        uint16_t nb_targets = parser->tokens[item].size;
+        if (nb_targets > MESH_BENCH_MAX_TARGETS)
+        {
+            nb_targets = MESH_BENCH_MAX_TARGETS;
+        }
+        for (uint16_t i = 0; i < nb_targets; i++)
+        {
+            sweep.targets[i] = (uint16_t)json_parser_get_int(parser, json_parser_array_item(parser, item, i));
+        }
+        sweep.nb_targets = nb_targets;
+    }
+    sweep.sweep_targets = json_parser_is_true(parser, json_parser_find(parser, parameters, "sweep_targets"));
+    if (json_parser_is_number(parser, json_parser_find(parser, parameters, "repetitions")))
+    {
+        sweep.repetitions = (uint32_t)json_parser_get_int(parser, json_parser_find(parser, parameters, "repetitions"));
+    }
+    if (json_parser_is_number(parser, json_parser_find(parser, parameters, "timeout")))
+    {
+        sweep.timeout_ms = (uint32_t)json_parser_get_int(parser, json_parser_find(parser, parameters, "timeout"));
+    }
+    // Get target modes, ID by default
+    item = json_parser_find(parser, parameters, "modes");
+    if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+    {
+        for (uint16_t i = 0; (i < parser->tokens[item].size) && (sweep.nb_target_modes < MESH_BENCH_MAX_SWEEP_VALUES); i++)
+        {
+            char *mode = json_parser_get_string(parser, json_parser_array_item(parser, item, i));
+            if (mode != NULL)
+            {
+                sweep.target_modes[sweep.nb_target_modes++] = (strcmp(mode, "IDACK") == 0) ? IDACK : ID;
+            }
+        }
+    }
+    if (sweep.nb_target_modes == 0)
+    {
+        sweep.target_modes[sweep.nb_target_modes++] = ID;
+    }
+    // Get queue depths, one request at a time by default
+    item = json_parser_find(parser, parameters, "windows");
+    if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+    {
+        for (uint16_t i = 0; (i < parser->tokens[item].size) && (sweep.nb_windows < MESH_BENCH_MAX_SWEEP_VALUES); i++)
+        {
+            int32_t window = json_parser_array_item(parser, item, i);
+            if (json_parser_is_number(parser, window))
+            {
+                sweep.windows[sweep.nb_windows++] = (uint16_t)json_parser_get_int(parser, window);
+            }
+        }
+    }
+    if (sweep.nb_windows == 0)
+    {
+        sweep.windows[sweep.nb_windows++] = 1;
+    }
+    // Get echo payload sizes, the smallest one by default
+    item = json_parser_find(parser, parameters, "sizes");
+    if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+    {
+        for (uint16_t i = 0; (i < parser->tokens[item].size) && (sweep.nb_payload_sizes < MESH_BENCH_MAX_SWEEP_VALUES); i++)
+        {
+            int32_t size = json_parser_array_item(parser, item, i);
+            if (json_parser_is_number(parser, size))
+            {
+                sweep.payload_sizes[sweep.nb_payload_sizes++] = (uint8_t)json_parser_get_int(parser, size);
+            }
+        }
+    }
+    if (sweep.nb_payload_sizes == 0)
+    {
+        sweep.payload_sizes[sweep.nb_payload_sizes++] = MESH_BENCH_MIN_PAYLOAD;
+    }
+    if ((sweep.nb_targets > 0) && (sweep.repetitions > 0))
+    {
+        mesh_bench_sweep(container, &sweep);
+    }
+}
+#endif /* LUOS_MESH_BRIDGE */
+
+static void cmd_protocol(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    // check if the pilot switches to binary frames
+    char *protocol = json_parser_get_string(parser, value);
+    if ((protocol != NULL) && (strcmp(protocol, "binary") == 0))
+    {
+        // Acknowledge in JSON, every following exchange is binary
+        char ack_json[] = "{\"protocol\":\"binary\"}\n";
+        json_send(ack_json);
+        bin_protocol_enable(true);
+    }
+}
+
+static void cmd_refresh_period(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    // Refresh period in ms of containers without their own one
+    if (json_parser_is_number(parser, value) && (json_parser_get_int(parser, value) > 0))
+    {
+        collect_set_default_refresh_period((uint32_t)json_parser_get_int(parser, value));
+    }
+}
+
+static void cmd_routing_table(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    // Send the whole routing table, without a new detection
+    Gate_SendRoutingTable(false);
+}
+
+static void cmd_routing_table_diff(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    // Pilots able to apply differences get them after the following detections
+    if (json_parser_is_bool(parser, value))
+    {
+        routing_table_diff_enable(json_parser_is_true(parser, value));
+    }
+}
+
+static void cmd_stream(container_t *container, json_parser_t *parser, uint16_t value, const cmd_bin_t *bin)
+{
+    if (!json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        return;
+    }
+    // A chunk announces its binary data, which follows the JSON
+    int32_t item = json_parser_find(parser, value, "data");
+    if (json_parser_is(parser, item, JSON_TOKEN_ARRAY))
+    {
+        uint32_t seq = (uint32_t)json_parser_get_int(parser, json_parser_find(parser, value, "seq"));
+        int32_t size = (int32_t)json_parser_get_int(parser, json_parser_array_item(parser, item, 0));
+        if ((size < 0) || ((uint32_t)size > bin->size))
+        {
+            size = 0;
         }
-        cJSON_Delete(root);
-        cmd_ready--;
+        stream_chunk(seq, (const uint8_t *)bin->data, (uint32_t)size);
+        return;
     }
+    // Otherwise it opens a stream to a container key accepting binary data
+    char *alias = json_parser_get_string(parser, json_parser_find(parser, value, "container"));
+    uint16_t id = (alias == NULL) ? 65535 : RoutingTB_IDFromAlias(alias);
+    int16_t cmd = (id == 65535) ? -1 : json_key_to_binary_cmd(parser, json_parser_find(parser, value, "key"), RoutingTB_TypeFromID(id));
+    int32_t size = json_parser_find(parser, value, "size");
+    stream_open(container, id, cmd, json_parser_is_number(parser, size) ? (uint32_t)json_parser_get_int(parser, size) : 0);
 }
@@ -1,14 +1,31 @@
 #ifndef CMD_H
 #define CMD_H
 
-#include <json_mnger.h>
+#include "luos.h"
 #include "stdint.h"
 #include <stdbool.h>
 
+// Size of the reception ring, holding many short commands or one long binary trajectory
+#ifndef GATE_CMD_RING_SIZE
+#define GATE_CMD_RING_SIZE 4096
+#endif
+
+// Maximum number of received commands waiting for send_cmds
+#ifndef GATE_CMD_MAX_FRAMES
+#define GATE_CMD_MAX_FRAMES 32
+#endif
+
+// Binary data received after the JSON of a command, e.g. a trajectory
+typedef struct
+{
+    const char *data;
+    uint32_t size;
+} cmd_bin_t;
+
 extern volatile char detection_ask;
 
-char *get_json_buf(void);
-bool check_json(uint16_t carac_nbr);
+void cmd_receive(const uint8_t *data, uint32_t size);
 void send_cmds(container_t *container);
+bool cmds_pending(void);
 
 #endif /* CMD_H */
@@ -1,9 +1,9 @@
 #include "convert.h"
-#include <inttypes.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include "gate.h"
+#include "crc16.h"
 
 #include "app_luos_list.h"      // LUOS_MESH_BRIDGE
 
@@ -11,645 +11,815 @@
 #include "mesh_bridge.h"
 #endif /* LUOS_MESH_BRIDGE */
 
-// Create msg from a container json data
-void json_to_msg(container_t *container, uint16_t id, luos_type_t type, cJSON *jobj, msg_t *msg, char *bin_data)
+// Payload layouts of the converted values
+typedef enum
 {
-    time_luos_t time;
-    float data = 0.0;
-    cJSON *item;
-    msg->header.target_mode = IDACK;
-    msg->header.target = id;
-    //********** global convertion***********
-    // ratio
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "power_ratio")))
+    // No payload: requests
+    LAYOUT_NONE,
+    // Bytes holding a boolean
+    LAYOUT_BOOL,
+    // Bytes
+    LAYOUT_U8,
+    // 32-bit unsigned integers
+    LAYOUT_U32,
+    // Floats
+    LAYOUT_FLOAT,
+    // Alias, at most 15 characters
+    LAYOUT_STRING,
+    // Three bytes rendered as a "major.minor.patch" string
+    LAYOUT_VERSION,
+    // Converted by a dedicated handler
+    LAYOUT_CUSTOM,
+} layout_t;
+
+// Count of values of a layout accepting a number or an array of any length
+#define ANY_COUNT 0
+
+// Container types accepting a key
+typedef enum
+{
+    TYPES_ALL,
+    TYPES_DYNAMIXEL,
+    TYPES_GATE,
+    TYPES_MESH_BRIDGE,
+} types_t;
+
+// Context of the conversion of a container JSON object into messages
+typedef struct
+{
+    container_t *container;
+    json_parser_t *parser;
+    msg_t *msg;
+    const cmd_bin_t *bin;
+} json_to_msg_ctx_t;
+
+// Converts a JSON value into a message, the unit conversion function converts each float
+typedef float (*unit_conversion_t)(float value);
+typedef void (*json_handler_t)(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd);
+
+// Conversion of a JSON key into a message
+typedef struct
+{
+    const char *key;
+    uint8_t cmd;
+    uint8_t layout;
+    uint8_t count;
+    uint8_t types;
+    // An array whose only item is a size announces binary data following the JSON
+    bool binary;
+    unit_conversion_t from_json;
+    json_handler_t handler;
+} json_to_msg_desc_t;
+
+// Conversion of a message into a JSON key, floats are written with the given decimals
+typedef void (*msg_handler_t)(msg_t *msg, json_writer_t *json);
+typedef struct
+{
+    const char *key;
+    uint8_t layout;
+    uint8_t count;
+    uint8_t decimals;
+    msg_handler_t handler;
+} msg_to_json_desc_t;
+
+static void delay_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd);
+static void refresh_period_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd);
+static void register_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd);
+static void luos_statistics_to_json(msg_t *msg, json_writer_t *json);
+static void pedometer_to_json(msg_t *msg, json_writer_t *json);
+#ifdef LUOS_MESH_BRIDGE
+static void subscribe_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd);
+static void mesh_bridge_statistics_to_json(msg_t *msg, json_writer_t *json);
+#endif /* LUOS_MESH_BRIDGE */
+
+// Container keys, sorted in strcmp order for binary search
+static const json_to_msg_desc_t JSON_TO_MSG[] = {
+    // key                    cmd                     layout          count      types              binary conversion                  handler
+    {"color",                 COLOR,                  LAYOUT_U8,      3,         TYPES_ALL,         true,  NULL,                       NULL},
+    {"compliant",             COMPLIANT,              LAYOUT_BOOL,    1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"control",               CONTROL,                LAYOUT_U8,      1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"delay",                 0,                      LAYOUT_CUSTOM,  1,         TYPES_GATE,        false, NULL,                       delay_to_msg},
+    {"dimension",             DIMENSION,              LAYOUT_FLOAT,   1,         TYPES_ALL,         false, LinearOD_PositionFrom_mm,   NULL},
+#ifdef LUOS_MESH_BRIDGE
+    {"ext_rtb",               MESH_BRIDGE_EXT_RTB_CMD, LAYOUT_NONE,   0,         TYPES_MESH_BRIDGE, false, NULL,                       NULL},
+#endif /* LUOS_MESH_BRIDGE */
+    {"io_state",              IO_STATE,               LAYOUT_BOOL,    1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"limit_current",         CURRENT,                LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"limit_power",           RATIO_LIMIT,            LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"limit_rot_position",    ANGULAR_POSITION_LIMIT, LAYOUT_FLOAT,   2,         TYPES_ALL,         false, AngularOD_PositionFrom_deg, NULL},
+    {"limit_rot_speed",       ANGULAR_SPEED_LIMIT,    LAYOUT_FLOAT,   2,         TYPES_ALL,         false, AngularOD_SpeedFrom_deg_s,  NULL},
+    {"limit_trans_position",  LINEAR_POSITION_LIMIT,  LAYOUT_FLOAT,   2,         TYPES_ALL,         false, LinearOD_PositionFrom_mm,   NULL},
+    {"limit_trans_speed",     LINEAR_SPEED_LIMIT,     LAYOUT_FLOAT,   2,         TYPES_ALL,         false, LinearOD_Speedfrom_mm_s,    NULL},
+    {"luos_revision",         LUOS_REVISION,          LAYOUT_NONE,    0,         TYPES_ALL,         false, NULL,                       NULL},
+    {"luos_statistics",       LUOS_STATISTICS,        LAYOUT_NONE,    0,         TYPES_ALL,         false, NULL,                       NULL},
+#ifdef LUOS_MESH_BRIDGE
+    {"mesh_bridge_statistics", MESH_BRIDGE_GET_STATS, LAYOUT_NONE,    0,         TYPES_MESH_BRIDGE, false, NULL,                       NULL},
+#endif /* LUOS_MESH_BRIDGE */
+    {"offset",                OFFSET,                 LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"parameters",            PARAMETERS,             LAYOUT_U32,     ANY_COUNT, TYPES_ALL,         false, NULL,                       NULL},
+    {"pid",                   PID,                    LAYOUT_FLOAT,   3,         TYPES_ALL,         false, NULL,                       NULL},
+    {"power_ratio",           RATIO,                  LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"reduction",             REDUCTION,              LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"refresh_period",        0,                      LAYOUT_CUSTOM,  1,         TYPES_ALL,         false, NULL,                       refresh_period_to_msg},
+    {"register",              REGISTER,               LAYOUT_CUSTOM,  2,         TYPES_DYNAMIXEL,   false, NULL,                       register_to_msg},
+    {"reinit",                REINIT,                 LAYOUT_NONE,    0,         TYPES_ALL,         false, NULL,                       NULL},
+    {"rename",                WRITE_ALIAS,            LAYOUT_STRING,  1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"resolution",            RESOLUTION,             LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"revision",              REVISION,               LAYOUT_NONE,    0,         TYPES_ALL,         false, NULL,                       NULL},
+    {"set_id",                SETID,                  LAYOUT_U8,      1,         TYPES_DYNAMIXEL,   false, NULL,                       NULL},
+#ifdef LUOS_MESH_BRIDGE
+    {"subscribe",             MESH_BRIDGE_SUBSCRIBE,  LAYOUT_CUSTOM,  1,         TYPES_ALL,         false, NULL,                       subscribe_to_msg},
+#endif /* LUOS_MESH_BRIDGE */
+    {"target_rot_position",   ANGULAR_POSITION,       LAYOUT_FLOAT,   1,         TYPES_ALL,         true,  NULL,                       NULL},
+    {"target_rot_speed",      ANGULAR_SPEED,          LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    // todo WATCHOUT binary trajectories could be mm !
+    {"target_trans_position", LINEAR_POSITION,        LAYOUT_FLOAT,   1,         TYPES_ALL,         true,  LinearOD_PositionFrom_mm,   NULL},
+    {"target_trans_speed",    LINEAR_SPEED,           LAYOUT_FLOAT,   1,         TYPES_ALL,         false, LinearOD_Speedfrom_mm_s,    NULL},
+    {"time",                  TIME,                   LAYOUT_FLOAT,   1,         TYPES_ALL,         false, TimeOD_TimeFrom_s,          NULL},
+    {"uuid",                  NODE_UUID,              LAYOUT_NONE,    0,         TYPES_ALL,         false, NULL,                       NULL},
+    {"volt",                  VOLTAGE,                LAYOUT_FLOAT,   1,         TYPES_ALL,         false, NULL,                       NULL},
+    {"wheel_mode",            DXL_WHEELMODE,          LAYOUT_BOOL,    1,         TYPES_DYNAMIXEL,   false, NULL,                       NULL},
+};
+#define JSON_TO_MSG_NB_KEYS (sizeof(JSON_TO_MSG) / sizeof(json_to_msg_desc_t))
+
+#ifdef LUOS_MESH_BRIDGE
+#define MESH_BRIDGE_MSG_TO_JSON_TABLE(X) \
+    X(MESH_BRIDGE_STATS, "mesh_bridge_statistics", LAYOUT_CUSTOM, 1, 0, mesh_bridge_statistics_to_json)
+#else /* ! LUOS_MESH_BRIDGE */
+#define MESH_BRIDGE_MSG_TO_JSON_TABLE(X)
+#endif /* LUOS_MESH_BRIDGE */
+
+// Messages converted to JSON: X(cmd, key, layout, count, decimals, handler)
+#define MSG_TO_JSON_TABLE(X)                                                     \
+    X(LINEAR_POSITION, "trans_position", LAYOUT_FLOAT, 1, 3, NULL)               \
+    X(LINEAR_SPEED, "trans_speed", LAYOUT_FLOAT, 1, 3, NULL)                     \
+    X(ANGULAR_POSITION, "rot_position", LAYOUT_FLOAT, 1, 3, NULL)                \
+    X(ANGULAR_SPEED, "rot_speed", LAYOUT_FLOAT, 1, 3, NULL)                      \
+    X(VOLTAGE, "volt", LAYOUT_FLOAT, 1, 3, NULL)                                 \
+    X(CURRENT, "current", LAYOUT_FLOAT, 1, 3, NULL)                              \
+    X(POWER, "power", LAYOUT_FLOAT, 1, 3, NULL)                                  \
+    X(ILLUMINANCE, "lux", LAYOUT_FLOAT, 1, 3, NULL)                              \
+    X(TEMPERATURE, "temperature", LAYOUT_FLOAT, 1, 3, NULL)                      \
+    X(FORCE, "force", LAYOUT_FLOAT, 1, 3, NULL)                                  \
+    X(MOMENT, "moment", LAYOUT_FLOAT, 1, 3, NULL)                                \
+    X(NODE_UUID, "uuid", LAYOUT_U32, 3, 0, NULL)                                 \
+    X(REVISION, "revision", LAYOUT_VERSION, 1, 0, NULL)                          \
+    X(LUOS_REVISION, "luos_revision", LAYOUT_VERSION, 1, 0, NULL)                \
+    X(LUOS_STATISTICS, "luos_statistics", LAYOUT_CUSTOM, 1, 0, luos_statistics_to_json) \
+    X(IO_STATE, "io_state", LAYOUT_BOOL, 1, 0, NULL)                             \
+    X(EULER_3D, "euler", LAYOUT_FLOAT, 3, 6, NULL)                               \
+    X(COMPASS_3D, "compass", LAYOUT_FLOAT, 3, 6, NULL)                           \
+    X(GYRO_3D, "gyro", LAYOUT_FLOAT, 3, 6, NULL)                                 \
+    X(ACCEL_3D, "accel", LAYOUT_FLOAT, 3, 6, NULL)                               \
+    X(LINEAR_ACCEL, "linear_accel", LAYOUT_FLOAT, 3, 6, NULL)                    \
+    X(GRAVITY_VECTOR, "gravity_vector", LAYOUT_FLOAT, 3, 6, NULL)                \
+    X(QUATERNION, "quaternion", LAYOUT_FLOAT, 4, 6, NULL)                        \
+    X(ROT_MAT, "rotational_matrix", LAYOUT_FLOAT, 9, 6, NULL)                    \
+    X(HEADING, "heading", LAYOUT_FLOAT, 1, 6, NULL)                              \
+    X(PEDOMETER, "pedometer", LAYOUT_CUSTOM, 1, 0, pedometer_to_json)            \
+    MESH_BRIDGE_MSG_TO_JSON_TABLE(X)
+
+// Index of each message conversion
+enum
+{
+#define X(cmd, key, layout, count, decimals, handler) MSG_TO_JSON_##cmd,
+    MSG_TO_JSON_TABLE(X)
+#undef X
+    MSG_TO_JSON_NB
+};
+
+static const msg_to_json_desc_t MSG_TO_JSON[] = {
+#define X(cmd, key, layout, count, decimals, handler) {key, layout, count, decimals, handler},
+    MSG_TO_JSON_TABLE(X)
+#undef X
+};
+
+// Conversion of each command, shifted by one so that 0 means none
+static const uint8_t MSG_TO_JSON_INDEX[UINT8_MAX + 1] = {
+#define X(cmd, key, layout, count, decimals, handler) [cmd] = MSG_TO_JSON_##cmd + 1,
+    MSG_TO_JSON_TABLE(X)
+#undef X
+};
+
+_Static_assert(MSG_TO_JSON_NB < UINT8_MAX, "Message conversion index shall fit on one byte!");
+
+// Returns true if the given container type accepts keys of the given types
+static bool types_match(uint8_t types, luos_type_t type)
+{
+    switch (types)
     {
-        ratio_t ratio = (ratio_t)cJSON_GetObjectItem(jobj, "power_ratio")->valuedouble;
-        RatioOD_RatioToMsg(&ratio, msg);
-        Luos_SendMsg(container, msg);
+    case TYPES_DYNAMIXEL:
+        return (type == VOID_MOD) || (type == DYNAMIXEL_MOD);
+    case TYPES_GATE:
+        return type == GATE_MOD;
+#ifdef LUOS_MESH_BRIDGE
+    case TYPES_MESH_BRIDGE:
+        return type == MESH_BRIDGE_MOD;
+#endif /* LUOS_MESH_BRIDGE */
+    case TYPES_ALL:
+        return true;
+    default:
+        return false;
     }
-    // target angular position
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "target_rot_position")))
+}
+
+// Returns the size in bytes of one value of the given layout
+static uint16_t layout_size(uint8_t layout)
+{
+    switch (layout)
+    {
+    case LAYOUT_BOOL:
+    case LAYOUT_U8:
+        return sizeof(uint8_t);
+    case LAYOUT_U32:
+    case LAYOUT_FLOAT:
+        return sizeof(uint32_t);
+    case LAYOUT_VERSION:
+        return sizeof(revision_t);
+    default:
+        return 0;
+    }
+}
+
+// Sends the binary data following the JSON, whose size is the first item of the given array
+static void send_binary(json_to_msg_ctx_t *ctx, uint8_t cmd, int32_t array)
+{
+    int size = json_parser_get_int(ctx->parser, json_parser_array_item(ctx->parser, array, 0));
+    // the data follows the JSON
+    if ((size > 0) && ((uint32_t)size <= ctx->bin->size))
     {
-        angular_position_t angular_position = (angular_position_t)cJSON_GetObjectItem(jobj, "target_rot_position")->valuedouble;
-        AngularOD_PositionToMsg(&angular_position, msg);
-        Luos_SendMsg(container, msg);
+        ctx->msg->header.cmd = cmd;
+        Luos_SendData(ctx->container, ctx->msg, (void *)ctx->bin->data, (unsigned int)size);
     }
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "target_rot_position")))
+}
+
+// Converts a JSON value into a message following its descriptor
+static void value_to_msg(json_to_msg_ctx_t *ctx, const json_to_msg_desc_t *desc, int32_t value)
+{
+    json_parser_t *parser = ctx->parser;
+    msg_t *msg = ctx->msg;
+
+    switch (desc->layout)
     {
-        int i = 0;
-        // this is a trajectory
-        item = cJSON_GetObjectItem(jobj, "target_rot_position");
-        int size = (int)cJSON_GetArrayItem(item, 0)->valueint;
-        // find the first \r of the current buf
-        for (i = 0; i < JSON_BUFF_SIZE; i++)
-        {
-            if (bin_data[i] == '\r')
-            {
-                i++;
-                break;
-            }
-        }
-        if (i < JSON_BUFF_SIZE - 1)
+    case LAYOUT_CUSTOM:
+        desc->handler(ctx, value, desc->cmd);
+        return;
+    case LAYOUT_NONE:
+        msg->header.size = 0;
+        break;
+    case LAYOUT_STRING:
+    {
+        // In this case we need to send the message as system message
+        char *alias = json_parser_get_string(parser, value);
+        if (alias == NULL)
         {
-            msg->header.cmd = ANGULAR_POSITION;
-            Luos_SendData(container, msg, &bin_data[i], (unsigned int)size);
+            return;
         }
+        // Change size to fit into 16 characters
+        msg->header.size = strnlen(alias, 15);
+        memcpy(msg->data, alias, msg->header.size);
+        msg->data[msg->header.size] = '\0';
+        break;
     }
-    // Limit angular position
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "limit_rot_position")))
-    {
-        angular_position_t limits[2];
-        item = cJSON_GetObjectItem(jobj, "limit_rot_position");
-        limits[0] = AngularOD_PositionFrom_deg(cJSON_GetArrayItem(item, 0)->valuedouble);
-        limits[1] = AngularOD_PositionFrom_deg(cJSON_GetArrayItem(item, 1)->valuedouble);
-        memcpy(&msg->data[0], limits, 2 * sizeof(float));
-        msg->header.cmd = ANGULAR_POSITION_LIMIT;
-        msg->header.size = 2 * sizeof(float);
-        Luos_SendMsg(container, msg);
-    }
-    // Limit linear position
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "limit_trans_position")))
-    {
-        linear_position_t limits[2];
-        item = cJSON_GetObjectItem(jobj, "limit_trans_position");
-        limits[0] = LinearOD_PositionFrom_mm((float)cJSON_GetArrayItem(item, 0)->valuedouble);
-        limits[1] = LinearOD_PositionFrom_mm((float)cJSON_GetArrayItem(item, 1)->valuedouble);
-        memcpy(&msg->data[0], limits, 2 * sizeof(linear_position_t));
-        msg->header.cmd = LINEAR_POSITION_LIMIT;
-        msg->header.size = 2 * sizeof(linear_position_t);
-        Luos_SendMsg(container, msg);
-    }
-    // Limit angular speed
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "limit_rot_speed")))
-    {
-        angular_speed_t limits[2];
-        item = cJSON_GetObjectItem(jobj, "limit_rot_speed");
-        limits[0] = AngularOD_SpeedFrom_deg_s(cJSON_GetArrayItem(item, 0)->valuedouble);
-        limits[1] = AngularOD_SpeedFrom_deg_s(cJSON_GetArrayItem(item, 1)->valuedouble);
-        memcpy(&msg->data[0], limits, 2 * sizeof(float));
-        msg->header.cmd = ANGULAR_SPEED_LIMIT;
-        msg->header.size = 2 * sizeof(float);
-        Luos_SendMsg(container, msg);
-    }
-    // Limit linear speed
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "limit_trans_speed")))
-    {
-        linear_speed_t limits[2];
-        item = cJSON_GetObjectItem(jobj, "limit_trans_speed");
-        limits[0] = LinearOD_Speedfrom_mm_s((float)cJSON_GetArrayItem(item, 0)->valuedouble);
-        limits[1] = LinearOD_Speedfrom_mm_s((float)cJSON_GetArrayItem(item, 1)->valuedouble);
-        memcpy(&msg->data[0], limits, 2 * sizeof(linear_speed_t));
-        msg->header.cmd = LINEAR_SPEED_LIMIT;
-        msg->header.size = 2 * sizeof(linear_speed_t);
-        Luos_SendMsg(container, msg);
-    }
-    // Limit ratio
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "limit_power")))
-    {
-        data = (float)cJSON_GetObjectItem(jobj, "limit_power")->valuedouble;
-        memcpy(msg->data, &data, sizeof(data));
-        msg->header.cmd = RATIO_LIMIT;
-        msg->header.size = sizeof(float);
-        Luos_SendMsg(container, msg);
-    }
-    // Limit current
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "limit_current")))
-    {
-        current_t current = (current_t)cJSON_GetObjectItem(jobj, "limit_current")->valuedouble;
-        ElectricOD_CurrentToMsg(&current, msg);
-        Luos_SendMsg(container, msg);
-    }
-    // target Rotation speed
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "target_rot_speed")))
-    {
-        // this should be a function because it is frequently used
-        angular_speed_t angular_speed = (angular_speed_t)cJSON_GetObjectItem(jobj, "target_rot_speed")->valuedouble;
-        AngularOD_SpeedToMsg(&angular_speed, msg);
-        Luos_SendMsg(container, msg);
-    }
-    // target linear position
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "target_trans_position")))
-    {
-        linear_position_t linear_position = LinearOD_PositionFrom_mm((float)cJSON_GetObjectItem(jobj, "target_trans_position")->valuedouble);
-        LinearOD_PositionToMsg(&linear_position, msg);
-        Luos_SendMsg(container, msg);
-    }
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "target_trans_position")))
-    {
-        int i = 0;
-        // this is a trajectory
-        item = cJSON_GetObjectItem(jobj, "target_trans_position");
-        int size = (int)cJSON_GetArrayItem(item, 0)->valueint;
-        // find the first \r of the current buf
-        for (i = 0; i < JSON_BUFF_SIZE; i++)
+    default:
+    {
+        // Values are either a single number or boolean, or an array of them
+        bool is_array = json_parser_is(parser, value, JSON_TOKEN_ARRAY);
+        uint16_t nb_values = is_array ? parser->tokens[value].size : 1;
+        bool expected = (desc->count == ANY_COUNT) ? (nb_values > 0) : ((nb_values == desc->count) && (is_array == (desc->count > 1)));
+        if (!expected)
         {
-            if (bin_data[i] == '\r')
+            if (desc->binary && is_array)
             {
-                i++;
-                break;
+                send_binary(ctx, desc->cmd, value);
             }
+            return;
         }
-        if (i < JSON_BUFF_SIZE - 1)
+        uint16_t size = layout_size(desc->layout);
+        if (nb_values * size > MAX_DATA_MSG_SIZE)
         {
-            msg->header.cmd = LINEAR_POSITION;
-            // todo WATCHOUT this could be mm !
-            Luos_SendData(container, msg, &bin_data[i], (unsigned int)size);
+            nb_values = MAX_DATA_MSG_SIZE / size;
         }
-    }
-    // target Linear speed
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "target_trans_speed")))
-    {
-        linear_speed_t linear_speed = LinearOD_Speedfrom_mm_s((float)cJSON_GetObjectItem(jobj, "target_trans_speed")->valuedouble);
-        LinearOD_SpeedToMsg(&linear_speed, msg);
-        Luos_SendMsg(container, msg);
-    }
-    // time
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "time")))
-    {
-        // this should be a function because it is frequently used
-        time = TimeOD_TimeFrom_s((float)cJSON_GetObjectItem(jobj, "time")->valuedouble);
-        TimeOD_TimeToMsg(&time, msg);
-        Luos_SendMsg(container, msg);
-    }
-    // Compliance
-    if (cJSON_IsBool(cJSON_GetObjectItem(jobj, "compliant")))
-    {
-        msg->data[0] = cJSON_IsTrue(cJSON_GetObjectItem(jobj, "compliant"));
-        msg->header.cmd = COMPLIANT;
-        msg->header.size = sizeof(char);
-        Luos_SendMsg(container, msg);
-    }
-    // Pid
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "pid")))
-    {
-        float pid[3];
-        item = cJSON_GetObjectItem(jobj, "pid");
-        pid[0] = (float)cJSON_GetArrayItem(item, 0)->valuedouble;
-        pid[1] = (float)cJSON_GetArrayItem(item, 1)->valuedouble;
-        pid[2] = (float)cJSON_GetArrayItem(item, 2)->valuedouble;
-        memcpy(&msg->data[0], pid, sizeof(asserv_pid_t));
-        msg->header.cmd = PID;
-        msg->header.size = sizeof(asserv_pid_t);
-        Luos_SendMsg(container, msg);
-    }
-    // resolution
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "resolution")))
-    {
-        // this should be a function because it is frequently used
-        data = (float)cJSON_GetObjectItem(jobj, "resolution")->valuedouble;
-        memcpy(msg->data, &data, sizeof(data));
-        msg->header.cmd = RESOLUTION;
-        msg->header.size = sizeof(data);
-        Luos_SendMsg(container, msg);
-    }
-    //offset
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "offset")))
-    {
-        // this should be a function because it is frequently used
-        data = (float)cJSON_GetObjectItem(jobj, "offset")->valuedouble;
-        memcpy(msg->data, &data, sizeof(data));
-        msg->header.cmd = OFFSET;
-        msg->header.size = sizeof(data);
-        Luos_SendMsg(container, msg);
-    }
-    // reduction ratio
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "reduction")))
-    {
-        // this should be a function because it is frequently used
-        data = (float)cJSON_GetObjectItem(jobj, "reduction")->valuedouble;
-        memcpy(msg->data, &data, sizeof(data));
-        msg->header.cmd = REDUCTION;
-        msg->header.size = sizeof(data);
-        Luos_SendMsg(container, msg);
-    }
-    // dimension (m)
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "dimension")))
-    {
-        linear_position_t linear_position = LinearOD_PositionFrom_mm((float)cJSON_GetObjectItem(jobj, "dimension")->valuedouble);
-        LinearOD_PositionToMsg(&linear_position, msg);
-        // redefine a specific message type.
-        msg->header.cmd = DIMENSION;
-        Luos_SendMsg(container, msg);
-    }
-    // voltage
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "volt")))
-    {
-        // this should be a function because it is frequently used
-        voltage_t volt = (voltage_t)cJSON_GetObjectItem(jobj, "volt")->valuedouble;
-        ElectricOD_VoltageToMsg(&volt, msg);
-        Luos_SendMsg(container, msg);
-    }
-    // reinit
-    if (cJSON_GetObjectItem(jobj, "reinit"))
-    {
-        msg->header.cmd = REINIT;
-        msg->header.size = 0;
-        Luos_SendMsg(container, msg);
-    }
-    // control (play, pause, stop, rec)
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "control")))
-    {
-        msg->data[0] = cJSON_GetObjectItem(jobj, "control")->valueint;
-        msg->header.cmd = CONTROL;
-        msg->header.size = sizeof(control_mode_t);
-        Luos_SendMsg(container, msg);
-    }
-    // Color
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "color")))
-    {
-        item = cJSON_GetObjectItem(jobj, "color");
-        int size = cJSON_GetArraySize(item);
-        if (size == 3)
+        int32_t item = is_array ? value + 1 : value;
+        for (uint16_t i = 0; i < nb_values; i++)
         {
-            color_t color;
-            for (int i = 0; i < 3; i++)
+            bool valid = (desc->layout == LAYOUT_BOOL) ? json_parser_is_bool(parser, item) : json_parser_is_number(parser, item);
+            if (!valid)
             {
-                color.unmap[i] = (char)cJSON_GetArrayItem(item, i)->valueint;
+                return;
             }
-            IlluminanceOD_ColorToMsg(&color, msg);
-            Luos_SendMsg(container, msg);
-        }
-        else
-        {
-            int i = 0;
-            // This is a binary
-            size = (int)cJSON_GetArrayItem(item, 0)->valueint;
-            // find the first \r of the current buf
-            for (i = 0; i < JSON_BUFF_SIZE; i++)
+            uint8_t *dst = &msg->data[i * size];
+            if (desc->layout == LAYOUT_BOOL)
             {
-                if (bin_data[i] == '\r')
-                {
-                    i++;
-                    break;
-                }
+                *dst = json_parser_is_true(parser, item);
+            }
+            else if (desc->layout == LAYOUT_U8)
+            {
+                *dst = (uint8_t)json_parser_get_int(parser, item);
+            }
+            else if (desc->layout == LAYOUT_U32)
+            {
+                uint32_t val = (uint32_t)json_parser_get_double(parser, item);
+                memcpy(dst, &val, sizeof(uint32_t));
             }
-            if (i < JSON_BUFF_SIZE - 1)
+            else
             {
-                msg->header.cmd = COLOR;
-                Luos_SendData(container, msg, &bin_data[i], (unsigned int)size);
+                float val = (float)json_parser_get_double(parser, item);
+                if (desc->from_json != NULL)
+                {
+                    val = desc->from_json(val);
+                }
+                memcpy(dst, &val, sizeof(float));
             }
+            item = json_parser_skip(parser, item);
         }
+        msg->header.size = nb_values * size;
+        break;
     }
-    // IO_STATE
-    if (cJSON_IsBool(cJSON_GetObjectItem(jobj, "io_state")))
-    {
-        msg->data[0] = cJSON_IsTrue(cJSON_GetObjectItem(jobj, "io_state"));
-        msg->header.cmd = IO_STATE;
-        msg->header.size = sizeof(char);
-        Luos_SendMsg(container, msg);
     }
-    // UUID
-    if (cJSON_GetObjectItem(jobj, "uuid"))
+    msg->header.cmd = desc->cmd;
+    Luos_SendMsg(ctx->container, msg);
+}
+
+// Returns the command of the given container key if it accepts binary data, or -1
+int16_t json_key_to_binary_cmd(json_parser_t *parser, int32_t key, luos_type_t type)
+{
+    if (!json_parser_is(parser, key, JSON_TOKEN_STRING))
     {
-        msg->header.cmd = NODE_UUID;
-        msg->header.size = 0;
-        Luos_SendMsg(container, msg);
+        return -1;
     }
-    // RENAMING
-    if (cJSON_IsString(cJSON_GetObjectItem(jobj, "rename")))
+    const json_to_msg_desc_t *desc = json_parser_lookup(parser, key, JSON_TO_MSG, JSON_TO_MSG_NB_KEYS, sizeof(json_to_msg_desc_t));
+    if ((desc == NULL) || !desc->binary || (desc->layout == LAYOUT_CUSTOM) || !types_match(desc->types, type))
     {
-        // In this case we need to send the message as system message
-        int i = 0;
-        char *alias = cJSON_GetStringValue(cJSON_GetObjectItem(jobj, "rename"));
-        msg->header.size = strlen(alias);
-        // Change size to fit into 16 characters
-        if (msg->header.size > 15)
-        {
-            msg->header.size = 15;
-        }
-        // Clean the '\0' even if we short the alias
-        alias[msg->header.size] = '\0';
-        // Copy the alias into the data field of the message
-        for (i = 0; i < msg->header.size; i++)
-        {
-            msg->data[i] = alias[i];
-        }
-        msg->data[msg->header.size] = '\0';
-        msg->header.cmd = WRITE_ALIAS;
-        Luos_SendMsg(container, msg);
+        return -1;
     }
-    // FIRMWARE REVISION
-    if (cJSON_GetObjectItem(jobj, "revision"))
+    return desc->cmd;
+}
+
+// Returns true if the given container key accepts binary data, whatever the container type
+bool json_key_is_binary(json_parser_t *parser, int32_t key)
+{
+    if (!json_parser_is(parser, key, JSON_TOKEN_STRING))
     {
-        msg->header.cmd = REVISION;
-        msg->header.size = 0;
-        Luos_SendMsg(container, msg);
+        return false;
     }
-    // Luos REVISION
-    if (cJSON_GetObjectItem(jobj, "luos_revision"))
+    const json_token_t *token = &parser->tokens[key];
+    return json_key_str_is_binary(&parser->js[token->start], token->end - token->start);
+}
+
+// Same as json_key_is_binary, for a key string which is not parsed yet
+bool json_key_str_is_binary(const char *key, uint16_t length)
+{
+    const json_to_msg_desc_t *desc = json_parser_lookup_str(key, length, JSON_TO_MSG, JSON_TO_MSG_NB_KEYS, sizeof(json_to_msg_desc_t));
+    return (desc != NULL) && desc->binary && (desc->layout != LAYOUT_CUSTOM);
+}
+
+// Create msg from a container json data
+void json_to_msg(container_t *container, uint16_t id, luos_type_t type, json_parser_t *parser, uint16_t object, msg_t *msg, const cmd_bin_t *bin)
+{
+    json_to_msg_ctx_t ctx = {
+        .container = container,
+        .parser = parser,
+        .msg = msg,
+        .bin = bin,
+    };
+    msg->header.target_mode = IDACK;
+    msg->header.target = id;
+    if (!json_parser_is(parser, object, JSON_TOKEN_OBJECT))
     {
-        msg->header.cmd = LUOS_REVISION;
-        msg->header.size = 0;
-        Luos_SendMsg(container, msg);
+        return;
     }
-    // Luos STAT
-    if (cJSON_GetObjectItem(jobj, "luos_statistics"))
+    // Convert each key of the container following its descriptor
+    uint16_t key = object + 1;
+    for (uint16_t i = 0; i < parser->tokens[object].size; i++)
     {
-        msg->header.cmd = LUOS_STATISTICS;
-        msg->header.size = 0;
-        Luos_SendMsg(container, msg);
+        const json_to_msg_desc_t *desc = json_parser_lookup(parser, key, JSON_TO_MSG, JSON_TO_MSG_NB_KEYS, sizeof(json_to_msg_desc_t));
+        if ((desc != NULL) && types_match(desc->types, type))
+        {
+            value_to_msg(&ctx, desc, key + 1);
+        }
+        key = json_parser_skip(parser, key + 1);
     }
-    // Parameters
-    if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "parameters")))
+}
+
+static void delay_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd)
+{
+    if (json_parser_is_number(ctx->parser, value))
     {
-        uint32_t val = cJSON_GetObjectItem(jobj, "parameters")->valueint;
-        memcpy(msg->data, &val, sizeof(uint32_t));
-        msg->header.size = 4;
-        msg->header.cmd = PARAMETERS;
-        Luos_SendMsg(container, msg);
+        set_delay(json_parser_get_int(ctx->parser, value));
     }
-    if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "parameters")))
+}
+
+// Refresh period of the container in ms, kept by the Gate, 0 for the default one
+static void refresh_period_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd)
+{
+    if (json_parser_is_number(ctx->parser, value))
     {
-        item = cJSON_GetObjectItem(jobj, "parameters");
-        int size = cJSON_GetArraySize(item);
-        // find the first \r of the current buf
-        for (int i = 0; i < size; i++)
-        {
-            uint32_t val = (uint32_t)cJSON_GetArrayItem(item, i)->valuedouble;
-            memcpy(&msg->data[i * sizeof(uint32_t)], &val, sizeof(uint32_t));
-        }
-        msg->header.cmd = PARAMETERS;
-        msg->header.size = size * sizeof(uint32_t);
-        Luos_SendMsg(container, msg);
+        int32_t period_ms = json_parser_get_int(ctx->parser, value);
+        collect_set_refresh_period(ctx->msg->header.target, (period_ms > 0) ? (uint32_t)period_ms : 0);
     }
-    switch (type)
+}
+
+// Register address and value, sent on as few bytes as possible
+static void register_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd)
+{
+    if (json_parser_is(ctx->parser, value, JSON_TOKEN_ARRAY))
     {
-    case VOID_MOD:
-    case DYNAMIXEL_MOD:
-        if (cJSON_IsArray(cJSON_GetObjectItem(jobj, "register")))
+        int val = json_parser_get_int(ctx->parser, json_parser_array_item(ctx->parser, value, 0));
+        memcpy(&ctx->msg->data[0], &val, sizeof(uint16_t));
+        val = json_parser_get_int(ctx->parser, json_parser_array_item(ctx->parser, value, 1));
+        if (val <= 0xFF)
         {
-            item = cJSON_GetObjectItem(jobj, "register");
-            int val = (int)cJSON_GetArrayItem(item, 0)->valueint;
-            memcpy(&msg->data[0], &val, sizeof(uint16_t));
-            val = (int)cJSON_GetArrayItem(item, 1)->valueint;
-            if (val <= 0xFF)
-            {
-                memcpy(&msg->data[2], &val, sizeof(uint8_t));
-                msg->header.size = sizeof(uint16_t) + sizeof(uint8_t);
-            }
-            else if (val <= 0xFFFF)
-            {
-                memcpy(&msg->data[2], &val, sizeof(uint16_t));
-                msg->header.size = sizeof(uint16_t) + sizeof(uint16_t);
-            }
-            else
-            {
-                memcpy(&msg->data[2], &val, sizeof(uint32_t));
-                msg->header.size = sizeof(uint16_t) + sizeof(uint32_t);
-            }
-            msg->header.cmd = REGISTER;
-            Luos_SendMsg(container, msg);
+            memcpy(&ctx->msg->data[2], &val, sizeof(uint8_t));
+            ctx->msg->header.size = sizeof(uint16_t) + sizeof(uint8_t);
         }
-        if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "set_id")))
+        else if (val <= 0xFFFF)
         {
-            msg->data[0] = (char)(cJSON_GetObjectItem(jobj, "set_id")->valueint);
-            msg->header.cmd = SETID;
-            msg->header.size = sizeof(char);
-            Luos_SendMsg(container, msg);
+            memcpy(&ctx->msg->data[2], &val, sizeof(uint16_t));
+            ctx->msg->header.size = sizeof(uint16_t) + sizeof(uint16_t);
         }
-        if (cJSON_IsBool(cJSON_GetObjectItem(jobj, "wheel_mode")))
-        {
-            msg->data[0] = cJSON_IsTrue(cJSON_GetObjectItem(jobj, "wheel_mode"));
-            msg->header.cmd = DXL_WHEELMODE;
-            msg->header.size = sizeof(char);
-            Luos_SendMsg(container, msg);
-        }
-        break;
-        break;
-    case GATE_MOD:
-        if (cJSON_IsNumber(cJSON_GetObjectItem(jobj, "delay")))
+        else
         {
-            set_delay(cJSON_GetObjectItem(jobj, "delay")->valueint);
+            memcpy(&ctx->msg->data[2], &val, sizeof(uint32_t));
+            ctx->msg->header.size = sizeof(uint16_t) + sizeof(uint32_t);
         }
-        break;
+        ctx->msg->header.cmd = cmd;
+        Luos_SendMsg(ctx->container, ctx->msg);
+    }
+}
 
-    #ifdef LUOS_MESH_BRIDGE
-    case MESH_BRIDGE_MOD:
-        if (cJSON_GetObjectItem(jobj, "ext_rtb"))
-        {
-            msg->header.cmd = MESH_BRIDGE_EXT_RTB_CMD;
+#ifdef LUOS_MESH_BRIDGE
+// Subscription period in ms, or object with "period" and "deadband", applied by the Mesh Bridge of a remote container
+static void subscribe_to_msg(json_to_msg_ctx_t *ctx, int32_t value, uint8_t cmd)
+{
+    json_parser_t *parser = ctx->parser;
+    mesh_bridge_subscription_t subscription = {0};
+    int32_t period = value;
+    if (json_parser_is(parser, value, JSON_TOKEN_OBJECT))
+    {
+        period = json_parser_find(parser, value, "period");
+        subscription.deadband = (float)json_parser_get_double(parser, json_parser_find(parser, value, "deadband"));
+    }
+    if (!json_parser_is_number(parser, period))
+    {
+        return;
+    }
+    int32_t period_ms = json_parser_get_int(parser, period);
+    subscription.period_ms = (period_ms <= 0) ? 0 : (period_ms > UINT16_MAX) ? UINT16_MAX : (uint16_t)period_ms;
+    // Kept to be renewed until the next detection
+    collect_set_subscription(ctx->msg->header.target, subscription.period_ms, subscription.deadband);
+    memcpy(ctx->msg->data, &subscription, sizeof(mesh_bridge_subscription_t));
+    ctx->msg->header.size = sizeof(mesh_bridge_subscription_t);
+    ctx->msg->header.cmd = cmd;
+    Luos_SendMsg(ctx->container, ctx->msg);
+}
+#endif /* LUOS_MESH_BRIDGE */
 
-            Luos_SendMsg(container, msg);
+// Returns the command of the message converted into the given key, or -1
+int16_t json_key_to_msg_cmd(const char *key)
+{
+    if (key == NULL)
+    {
+        return -1;
+    }
+    for (uint16_t cmd = 0; cmd <= UINT8_MAX; cmd++)
+    {
+        uint8_t index = MSG_TO_JSON_INDEX[cmd];
+        if ((index != 0) && (strcmp(MSG_TO_JSON[index - 1].key, key) == 0))
+        {
+            return (int16_t)cmd;
         }
-        break;
-    #endif /* LUOS_MESH_BRIDGE */
-
-    default:
-        break;
     }
+    return -1;
 }
 
 // Create Json from a container msg
-void msg_to_json(msg_t *msg, char *json)
-{
-    switch (msg->header.cmd)
-    {
-    case LINEAR_POSITION:
-    case LINEAR_SPEED:
-    case ANGULAR_POSITION:
-    case ANGULAR_SPEED:
-    case VOLTAGE:
-    case CURRENT:
-    case POWER:
-    case ILLUMINANCE:
-    case TEMPERATURE:
-    case FORCE:
-    case MOMENT:
-        // check size
-        if (msg->header.size == sizeof(float))
+void msg_to_json(msg_t *msg, json_writer_t *json)
+{
+    uint8_t index = MSG_TO_JSON_INDEX[(uint8_t)msg->header.cmd];
+    if (index == 0)
+    {
+        // Not converted
+        return;
+    }
+    const msg_to_json_desc_t *desc = &MSG_TO_JSON[index - 1];
+    if (desc->layout == LAYOUT_CUSTOM)
+    {
+        desc->handler(msg, json);
+        return;
+    }
+    // check size
+    uint16_t size = layout_size(desc->layout);
+    if ((desc->layout == LAYOUT_VERSION) ? ((msg->header.size < size) || (msg->header.size >= MAX_DATA_MSG_SIZE)) : (msg->header.size != desc->count * size))
+    {
+        return;
+    }
+    //create the Json content
+    json_writer_printf(json, "\"%s\":", desc->key);
+    if (desc->count > 1)
+    {
+        json_writer_append(json, "[");
+    }
+    for (uint16_t i = 0; i < desc->count; i++)
+    {
+        const uint8_t *src = &msg->data[i * size];
+        switch (desc->layout)
         {
-            // Size ok, now fill the struct from msg data
-            float data;
-            memcpy(&data, msg->data, msg->header.size);
-            char name[20] = {0};
-            switch (msg->header.cmd)
-            {
-            case LINEAR_POSITION:
-                strcpy(name, "trans_position");
-                break;
-            case LINEAR_SPEED:
-                strcpy(name, "trans_speed");
-                break;
-            case ANGULAR_POSITION:
-                strcpy(name, "rot_position");
-                break;
-            case ANGULAR_SPEED:
-                strcpy(name, "rot_speed");
-                break;
-            case CURRENT:
-                strcpy(name, "current");
-                break;
-            case ILLUMINANCE:
-                strcpy(name, "lux");
-                break;
-            case TEMPERATURE:
-                strcpy(name, "temperature");
-                break;
-            case FORCE:
-                strcpy(name, "force");
-                break;
-            case MOMENT:
-                strcpy(name, "moment");
-                break;
-            case VOLTAGE:
-                strcpy(name, "volt");
-                break;
-            case POWER:
-                strcpy(name, "power");
-                break;
-            }
-            //create the Json content
-            sprintf(json, "\"%s\":%.3f,", name, data);
-        }
-        break;
-    case NODE_UUID:
-        if (msg->header.size == sizeof(luos_uuid_t))
+        case LAYOUT_FLOAT:
         {
-            luos_uuid_t value;
-            memcpy(value.unmap, msg->data, msg->header.size);
-            sprintf(json, "\"uuid\":[%" PRIu32 ",%" PRIu32 ",%" PRIu32 "],", value.uuid[0], value.uuid[1], value.uuid[2]);
+            float value;
+            memcpy(&value, src, sizeof(float));
+            json_writer_float(json, value, desc->decimals);
+            json_writer_append(json, ",");
+            break;
         }
-        break;
-    case REVISION:
-        // clean data to be used as string
-        if (msg->header.size < MAX_DATA_MSG_SIZE)
+        case LAYOUT_U32:
         {
-            msg->data[msg->header.size] = '\0';
-            //create the Json content
-            sprintf(json, "\"revision\":\"%d.%d.%d\",", msg->data[0], msg->data[1], msg->data[2]);
+            uint32_t value;
+            memcpy(&value, src, sizeof(uint32_t));
+            json_writer_uint(json, value);
+            json_writer_append(json, ",");
+            break;
         }
-        break;
-    case LUOS_REVISION:
-        // clean data to be used as string
-        if (msg->header.size < MAX_DATA_MSG_SIZE)
-        {
-            msg->data[msg->header.size] = '\0';
-            //create the Json content
-            sprintf(json, "\"luos_revision\":\"%d.%d.%d\",", msg->data[0], msg->data[1], msg->data[2]);
+        case LAYOUT_BOOL:
+            json_writer_append(json, src[0] ? "true," : "false,");
+            break;
+        case LAYOUT_VERSION:
+            json_writer_printf(json, "\"%d.%d.%d\",", src[0], src[1], src[2]);
+            break;
+        default:
+            break;
         }
-        break;
-    case LUOS_STATISTICS:
-        if (msg->header.size == sizeof(general_stats_t))
+    }
+    // remove the last "," char
+    json_writer_trim(json, ',');
+    if (desc->count > 1)
+    {
+        json_writer_append(json, "]");
+    }
+    json_writer_append(json, ",");
+}
+
+static void luos_statistics_to_json(msg_t *msg, json_writer_t *json)
+{
+    if (msg->header.size == sizeof(general_stats_t))
+    {
+        general_stats_t *stat = (general_stats_t *)msg->data;
+        // create the Json content
+        json_writer_printf(json, "\"luos_statistics\":{\"rx_msg_stack\":%d,\"luos_stack\":%d,\"tx_msg_stack\":%d,\"buffer_occupation\":%d,\"msg_drop\":%d,\"loop_ms\":%d,\"max_retry\":%d},",
+                stat->node_stat.memory.rx_msg_stack_ratio,
+                stat->node_stat.memory.luos_stack_ratio,
+                stat->node_stat.memory.tx_msg_stack_ratio,
+                stat->node_stat.memory.buffer_occupation_ratio,
+                stat->node_stat.memory.msg_drop_number,
+                stat->node_stat.max_loop_time_ms,
+                stat->container_stat.max_retry);
+    }
+}
+
+static void pedometer_to_json(msg_t *msg, json_writer_t *json)
+{
+    // check size
+    if (msg->header.size == (2 * sizeof(unsigned long)))
+    {
+        // Size ok, now fill the struct from msg data
+        unsigned long value[2];
+        memcpy(value, msg->data, msg->header.size);
+        //create the Json content
+        json_writer_append(json, "\"pedometer\":");
+        json_writer_uint(json, (uint32_t)value[0]);
+        json_writer_append(json, ",\"walk_time\":");
+        json_writer_uint(json, (uint32_t)value[1]);
+        json_writer_append(json, ",");
+    }
+}
+
+#ifdef LUOS_MESH_BRIDGE
+static void mesh_bridge_statistics_to_json(msg_t *msg, json_writer_t *json)
+{
+    if (msg->header.size == sizeof(mesh_bridge_stats_t))
+    {
+        mesh_bridge_stats_t stat;
+        memcpy(&stat, msg->data, sizeof(mesh_bridge_stats_t));
+        // create the Json content
+        json_writer_printf(json, "\"mesh_bridge_statistics\":{\"msg_to_mesh\":%lu,\"msg_from_mesh\":%lu,\"queue_high_water\":%u,\"enqueue_failures\":%lu,\"duplicate_drops\":%lu,\"tx_latency_ms\":{\"min\":%lu,\"avg\":%lu,\"max\":%lu},\"rtb_sync\":%lu,\"last_rtb_sync_ms\":%lu,\"bytes_on_air\":%lu},",
+                (unsigned long)stat.nb_msg_to_mesh,
+                (unsigned long)stat.nb_msg_from_mesh,
+                stat.queue_high_water,
+                (unsigned long)stat.nb_enqueue_failures,
+                (unsigned long)stat.nb_duplicate_drops,
+                (unsigned long)stat.tx_latency_min_ms,
+                (unsigned long)stat.tx_latency_avg_ms,
+                (unsigned long)stat.tx_latency_max_ms,
+                (unsigned long)stat.nb_rtb_sync,
+                (unsigned long)stat.last_rtb_sync_ms,
+                (unsigned long)stat.bytes_on_air);
+    }
+}
+#endif /* LUOS_MESH_BRIDGE */
+
+// Container of a routing table sent to the pilot
+typedef struct
+{
+    uint16_t id;
+    uint16_t node_id;
+    uint8_t type;
+    char alias[MAX_ALIAS_SIZE];
+} rtb_container_t;
+
+// Routing table sent to the pilot, only valid if all its containers fit
+typedef struct
+{
+    bool valid;
+    uint16_t nodes_crc;
+    uint16_t nb_containers;
+    rtb_container_t containers[GATE_MAX_CONTAINERS];
+} rtb_snapshot_t;
+
+// Last routing table sent to the pilot, and the current one
+static rtb_snapshot_t rtb_sent;
+static rtb_snapshot_t rtb_current;
+// Set once the pilot asked for routing table differences after detections
+static bool rtb_diff_enabled = false;
+
+static void rtb_snapshot_take(rtb_snapshot_t *snapshot)
+{
+    routing_table_t *routing_table = RoutingTB_Get();
+    int last_entry = RoutingTB_GetLastEntry();
+    uint16_t node_id = 0;
+    snapshot->valid = true;
+    snapshot->nodes_crc = 0xFFFF;
+    snapshot->nb_containers = 0;
+    for (int i = 0; i < last_entry; i++)
+    {
+        if (routing_table[i].mode == NODE)
         {
-            general_stats_t *stat = (general_stats_t *)msg->data;
-            // create the Json content
-            sprintf(json, "\"luos_statistics\":{\"rx_msg_stack\":%d,\"luos_stack\":%d,\"tx_msg_stack\":%d,\"buffer_occupation\":%d,\"msg_drop\":%d,\"loop_ms\":%d,\"max_retry\":%d},",
-                    stat->node_stat.memory.rx_msg_stack_ratio,
-                    stat->node_stat.memory.luos_stack_ratio,
-                    stat->node_stat.memory.tx_msg_stack_ratio,
-                    stat->node_stat.memory.buffer_occupation_ratio,
-                    stat->node_stat.memory.msg_drop_number,
-                    stat->node_stat.max_loop_time_ms,
-                    stat->container_stat.max_retry);
+            // Nodes only change with the network topology
+            node_id = routing_table[i].node_id;
+            snapshot->nodes_crc = crc16_compute((const uint8_t *)&routing_table[i].node_id, sizeof(routing_table[i].node_id), &snapshot->nodes_crc);
+            snapshot->nodes_crc = crc16_compute((const uint8_t *)&routing_table[i].certified, sizeof(routing_table[i].certified), &snapshot->nodes_crc);
+            snapshot->nodes_crc = crc16_compute((const uint8_t *)routing_table[i].port_table, sizeof(routing_table[i].port_table), &snapshot->nodes_crc);
         }
-        break;
-    case IO_STATE:
-        // check size
-        if (msg->header.size == sizeof(char))
+        else if (routing_table[i].mode == CONTAINER)
         {
-            // Size ok, now fill the struct from msg data
-            //create the Json content
-            if (msg->data[0])
+            if (snapshot->nb_containers >= GATE_MAX_CONTAINERS)
             {
-                sprintf(json, "\"io_state\":true,");
-            }
-            else
-            {
-                sprintf(json, "\"io_state\":false,");
+                snapshot->valid = false;
+                return;
             }
+            rtb_container_t *container = &snapshot->containers[snapshot->nb_containers++];
+            container->id = routing_table[i].id;
+            container->node_id = node_id;
+            container->type = routing_table[i].type;
+            memcpy(container->alias, routing_table[i].alias, MAX_ALIAS_SIZE);
         }
-        break;
-    case EULER_3D:
-    case COMPASS_3D:
-    case GYRO_3D:
-    case ACCEL_3D:
-    case LINEAR_ACCEL:
-    case GRAVITY_VECTOR:
-        // check size
-        if (msg->header.size == (3 * sizeof(float)))
+    }
+}
+
+// Returns the container of the given snapshot with the same alias, type and node, or NULL
+static const rtb_container_t *rtb_snapshot_find(const rtb_snapshot_t *snapshot, const rtb_container_t *container)
+{
+    for (uint16_t i = 0; i < snapshot->nb_containers; i++)
+    {
+        const rtb_container_t *found = &snapshot->containers[i];
+        if ((strncmp(found->alias, container->alias, MAX_ALIAS_SIZE) == 0) &&
+            (found->type == container->type) && (found->node_id == container->node_id))
         {
-            // Size ok, now fill the struct from msg data
-            float value[3];
-            memcpy(value, msg->data, msg->header.size);
-            char name[20] = {0};
-            switch (msg->header.cmd)
-            {
-            case LINEAR_ACCEL:
-                strcpy(name, "linear_accel");
-                break;
-            case GRAVITY_VECTOR:
-                strcpy(name, "gravity_vector");
-                break;
-            case COMPASS_3D:
-                strcpy(name, "compass");
-                break;
-            case GYRO_3D:
-                strcpy(name, "gyro");
-                break;
-            case ACCEL_3D:
-                strcpy(name, "accel");
-                break;
-            case EULER_3D:
-                strcpy(name, "euler");
-                break;
-            }
-            //create the Json content
-            sprintf(json, "\"%s\":[%2f,%2f,%2f],", name, value[0], value[1], value[2]);
+            return found;
         }
-        break;
-    case QUATERNION:
-        // check size
-        if (msg->header.size == (4 * sizeof(float)))
+    }
+    return NULL;
+}
+
+// Opens the given section of a routing table diff the first time
+static void rtb_diff_section(json_writer_t *json, const char *key, bool *open)
+{
+    if (!*open)
+    {
+        json_writer_printf(json, "\"%s\":[", key);
+        *open = true;
+    }
+}
+
+// Closes the given section of a routing table diff if it was opened
+static void rtb_diff_section_end(json_writer_t *json, bool open)
+{
+    if (open)
+    {
+        json_writer_trim(json, ',');
+        json_writer_append(json, "],");
+    }
+}
+
+void routing_table_diff_enable(bool enable)
+{
+    rtb_diff_enabled = enable;
+}
+
+bool routing_table_diff_is_enabled(void)
+{
+    return rtb_diff_enabled;
+}
+
+void routing_table_set_sent(void)
+{
+    rtb_snapshot_take(&rtb_sent);
+}
+
+// Sends only the containers which changed since the last routing table, or the whole table
+bool routing_table_diff_to_json(json_writer_t *json)
+{
+    rtb_snapshot_take(&rtb_current);
+    if (!rtb_sent.valid || !rtb_current.valid)
+    {
+        return routing_table_to_json(json);
+    }
+    uint32_t start = json->length;
+    uint16_t nb_changes = 0;
+    bool open = false;
+    // Keep room to close the Json message
+    json_writer_reserve(json, sizeof("}}\n") - 1);
+    json_writer_append(json, "{\"routing_table_diff\":{");
+    for (uint16_t i = 0; i < rtb_current.nb_containers; i++)
+    {
+        const rtb_container_t *container = &rtb_current.containers[i];
+        if (rtb_snapshot_find(&rtb_sent, container) == NULL)
         {
-            // Size ok, now fill the struct from msg data
-            float value[4];
-            memcpy(value, msg->data, msg->header.size);
-            //create the Json content
-            sprintf(json, "\"quaternion\":[%2f,%2f,%2f,%2f],", value[0], value[1], value[2], value[3]);
+            rtb_diff_section(json, "added", &open);
+            json_writer_printf(json, "{\"type\":\"%s\",\"id\":%d,\"alias\":\"%.*s\",\"node_id\":%d},",
+                               RoutingTB_StringFromType(container->type), container->id,
+                               MAX_ALIAS_SIZE, container->alias, container->node_id);
+            nb_changes++;
         }
-        break;
-    case ROT_MAT:
-        // check size
-        if (msg->header.size == (9 * sizeof(float)))
+    }
+    rtb_diff_section_end(json, open);
+    open = false;
+    for (uint16_t i = 0; i < rtb_sent.nb_containers; i++)
+    {
+        const rtb_container_t *container = &rtb_sent.containers[i];
+        if (rtb_snapshot_find(&rtb_current, container) == NULL)
         {
-            // Size ok, now fill the struct from msg data
-            float value[9];
-            memcpy(value, msg->data, msg->header.size);
-            //create the Json content
-            sprintf(json, "\"rotational_matrix\":[%2f,%2f,%2f,%2f,%2f,%2f,%2f,%2f,%2f],", value[0], value[1], value[2], value[3], value[4], value[5], value[6], value[7], value[8]);
+            rtb_diff_section(json, "removed", &open);
+            json_writer_printf(json, "\"%.*s\",", MAX_ALIAS_SIZE, container->alias);
+            nb_changes++;
         }
-        break;
-    case HEADING:
-        // check size
-        if (msg->header.size == (sizeof(float)))
+    }
+    rtb_diff_section_end(json, open);
+    open = false;
+    for (uint16_t i = 0; i < rtb_current.nb_containers; i++)
+    {
+        const rtb_container_t *container = &rtb_current.containers[i];
+        const rtb_container_t *sent = rtb_snapshot_find(&rtb_sent, container);
+        if ((sent != NULL) && (sent->id != container->id))
         {
-            // Size ok, now fill the struct from msg data
-            float value;
-            memcpy(&value, msg->data, msg->header.size);
-            //create the Json content
-            sprintf(json, "\"heading\":%2f,", value);
+            rtb_diff_section(json, "renumbered", &open);
+            json_writer_printf(json, "{\"alias\":\"%.*s\",\"id\":%d},", MAX_ALIAS_SIZE, container->alias, container->id);
+            nb_changes++;
         }
-        break;
-    case PEDOMETER:
-        // check size
-        if (msg->header.size == (2 * sizeof(unsigned long)))
+    }
+    rtb_diff_section_end(json, open);
+    if (rtb_current.nodes_crc != rtb_sent.nodes_crc)
+    {
+        // Nodes are listed without their containers
+        routing_table_t *routing_table = RoutingTB_Get();
+        int last_entry = RoutingTB_GetLastEntry();
+        json_writer_append(json, "\"nodes\":[");
+        for (int i = 0; i < last_entry; i++)
         {
-            // Size ok, now fill the struct from msg data
-            unsigned long value[2];
-            memcpy(value, msg->data, msg->header.size);
-            //create the Json content
-            sprintf(json, "\"pedometer\":%2ld,\"walk_time\":%2ld,", value[0], value[1]);
+            if (routing_table[i].mode == NODE)
+            {
+                json_writer_printf(json, "{\"node_id\":%d,\"certified\":%s,\"port_table\":[", routing_table[i].node_id,
+                                   routing_table[i].certified ? "true" : "false");
+                for (int port = 0; (port < 4) && routing_table[i].port_table[port]; port++)
+                {
+                    json_writer_printf(json, "%d,", routing_table[i].port_table[port]);
+                }
+                json_writer_trim(json, ',');
+                json_writer_append(json, "]},");
+            }
         }
-        break;
-    default:
-        break;
+        json_writer_trim(json, ',');
+        json_writer_append(json, "],");
+    }
+    json_writer_trim(json, ',');
+    json_writer_release(json, sizeof("}}\n") - 1);
+    json_writer_append(json, "}}\n");
+    if (json->overflow || (nb_changes > rtb_current.nb_containers / 2))
+    {
+        // Most of the table changed: the whole table is more compact
+        json_writer_rewind(json, start);
+        return routing_table_to_json(json);
     }
+    memcpy(&rtb_sent, &rtb_current, sizeof(rtb_snapshot_t));
+    return true;
 }
 
-void routing_table_to_json(char *json)
+bool routing_table_to_json(json_writer_t *json)
 {
+    // Keep room to close the Json message
+    json_writer_reserve(json, sizeof("]}\n") - 1);
     // Init the json string
-    sprintf(json, "{\"routing_table\":[");
+    json_writer_append(json, "{\"routing_table\":[");
     // loop into containers.
     routing_table_t *routing_table = RoutingTB_Get();
     int last_entry = RoutingTB_GetLastEntry();
@@ -659,31 +829,33 @@ void routing_table_to_json(char *json)
     {
         if (routing_table[i].mode == NODE)
         {
-            sprintf(json, "%s{\"node_id\":%d", json, routing_table[i].node_id);
+            // Start of the node section, to drop it if it does not fit
+            uint32_t node_start = json->length;
+            json_writer_printf(json, "{\"node_id\":%d", routing_table[i].node_id);
             if (routing_table[i].certified)
             {
-                sprintf(json, "%s,\"certified\":true", json);
+                json_writer_append(json, ",\"certified\":true");
             }
             else
             {
-                sprintf(json, "%s,\"certified\":false", json);
+                json_writer_append(json, ",\"certified\":false");
             }
-            sprintf(json, "%s,\"port_table\":[", json);
+            json_writer_append(json, ",\"port_table\":[");
             // Port loop
             for (int port = 0; port < 4; port++)
             {
                 if (routing_table[i].port_table[port])
                 {
-                    sprintf(json, "%s%d,", json, routing_table[i].port_table[port]);
+                    json_writer_printf(json, "%d,", routing_table[i].port_table[port]);
                 }
                 else
                 {
                     // remove the last "," char
-                    json[strlen(json) - 1] = '\0';
+                    json_writer_trim(json, ',');
                     break;
                 }
             }
-            sprintf(json, "%s],\"containers\":[", json);
+            json_writer_append(json, "],\"containers\":[");
             i++;
             // Containers loop
             while (i < last_entry)
@@ -691,17 +863,24 @@ void routing_table_to_json(char *json)
                 if (routing_table[i].mode == CONTAINER)
                 {
                     // Create container description
-                    sprintf(json, "%s{\"type\":\"%s", json, RoutingTB_StringFromType(routing_table[i].type));
-                    sprintf(json, "%s\",\"id\":%d", json, routing_table[i].id);
-                    sprintf(json, "%s,\"alias\":\"%s\"},", json, routing_table[i].alias);
+                    json_writer_printf(json, "{\"type\":\"%s\",\"id\":%d,\"alias\":\"%s\"},",
+                                       RoutingTB_StringFromType(routing_table[i].type),
+                                       routing_table[i].id,
+                                       routing_table[i].alias);
                     i++;
                 }
                 else
                     break;
             }
             // remove the last "," char
-            json[strlen(json) - 1] = '\0';
-            sprintf(json, "%s]},", json);
+            json_writer_trim(json, ',');
+            json_writer_append(json, "]},");
+            if (json->overflow)
+            {
+                // The node does not fit: only send the previous ones
+                json_writer_rewind(json, node_start);
+                break;
+            }
         }
         else
         {
@@ -709,14 +888,19 @@ void routing_table_to_json(char *json)
         }
     }
     // remove the last "," char
-    json[strlen(json) - 1] = '\0';
+    json_writer_trim(json, ',');
     // End the Json message
-    sprintf(json, "%s]}\n", json);
+    json_writer_release(json, sizeof("]}\n") - 1);
+    json_writer_append(json, "]}\n");
+    // Following tables are sent as differences from this one
+    bool complete = !json->overflow && (i >= last_entry);
+    rtb_snapshot_take(&rtb_sent);
+    rtb_sent.valid = rtb_sent.valid && complete;
+    return complete;
 }
 
-void exclude_container_to_json(int id, char *json)
+void exclude_container_to_json(int id, json_writer_t *json)
 {
-    sprintf(json, "{\"dead_container\":\"%s\"", RoutingTB_AliasFromId(id));
-    sprintf(json, "%s}\n", json);
+    json_writer_printf(json, "{\"dead_container\":\"%s\"}\n", RoutingTB_AliasFromId(id));
     RoutingTB_RemoveOnRoutingTable(id);
 }
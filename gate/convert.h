@@ -9,8 +9,10 @@
 #define CONVERT_H_
 
 #include <json_mnger.h>
-#include "cJSON.h"
 #include "container_structs.h"
+#include "json_parser.h"
+#include "json_writer.h"
+#include "cmd.h"
 #include "luos.h"
 
 /*
@@ -47,9 +49,20 @@ typedef struct
     };
 } servo_parameters_t;
 
-void json_to_msg(container_t *container, uint16_t id, luos_type_t type, cJSON *jobj, msg_t *msg, char *data);
-void msg_to_json(msg_t *msg, char *json);
-void routing_table_to_json(char *json);
-void exclude_container_to_json(int id, char *json);
+void json_to_msg(container_t *container, uint16_t id, luos_type_t type, json_parser_t *parser, uint16_t object, msg_t *msg, const cmd_bin_t *bin);
+int16_t json_key_to_binary_cmd(json_parser_t *parser, int32_t key, luos_type_t type);
+bool json_key_is_binary(json_parser_t *parser, int32_t key);
+bool json_key_str_is_binary(const char *key, uint16_t length);
+void msg_to_json(msg_t *msg, json_writer_t *json);
+int16_t json_key_to_msg_cmd(const char *key);
+// Both return false if the table did not fit and was truncated
+bool routing_table_to_json(json_writer_t *json);
+bool routing_table_diff_to_json(json_writer_t *json);
+// Pilots enabling differences get them instead of the whole routing table after detections
+void routing_table_diff_enable(bool enable);
+bool routing_table_diff_is_enabled(void);
+// Records the current routing table as sent to the pilot, e.g. in binary frames
+void routing_table_set_sent(void);
+void exclude_container_to_json(int id, json_writer_t *json);
 
 #endif /* CONVERT_H_ */
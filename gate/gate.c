@@ -7,6 +7,7 @@
 #include "gate.h"
 #include "json_mnger.h"
 #include <stdio.h>
+#include <string.h>
 
 #include <unistd.h>             // read
 
@@ -16,14 +17,16 @@
 // NRF APPS
 #include "app_error.h"          // APP_ERROR_CHECK
 #include "app_timer.h"          // app_timer_*
-#include "app_uart.h"           // app_uart_evt_t
+#include "nrf_pwr_mgmt.h"       // nrf_pwr_mgmt_*
 
 // LUOS
 #include "app_luos_list.h"      // LUOS_MESH_BRIDGE
 #include "luos_hal_config.h"    // MAX_SYSTICK_MS_VAL
 
 // CUSTOM
-#include "uart_helpers.h"       // uart_init
+#include "bin_protocol.h"       // bin_protocol_*
+#include "stream.h"             // stream_*
+#include "uart_helpers.h"       // uart_*
 
 #ifdef LUOS_MESH_BRIDGE
 #include "mesh_bridge.h"        // MESH_BRIDGE_*
@@ -37,14 +40,23 @@
 #endif
 
 // Size in bytes of each read operation.
-static const uint32_t   READ_SIZE               = 64;
+#define READ_SIZE 64
 
-// Time in ms between two Gate refreshes.
-#define                 GATE_REFRESH_RATE_MS    2000
-static const uint32_t   GATE_REFRESH_RATE_TICKS = APP_TIMER_TICKS(GATE_REFRESH_RATE_MS);
+// Time between two Gate refreshes, see GATE_REFRESH_TICK_MS.
+static const uint32_t   GATE_REFRESH_TICKS      = APP_TIMER_TICKS(GATE_REFRESH_TICK_MS);
 
-// Max keep-alive value.
-static const uint32_t   MAX_KEEP_ALIVE          = 30;
+// Time in ms without container data after which keep-alives are sent.
+static const uint32_t   MAX_KEEP_ALIVE_MS       = 30 * GATE_REFRESH_RATE_MS;
+
+// Closing characters of the refresh JSON.
+#define                 REFRESH_JSON_END        "}\n"
+#define                 REFRESH_JSON_END_SIZE   (sizeof(REFRESH_JSON_END) - 1)
+
+// Room left in the refresh JSON for its prefix and closing characters.
+#define                 REFRESH_JSON_MARGIN     64
+
+_Static_assert(GATE_JSON_ARENA_SIZE >= 2 * JSON_BUFF_SIZE + REFRESH_JSON_MARGIN,
+               "JSON arena shall hold at least two JSON buffers!");
 
 // Gate refresh timer
 APP_TIMER_DEF(s_gate_refresh_timer);
@@ -62,30 +74,67 @@ volatile int pub = LUOS_PROTOCOL_NB;
 // Refresh context.
 static struct
 {
-    // JSON updated between each refresh callback.
-    char            json[JSON_BUFF_SIZE];
+    // JSON updated between each refresh callback, from the JSON arena.
+    char*           json;
+    uint32_t        json_size;
 
-    // Keep-alive value.
-    unsigned int    keep_alive;
+    // Writer appending container data to the JSON.
+    json_writer_t   writer;
+
+    // Time in ms since the last sent container data.
+    uint32_t        keep_alive_ms;
+
+    // Set by the refresh timer, the refresh is done from the loop.
+    volatile bool   due;
 
 } s_gate_refresh_ctx    = { 0 };
 
-// Data reception management.
-static char* s_reception_buffer;
-static uint32_t s_reception_index = 0;
+// JSON buffers, sized from the routing table at each detection.
+static struct
+{
+    // Memory reserved once, shared between the buffers.
+    char            arena[GATE_JSON_ARENA_SIZE];
+
+    // Container data and routing table JSON, built before being sent.
+    char*           scratch;
+    uint32_t        scratch_size;
+
+} s_gate_json           = { 0 };
+
 /*******************************************************************************
  * Function
  ******************************************************************************/
 
-// Changes JSON buffer if a complete command was received.
+// Stores the received bytes in the command ring.
 static void Gate_ManageReceivedData(void);
 
 // Manages received data on data ready event, stops on error.
-static void Gate_UartEvtHandler(app_uart_evt_t* event);
+static void Gate_UartEvtHandler(uart_evt_t event);
 
-// Sends the ASK_PUB_CMD messages and prints the received information.
+// Signals the loop that a refresh is due.
 static void Gate_TimerEventHandler(void* context);
 
+// Prints the information received since the previous refresh.
+static void Gate_Refresh(void);
+
+/* Returns true if nothing is left to do until the next event: received
+** command, Luos message, refresh, detection request or stream chunk
+** acknowledgement.
+*/
+static bool Gate_IsIdle(void);
+
+// Empties the refresh JSON, keeping room for its closing characters.
+static void Gate_ResetRefreshJson(void);
+
+// Sends the refresh JSON, then empties it.
+static void Gate_SendRefreshJson(void);
+
+/* Shares the JSON arena out between the refresh JSON and the scratch
+** buffer, sized for the given number of routing table entries. Empties
+** the refresh JSON.
+*/
+static void Gate_SizeJsonBuffers(uint16_t nb_entries);
+
 #ifdef DEBUG
 // Prints the routing table on UART.
 static void print_rtb(const routing_table_t* rtb, uint16_t nb_entries);
@@ -112,18 +161,22 @@ void Gate_Init(void)
     revision_t revision = {.unmap = REV};
     container = Luos_CreateContainer(0, GATE_MOD, "gate", revision);
 
-    s_reception_buffer = get_json_buf();
+    Gate_SizeJsonBuffers(0);
 
     ret_code_t err_code = app_timer_create(&s_gate_refresh_timer,
                                            APP_TIMER_MODE_REPEATED,
                                            Gate_TimerEventHandler);
     APP_ERROR_CHECK(err_code);
+
+    // The loop sleeps until the next event when idle.
+    err_code = nrf_pwr_mgmt_init();
+    APP_ERROR_CHECK(err_code);
 }
 
 __attribute__((weak)) void json_send(char *json)
 {
-    // Sends data on the UART link with the pilot.
-    printf(json);
+    // Queues data on the UART link with the pilot, sent asynchronously.
+    uart_write((const uint8_t *)json, strlen(json));
 }
 /******************************************************************************
  * @brief loop must be call in project loop
@@ -133,35 +186,50 @@ __attribute__((weak)) void json_send(char *json)
 void Gate_Loop(void)
 {
     static volatile uint8_t detection_done = 0;
-    static char state = 0;
-    uint32_t tickstart = 0;
 
     // Check if there is a dead container
-    if (container->ll_container->dead_container_spotted)
+    if (container->ll_container->dead_container_spotted && bin_protocol_is_enabled())
     {
-        char json[JSON_BUFF_SIZE] = {0};
-        exclude_container_to_json(container->ll_container->dead_container_spotted, json);
+        uint16_t dead_id = container->ll_container->dead_container_spotted;
+        uint8_t payload[sizeof(uint16_t)] = {(uint8_t)dead_id, (uint8_t)(dead_id >> 8)};
+        bin_protocol_send(BIN_FRAME_EXCLUDED, payload, sizeof(payload));
+        RoutingTB_RemoveOnRoutingTable(dead_id);
+        container->ll_container->dead_container_spotted = 0;
+    }
+    else if (container->ll_container->dead_container_spotted)
+    {
+        char json[JSON_BUFF_SIZE];
+        json_writer_t writer;
+        json_writer_init(&writer, json, JSON_BUFF_SIZE);
+        exclude_container_to_json(container->ll_container->dead_container_spotted, &writer);
         json_send(json);
         container->ll_container->dead_container_spotted = 0;
     }
     if (detection_done)
     {
-        char json[JSON_BUFF_SIZE] = {0};
-        state = !state;
-        format_data(container, json);
-        if (json[0] != '\0')
+        char* json = s_gate_json.scratch;
+        json_writer_t writer;
+        json_writer_init(&writer, json, s_gate_json.scratch_size);
+        format_data(container, &writer);
+        if (writer.length > 0)
         {
             // Received something.
-            if (s_gate_refresh_ctx.json[0] == '\0')
+            json_writer_t* refresh_json = &s_gate_refresh_ctx.writer;
+            if ((refresh_json->length > 0)
+                && (refresh_json->length + writer.length + 1 + REFRESH_JSON_END_SIZE > GATE_LINK_MTU))
+            {
+                // Too long for a single message: send the data received so far.
+                Gate_SendRefreshJson();
+            }
+            if (refresh_json->length == 0)
             {
                 // No container data received so far.
-                sprintf(s_gate_refresh_ctx.json, "{\"containers\":%s",
-                        json);
+                json_writer_printf(refresh_json, "{\"containers\":%s",
+                                   json);
             }
             else
             {
-                sprintf(s_gate_refresh_ctx.json, "%s,%s",
-                        s_gate_refresh_ctx.json, json);
+                json_writer_printf(refresh_json, ",%s", json);
             }
         }
     }
@@ -170,19 +238,35 @@ void Gate_Loop(void)
         Luos_SendMsg(container_pointer, (msg_t *)&pub_msg);
         pub = LUOS_PROTOCOL_NB;
     }
+    if (detection_done)
+    {
+        // Keep data requests flowing
+        collect_data_poll(container);
+    }
     // check if serial input messages ready and convert it into a luos message
     send_cmds(container);
+    stream_poll();
     if (detection_ask)
     {
-        char json[JSON_BUFF_SIZE * 2] = {0};
         RoutingTB_DetectContainers(container);
-        routing_table_to_json(json);
-        json_send(json);
+        container_cache_build();
+        collect_data_reset();
+        delta_reset();
+        Gate_SizeJsonBuffers(RoutingTB_GetLastEntry());
+        if (bin_protocol_is_enabled())
+        {
+            bin_protocol_send_routing_table();
+        }
+        else
+        {
+            // The pilot asked for differences: it already knows most of the table
+            Gate_SendRoutingTable(routing_table_diff_is_enabled());
+        }
 
         if (!detection_done)
         {
             ret_code_t err_code = app_timer_start(s_gate_refresh_timer,
-                GATE_REFRESH_RATE_TICKS, (void*)container);
+                GATE_REFRESH_TICKS, (void*)container);
             APP_ERROR_CHECK(err_code);
         }
 
@@ -212,50 +296,55 @@ void Gate_Loop(void)
         detection_ask = 0;
     }
 
-    tickstart = Luos_GetSystick();
-    while ((Luos_GetSystick() - tickstart) < 100);
+    if (s_gate_refresh_ctx.due)
+    {
+        s_gate_refresh_ctx.due = false;
+        Gate_Refresh();
+    }
+
+    if (Gate_IsIdle())
+    {
+        // Any interrupt wakes the Gate up: UART, Luos or timers.
+        nrf_pwr_mgmt_run();
+    }
+}
+
+static bool Gate_IsIdle(void)
+{
+    return !s_gate_refresh_ctx.due && !cmds_pending() && !detection_ask
+           && (Luos_NbrAvailableMsg() == 0) && (pub == LUOS_PROTOCOL_NB)
+           && !container->ll_container->dead_container_spotted
+           && !stream_is_busy();
 }
 
 static void Gate_ManageReceivedData(void)
 {
+    uint8_t data[READ_SIZE];
     ssize_t read_bytes;
     do
     {
-        read_bytes = read(0, s_reception_buffer + s_reception_index,
-                          READ_SIZE);
+        read_bytes = read(0, data, READ_SIZE);
 
         if (read_bytes == -1)
             while (true);
 
-        if (read_bytes == 0)
-            break;
-
-        s_reception_index += read_bytes;
-    } while (s_reception_index < JSON_BUFF_SIZE
-             && read_bytes == READ_SIZE);
-
-    bool complete = check_json(s_reception_index - 1);
-    if (complete)
-    {
-        s_reception_index = 0;
-    }
-
-    s_reception_buffer = get_json_buf();
+        // Commands are stored in the reception ring as they come.
+        cmd_receive(data, (uint32_t)read_bytes);
+    } while (read_bytes == READ_SIZE);
 }
 
-static void Gate_UartEvtHandler(app_uart_evt_t* event)
+static void Gate_UartEvtHandler(uart_evt_t event)
 {
-    switch (event->evt_type)
+    switch (event)
     {
-    case APP_UART_DATA_READY:
+    case UART_EVT_RX_DATA_READY:
         Gate_ManageReceivedData();
         break;
-    case APP_UART_TX_EMPTY:
+    case UART_EVT_TX_DONE:
+        break;
+    case UART_EVT_ERROR:
+        // Reception goes on: a command holding dropped bytes fails to parse.
         break;
-    case APP_UART_DATA:
-    case APP_UART_FIFO_ERROR:
-    case APP_UART_COMMUNICATION_ERROR:
-        while (true);
     }
 }
 
@@ -296,38 +385,107 @@ static void print_rtb(const routing_table_t* rtb, uint16_t nb_entries)
 
 static void Gate_TimerEventHandler(void* context)
 {
-    container_t* gate_instance = (container_t*)context;
+    s_gate_refresh_ctx.due = true;
+}
 
-    if (s_gate_refresh_ctx.json[0] != '\0')
+static void Gate_Refresh(void)
+{
+    json_writer_t* refresh_json = &s_gate_refresh_ctx.writer;
+
+    if (refresh_json->length > 0)
     {
-        sprintf(s_gate_refresh_ctx.json, "%s}\n",
-                s_gate_refresh_ctx.json);
-        #ifndef DEBUG
-        // This print is noise in a debugging setting.
-        json_send(s_gate_refresh_ctx.json);
-        #endif /* ! DEBUG */
-
-        s_gate_refresh_ctx.keep_alive = 0;
+        Gate_SendRefreshJson();
     }
     else
     {
-        if (s_gate_refresh_ctx.keep_alive > MAX_KEEP_ALIVE)
+        if (s_gate_refresh_ctx.keep_alive_ms > MAX_KEEP_ALIVE_MS)
         {
-            sprintf(s_gate_refresh_ctx.json, "{}\n");
-
             #ifndef DEBUG
             // This print is noise in a debugging setting.
-            json_send(s_gate_refresh_ctx.json);
+            if (bin_protocol_is_enabled())
+            {
+                // Empty telemetry frame.
+                bin_protocol_send(BIN_FRAME_TELEMETRY, NULL, 0);
+            }
+            else
+            {
+                char keep_alive_json[] = "{}\n";
+                json_send(keep_alive_json);
+            }
             #endif /* ! DEBUG */
+
+            // Next keep-alive after a default refresh period.
+            s_gate_refresh_ctx.keep_alive_ms = MAX_KEEP_ALIVE_MS - GATE_REFRESH_RATE_MS;
         }
-        else
-        {
-            s_gate_refresh_ctx.keep_alive++;
-        }
+        s_gate_refresh_ctx.keep_alive_ms += GATE_REFRESH_TICK_MS;
     }
+}
+
+static void Gate_SendRefreshJson(void)
+{
+    json_writer_t* refresh_json = &s_gate_refresh_ctx.writer;
+
+    // Room was kept for the closing characters.
+    json_writer_release(refresh_json, REFRESH_JSON_END_SIZE);
+    json_writer_append(refresh_json, REFRESH_JSON_END);
+    #ifndef DEBUG
+    // This print is noise in a debugging setting.
+    json_send(s_gate_refresh_ctx.json);
+    #endif /* ! DEBUG */
+
+    s_gate_refresh_ctx.keep_alive_ms = 0;
 
     // Resetting buffer.
-    memset(s_gate_refresh_ctx.json, 0, JSON_BUFF_SIZE * sizeof(char));
+    Gate_ResetRefreshJson();
+}
+
+void Gate_SendRoutingTable(bool diff)
+{
+    json_writer_t writer;
+    json_writer_init(&writer, s_gate_json.scratch, s_gate_json.scratch_size);
+
+    bool complete = diff ? routing_table_diff_to_json(&writer)
+                         : routing_table_to_json(&writer);
+    if (!complete)
+    {
+        // A truncated table would be taken for the whole one.
+        char json[48];
+        snprintf(json, sizeof(json), "{\"routing_table_overflow\":%u}\n",
+                 RoutingTB_GetLastEntry());
+        json_send(json);
+        return;
+    }
+
+    json_send(s_gate_json.scratch);
+}
+
+static void Gate_ResetRefreshJson(void)
+{
+    json_writer_init(&s_gate_refresh_ctx.writer, s_gate_refresh_ctx.json,
+                     s_gate_refresh_ctx.json_size);
+    json_writer_reserve(&s_gate_refresh_ctx.writer, REFRESH_JSON_END_SIZE);
+}
+
+static void Gate_SizeJsonBuffers(uint16_t nb_entries)
+{
+    // The refresh JSON always holds the scratch buffer, its prefix and end.
+    uint32_t max_scratch_size   = (GATE_JSON_ARENA_SIZE - REFRESH_JSON_MARGIN) / 2;
+    uint32_t scratch_size       = (uint32_t)(nb_entries + 1) * GATE_JSON_ENTRY_SIZE;
+
+    if (scratch_size < JSON_BUFF_SIZE)
+    {
+        scratch_size = JSON_BUFF_SIZE;
+    }
+    if (scratch_size > max_scratch_size)
+    {
+        scratch_size = max_scratch_size;
+    }
+
+    s_gate_json.scratch             = s_gate_json.arena;
+    s_gate_json.scratch_size        = scratch_size;
+    s_gate_refresh_ctx.json         = s_gate_json.arena + scratch_size;
+    s_gate_refresh_ctx.json_size    = GATE_JSON_ARENA_SIZE - scratch_size;
 
-    collect_data(gate_instance);
+    // Data gathered with the previous IDs is dropped.
+    Gate_ResetRefreshJson();
 }
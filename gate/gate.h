@@ -22,4 +22,6 @@
 void Gate_Init(void);
 void Gate_Loop(void);
 void json_send(char *json);
+// Sends the routing table, or its differences, from the JSON scratch buffer
+void Gate_SendRoutingTable(bool diff);
 #endif /* GATE_H */
@@ -0,0 +1,7 @@
+// Host builds include the Mesh Bridge messages, as Gates of Mesh networks.
+#ifndef APP_LUOS_LIST_H
+#define APP_LUOS_LIST_H
+
+#define LUOS_MESH_BRIDGE
+
+#endif /* ! APP_LUOS_LIST_H */
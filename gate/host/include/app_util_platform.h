@@ -0,0 +1,7 @@
+// Host stand-in for the platform utilities.
+#ifndef APP_UTIL_PLATFORM_H
+#define APP_UTIL_PLATFORM_H
+
+#define __DMB() __sync_synchronize()
+
+#endif /* ! APP_UTIL_PLATFORM_H */
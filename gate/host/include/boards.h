@@ -0,0 +1,7 @@
+// Host stand-in for the board support.
+#ifndef BOARDS_H
+#define BOARDS_H
+
+void bsp_board_leds_on(void);
+
+#endif /* ! BOARDS_H */
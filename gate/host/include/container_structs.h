@@ -0,0 +1,19 @@
+// Host stand-in for the Luos object dictionary types and unit conversions.
+#ifndef CONTAINER_STRUCTS_H
+#define CONTAINER_STRUCTS_H
+
+#include <stdint.h>
+
+typedef float angular_position_t;
+typedef float angular_speed_t;
+typedef float linear_position_t;
+typedef float linear_speed_t;
+typedef float time_luos_t;
+
+float AngularOD_PositionFrom_deg(float deg);
+float AngularOD_SpeedFrom_deg_s(float deg_s);
+float LinearOD_PositionFrom_mm(float mm);
+float LinearOD_Speedfrom_mm_s(float mm_s);
+float TimeOD_TimeFrom_s(float s);
+
+#endif /* ! CONTAINER_STRUCTS_H */
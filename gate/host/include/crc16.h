@@ -0,0 +1,9 @@
+// Host stand-in for the CRC-16/CCITT computation.
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <stdint.h>
+
+uint16_t crc16_compute(uint8_t const *p_data, uint32_t size, uint16_t const *p_crc);
+
+#endif /* ! CRC16_H */
@@ -0,0 +1,89 @@
+/* Host stand-in for the Luos API used by the Gate conversions: messages
+** are queued by the benchmark and sent messages are counted.
+*/
+#ifndef LUOS_H
+#define LUOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "container_structs.h"
+#include "luos_list.h"
+#include "robus_struct.h"
+#include "routing_table.h"
+
+#define NBR_RETRY 10
+
+typedef enum
+{
+    SUCCEED,
+    FAILED
+} error_return_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint8_t rx_msg_stack_ratio;
+    uint8_t luos_stack_ratio;
+    uint8_t tx_msg_stack_ratio;
+    uint8_t buffer_occupation_ratio;
+    uint8_t msg_drop_number;
+} memory_stats_t;
+
+typedef struct __attribute__((__packed__))
+{
+    memory_stats_t memory;
+    uint8_t max_loop_time_ms;
+} luos_stats_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint8_t max_retry;
+} container_stats_t;
+
+typedef struct __attribute__((__packed__))
+{
+    luos_stats_t node_stat;
+    container_stats_t container_stat;
+} general_stats_t;
+
+typedef struct
+{
+    uint16_t dead_container_spotted;
+    struct
+    {
+        uint8_t *max_retry;
+    } ll_stat;
+} vm_t;
+
+struct container_t
+{
+    vm_t *ll_container;
+    luos_stats_t *node_statistics;
+};
+
+typedef union
+{
+    uint8_t unmap[3];
+} revision_t;
+
+typedef union
+{
+    struct __attribute__((__packed__))
+    {
+        uint32_t line;
+        char file[64];
+    };
+    uint8_t unmap[MAX_DATA_MSG_SIZE + 1];
+} luos_assert_t;
+
+error_return_t Luos_SendMsg(container_t *container, msg_t *msg);
+error_return_t Luos_SendData(container_t *container, msg_t *msg, void *bin_data, uint16_t size);
+error_return_t Luos_ReadMsg(container_t *container, msg_t **returned_msg);
+error_return_t Luos_ReadFromContainer(container_t *container, short id, msg_t **returned_msg);
+error_return_t Luos_TxComplete(void);
+uint16_t Luos_NbrAvailableMsg(void);
+uint32_t Luos_GetSystick(void);
+void Luos_Flush(void);
+void Luos_Loop(void);
+void Luos_SendBaudrate(container_t *container, uint32_t baudrate);
+
+#endif /* ! LUOS_H */
@@ -0,0 +1,40 @@
+/* Host stand-in for a Luos network: a synthetic routing table, a queue of
+** messages received by the Gate, and records of what the Gate sent.
+*/
+#ifndef LUOS_HOST_H
+#define LUOS_HOST_H
+
+#include <stdint.h>
+#include "luos.h"
+
+// Maximum number of containers of a synthetic network.
+#define LUOS_HOST_MAX_CONTAINERS 512
+
+// Maximum number of messages waiting to be read by the Gate.
+#define LUOS_HOST_MAX_MSGS 4096
+
+// Recorded sizes of the last JSON sent to the pilot and of the last data sent to a container.
+#define LUOS_HOST_MAX_JSON 256
+#define LUOS_HOST_MAX_DATA 256
+
+/* Builds a network of the given number of sensor containers, spread on
+** nodes of the given number of containers, behind the Gate container.
+*/
+void luos_host_build_network(uint16_t nb_containers, uint16_t containers_per_node);
+
+// Returns the Gate container.
+container_t *luos_host_gate(void);
+
+// Queues the given message as received by the Gate, returns false if the queue is full.
+bool luos_host_receive(const msg_t *msg);
+
+// Returns the number of bytes sent to the pilot since the last call.
+uint32_t luos_host_take_sent_bytes(void);
+
+// Returns the last JSON sent to the pilot, truncated to LUOS_HOST_MAX_JSON.
+const char *luos_host_last_json(void);
+
+// Returns the last binary data sent to a container and its size, truncated to LUOS_HOST_MAX_DATA.
+const uint8_t *luos_host_last_data(uint16_t *size);
+
+#endif /* ! LUOS_HOST_H */
@@ -0,0 +1,82 @@
+/* Host stand-in for the Luos container types and commands used by the
+** Gate conversions.
+*/
+#ifndef LUOS_LIST_H
+#define LUOS_LIST_H
+
+// Container types.
+typedef enum
+{
+    VOID_MOD,
+    GATE_MOD,
+    STATE_MOD,
+    COLOR_MOD,
+    ANGLE_MOD,
+    DISTANCE_MOD,
+    DYNAMIXEL_MOD,
+    IMU_MOD,
+    LIGHT_MOD,
+    MOTOR_MOD,
+    SERVO_MOD,
+    VOLTAGE_MOD,
+    LUOS_LAST_TYPE
+} luos_type_t;
+
+// Container commands.
+enum
+{
+    ASSERT,
+    ASK_PUB_CMD,
+    REVISION,
+    LUOS_REVISION,
+    LUOS_STATISTICS,
+    NODE_UUID,
+    WRITE_ALIAS,
+    SETID,
+    LINEAR_POSITION,
+    LINEAR_SPEED,
+    ANGULAR_POSITION,
+    ANGULAR_SPEED,
+    VOLTAGE,
+    CURRENT,
+    POWER,
+    ILLUMINANCE,
+    TEMPERATURE,
+    FORCE,
+    MOMENT,
+    IO_STATE,
+    EULER_3D,
+    COMPASS_3D,
+    GYRO_3D,
+    ACCEL_3D,
+    LINEAR_ACCEL,
+    GRAVITY_VECTOR,
+    QUATERNION,
+    ROT_MAT,
+    HEADING,
+    PEDOMETER,
+    ANGULAR_POSITION_LIMIT,
+    LINEAR_POSITION_LIMIT,
+    ANGULAR_SPEED_LIMIT,
+    LINEAR_SPEED_LIMIT,
+    RATIO_LIMIT,
+    CURRENT_LIMIT,
+    TORQUE_LIMIT,
+    COMPLIANT,
+    PID,
+    RESOLUTION,
+    OFFSET,
+    REDUCTION,
+    DIMENSION,
+    REINIT,
+    CONTROL,
+    COLOR,
+    PARAMETERS,
+    REGISTER,
+    DXL_WHEELMODE,
+    RATIO,
+    TIME,
+    LUOS_PROTOCOL_NB
+};
+
+#endif /* ! LUOS_LIST_H */
@@ -0,0 +1,9 @@
+// Host stand-in for the Luos assertion.
+#ifndef LUOS_UTILS_H
+#define LUOS_UTILS_H
+
+#include <assert.h>
+
+#define LUOS_ASSERT(expr) assert(expr)
+
+#endif /* ! LUOS_UTILS_H */
@@ -0,0 +1,39 @@
+// Host stand-in for the Luos message structures.
+#ifndef ROBUS_STRUCT_H
+#define ROBUS_STRUCT_H
+
+#include <stdint.h>
+
+#define MAX_DATA_MSG_SIZE 128
+
+// Target modes.
+enum
+{
+    ID,
+    IDACK,
+    TYPE,
+    BROADCAST,
+    MULTICAST,
+    NODEID,
+    NODEIDACK
+};
+
+#define BROADCAST_VAL 0x0FFF
+
+typedef struct __attribute__((__packed__))
+{
+    uint16_t protocol : 4;
+    uint16_t target : 12;
+    uint16_t target_mode : 4;
+    uint16_t source : 12;
+    uint8_t cmd;
+    uint16_t size;
+} header_t;
+
+typedef struct
+{
+    header_t header;
+    uint8_t data[MAX_DATA_MSG_SIZE];
+} msg_t;
+
+#endif /* ! ROBUS_STRUCT_H */
@@ -0,0 +1,52 @@
+// Host stand-in for the Luos routing table, filled by the benchmark.
+#ifndef ROUTING_TABLE_H
+#define ROUTING_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "luos_list.h"
+
+#define MAX_ALIAS_SIZE 16
+#define NBR_PORT 4
+
+typedef enum
+{
+    CLEAR,
+    CONTAINER,
+    NODE
+} entry_mode_t;
+
+typedef struct
+{
+    entry_mode_t mode;
+    union
+    {
+        struct
+        {
+            uint16_t id;
+            uint8_t type;
+            char alias[MAX_ALIAS_SIZE];
+        };
+        struct
+        {
+            uint16_t node_id;
+            uint16_t certified;
+            uint16_t port_table[NBR_PORT];
+        };
+    };
+} routing_table_t;
+
+typedef struct container_t container_t;
+
+routing_table_t *RoutingTB_Get(void);
+uint16_t RoutingTB_GetLastEntry(void);
+uint16_t RoutingTB_GetLastContainer(void);
+void RoutingTB_DetectContainers(container_t *container);
+char *RoutingTB_StringFromType(uint8_t type);
+char *RoutingTB_AliasFromId(uint16_t id);
+uint16_t RoutingTB_IDFromAlias(char *alias);
+uint8_t RoutingTB_TypeFromID(uint16_t id);
+bool RoutingTB_ContainerIsSensor(uint8_t type);
+void RoutingTB_RemoveOnRoutingTable(uint16_t id);
+
+#endif /* ! ROUTING_TABLE_H */
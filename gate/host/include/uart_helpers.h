@@ -0,0 +1,9 @@
+// Host stand-in for the UART link with the pilot, whose bytes are counted.
+#ifndef UART_HELPERS_H
+#define UART_HELPERS_H
+
+#include <stdint.h>
+
+void uart_write(const uint8_t *data, uint32_t length);
+
+#endif /* ! UART_HELPERS_H */
@@ -0,0 +1,285 @@
+/* Measures the throughput of the Gate JSON conversions on the host, for
+** synthetic networks of 10 to 500 containers, after checking the number
+** formatting of the JSON writer against printf.
+*/
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "cmd.h"
+#include "convert.h"
+#include "json_mnger.h"
+#include "json_writer.h"
+#include "luos_host.h"
+
+// Size of the JSON buffers, large enough for the largest network
+#define BENCH_JSON_SIZE (256 * 1024)
+
+// Containers addressed by each benchmarked command, bounded by the command tokens
+#define BENCH_CMD_CONTAINERS 24
+
+static const uint16_t NETWORK_SIZES[] = {10, 50, 100, 250, 500};
+#define NB_NETWORK_SIZES (sizeof(NETWORK_SIZES) / sizeof(uint16_t))
+
+static char json[BENCH_JSON_SIZE];
+
+static uint64_t now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+}
+
+// Pseudo-random generator of the checked values, reproducible from run to run
+static uint32_t random_u32(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return *state;
+}
+
+// Returns true if the given float is written as printf does with each number of decimals
+static bool check_float(float value)
+{
+    char expected[512];
+    json_writer_t writer;
+    for (uint8_t decimals = 0; decimals <= JSON_WRITER_MAX_DECIMALS + 1; decimals++)
+    {
+        json_writer_init(&writer, json, BENCH_JSON_SIZE);
+        json_writer_float(&writer, value, decimals);
+        snprintf(expected, sizeof(expected), "%.*f", decimals, (double)value);
+        if (strcmp(json, expected) != 0)
+        {
+            printf("float %a with %u decimals: \"%s\" instead of \"%s\"\n", (double)value, decimals, json, expected);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Returns the number of numbers not written as printf does
+static uint32_t check_number_format(uint32_t nb_values)
+{
+    uint32_t nb_errors = 0;
+    uint32_t state = 1;
+    static const float EDGES[] = {0.0f, -0.0f, 0.5f, -0.5f, 1.5f, 2.5f, 0.0625f, 0.0005f, -0.0001f, 1e-45f, 4294967295.0f, 1e12f, 9.2e17f, 1e18f, 3.4e38f, INFINITY, -INFINITY, NAN};
+    for (uint32_t i = 0; i < sizeof(EDGES) / sizeof(float); i++)
+    {
+        nb_errors += !check_float(EDGES[i]);
+    }
+    for (uint32_t i = 0; i < nb_values; i++)
+    {
+        // Any bit pattern
+        uint32_t bits = random_u32(&state);
+        float value;
+        memcpy(&value, &bits, sizeof(float));
+        nb_errors += !check_float(value);
+        // Sensor ranges
+        value = ((float)random_u32(&state) / 4294967296.0f - 0.5f) * 20000.0f;
+        nb_errors += !check_float(value);
+        // Exact binary fractions, halfway between two printed values
+        value = (float)((int32_t)random_u32(&state) >> 12) / 128.0f;
+        nb_errors += !check_float(value);
+    }
+    static const int32_t INTS[] = {0, 1, -1, 9, 10, INT32_MAX, INT32_MIN};
+    char expected[32];
+    json_writer_t writer;
+    for (uint32_t i = 0; i < nb_values + sizeof(INTS) / sizeof(int32_t); i++)
+    {
+        int32_t value = (i < sizeof(INTS) / sizeof(int32_t)) ? INTS[i] : (int32_t)random_u32(&state);
+        json_writer_init(&writer, json, BENCH_JSON_SIZE);
+        json_writer_int(&writer, value);
+        json_writer_uint(&writer, (uint32_t)value);
+        snprintf(expected, sizeof(expected), "%" PRId32 "%" PRIu32, value, (uint32_t)value);
+        if (strcmp(json, expected) != 0)
+        {
+            printf("integer %" PRId32 ": \"%s\" instead of \"%s\"\n", value, json, expected);
+            nb_errors++;
+        }
+    }
+    return nb_errors;
+}
+
+// Returns the time in ns of each float written with 3 decimals, by the writer or by printf
+static double bench_float(uint32_t repetitions, bool with_printf)
+{
+    json_writer_t writer;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        json_writer_init(&writer, json, BENCH_JSON_SIZE);
+        for (uint8_t j = 0; j < 10; j++)
+        {
+            float value = -0.70710677f + 0.37f * j;
+            if (with_printf)
+            {
+                json_writer_printf(&writer, "%.*f", 3, value);
+            }
+            else
+            {
+                json_writer_float(&writer, value, 3);
+            }
+        }
+    }
+    return (double)(now_ns() - start) / (10.0 * repetitions);
+}
+
+// Fills the given message with float values of the given command
+static void make_msg(msg_t *msg, uint16_t source, uint8_t cmd, uint8_t nb_values, float seed)
+{
+    memset(msg, 0, sizeof(msg_t));
+    msg->header.target_mode = ID;
+    msg->header.target = 1;
+    msg->header.source = source;
+    msg->header.cmd = cmd;
+    msg->header.size = nb_values * sizeof(float);
+    for (uint8_t i = 0; i < nb_values; i++)
+    {
+        float value = seed + 0.125f * i;
+        memcpy(&msg->data[i * sizeof(float)], &value, sizeof(float));
+    }
+}
+
+// Queues the data published by every sensor for one refresh
+static void publish_all(uint16_t nb_containers, float seed)
+{
+    msg_t msg;
+    for (uint16_t id = 2; id <= nb_containers + 1; id++)
+    {
+        switch (id % 3)
+        {
+        case 0:
+            make_msg(&msg, id, TEMPERATURE, 1, seed + id);
+            luos_host_receive(&msg);
+            break;
+        case 1:
+            make_msg(&msg, id, ACCEL_3D, 3, seed + id);
+            luos_host_receive(&msg);
+            make_msg(&msg, id, QUATERNION, 4, seed - id);
+            luos_host_receive(&msg);
+            break;
+        default:
+            make_msg(&msg, id, ANGULAR_POSITION, 1, seed * id);
+            luos_host_receive(&msg);
+            break;
+        }
+    }
+}
+
+// Returns the time in ns of each conversion of the telemetry messages into JSON
+static double bench_msg_to_json(uint32_t repetitions)
+{
+    msg_t msgs[3];
+    make_msg(&msgs[0], 2, TEMPERATURE, 1, 21.5f);
+    make_msg(&msgs[1], 2, ACCEL_3D, 3, -0.25f);
+    make_msg(&msgs[2], 2, QUATERNION, 4, 0.70710677f);
+    json_writer_t writer;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        json_writer_init(&writer, json, BENCH_JSON_SIZE);
+        for (uint8_t j = 0; j < 3; j++)
+        {
+            msg_to_json(&msgs[j], &writer);
+        }
+    }
+    return (double)(now_ns() - start) / (3.0 * repetitions);
+}
+
+// Returns the time in us of a refresh of every container
+static double bench_format_data(uint16_t nb_containers, uint32_t repetitions, uint32_t *size)
+{
+    container_t *gate = luos_host_gate();
+    json_writer_t writer;
+    uint64_t total = 0;
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        publish_all(nb_containers, (float)i);
+        uint64_t start = now_ns();
+        *size = 0;
+        // As many calls as the Gate loop makes to read every message
+        while (Luos_NbrAvailableMsg() > 0)
+        {
+            json_writer_init(&writer, json, BENCH_JSON_SIZE);
+            format_data(gate, &writer);
+            *size += writer.length;
+        }
+        total += now_ns() - start;
+    }
+    return (double)total / (1000.0 * repetitions);
+}
+
+// Returns the time in us of a full routing table JSON
+static double bench_routing_table(uint32_t repetitions, uint32_t *size)
+{
+    json_writer_t writer;
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        json_writer_init(&writer, json, BENCH_JSON_SIZE);
+        routing_table_to_json(&writer);
+        *size = writer.length;
+    }
+    return (double)(now_ns() - start) / (1000.0 * repetitions);
+}
+
+// Returns the time in us of the reception and parsing of a command addressing several containers
+static double bench_command(uint16_t nb_containers, uint32_t repetitions)
+{
+    json_writer_t writer;
+    json_writer_init(&writer, json, BENCH_JSON_SIZE);
+    json_writer_append(&writer, "{\"containers\":{");
+    uint16_t nb_targets = (nb_containers < BENCH_CMD_CONTAINERS) ? nb_containers : BENCH_CMD_CONTAINERS;
+    for (uint16_t i = 0; i < nb_targets; i++)
+    {
+        // Spread over the network, so that alias lookups are not all short
+        json_writer_printf(&writer, "\"sensor%u\":{\"target_rot_position\":%.1f},", i * nb_containers / nb_targets, 12.5f * i);
+    }
+    json_writer_trim(&writer, ',');
+    json_writer_append(&writer, "}}\r");
+    uint32_t length = writer.length;
+    container_t *gate = luos_host_gate();
+    uint64_t start = now_ns();
+    for (uint32_t i = 0; i < repetitions; i++)
+    {
+        cmd_receive((const uint8_t *)json, length);
+        send_cmds(gate);
+    }
+    return (double)(now_ns() - start) / (1000.0 * repetitions);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t repetitions = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : 200;
+    if (repetitions == 0)
+    {
+        repetitions = 1;
+    }
+    uint32_t nb_errors = check_number_format(repetitions * 1000);
+    printf("number format: %s\n", (nb_errors == 0) ? "same as printf" : "differs from printf");
+    if (nb_errors != 0)
+    {
+        return 1;
+    }
+    printf("float: %.1f ns/value, printf: %.1f ns/value\n", bench_float(repetitions * 100, false), bench_float(repetitions * 100, true));
+    printf("msg_to_json: %.1f ns/msg\n\n", bench_msg_to_json(repetitions * 100));
+    printf("%10s %18s %12s %22s %12s %14s\n", "containers", "format_data (us)", "bytes", "routing_table (us)", "bytes", "command (us)");
+    for (uint16_t i = 0; i < NB_NETWORK_SIZES; i++)
+    {
+        uint16_t nb_containers = NETWORK_SIZES[i];
+        luos_host_build_network(nb_containers, 4);
+        container_cache_build();
+        collect_data_reset();
+        delta_reset();
+        uint32_t data_size = 0;
+        uint32_t rtb_size = 0;
+        double format_us = bench_format_data(nb_containers, repetitions, &data_size);
+        double rtb_us = bench_routing_table(repetitions, &rtb_size);
+        double cmd_us = bench_command(nb_containers, repetitions);
+        luos_host_take_sent_bytes();
+        printf("%10u %18.1f %12u %22.1f %12u %14.1f\n", nb_containers, format_us, data_size, rtb_us, rtb_size, cmd_us);
+    }
+    return 0;
+}
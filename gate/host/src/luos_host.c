@@ -0,0 +1,340 @@
+#include "luos_host.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "boards.h"
+#include "crc16.h"
+#include "convert.h"
+#include "uart_helpers.h"
+
+// Synthetic routing table: a Gate node, then nodes of sensors.
+static routing_table_t routing_table[2 * LUOS_HOST_MAX_CONTAINERS + 2];
+static uint16_t nb_entries = 0;
+static uint16_t last_container = 0;
+
+// Messages received by the Gate, read in order.
+static msg_t msgs[LUOS_HOST_MAX_MSGS];
+static bool msg_read[LUOS_HOST_MAX_MSGS];
+static uint16_t msg_head = 0;
+static uint16_t msg_tail = 0;
+static uint16_t nb_msgs = 0;
+
+static uint8_t max_retry = 0;
+static vm_t gate_vm = {.ll_stat = {.max_retry = &max_retry}};
+static luos_stats_t gate_stats;
+static container_t gate = {.ll_container = &gate_vm, .node_statistics = &gate_stats};
+
+static uint32_t sent_bytes = 0;
+static char last_json[LUOS_HOST_MAX_JSON];
+static uint8_t last_data[LUOS_HOST_MAX_DATA];
+static uint16_t last_data_size = 0;
+
+static const luos_type_t SENSOR_TYPES[] = {STATE_MOD, ANGLE_MOD, DISTANCE_MOD, IMU_MOD, LIGHT_MOD, VOLTAGE_MOD};
+#define NB_SENSOR_TYPES (sizeof(SENSOR_TYPES) / sizeof(luos_type_t))
+
+static void add_node(uint16_t node_id)
+{
+    routing_table_t *entry = &routing_table[nb_entries++];
+    memset(entry, 0, sizeof(routing_table_t));
+    entry->mode = NODE;
+    entry->node_id = node_id;
+    entry->certified = true;
+    entry->port_table[0] = last_container;
+    entry->port_table[1] = last_container + 2;
+}
+
+static void add_container(luos_type_t type, const char *alias)
+{
+    routing_table_t *entry = &routing_table[nb_entries++];
+    memset(entry, 0, sizeof(routing_table_t));
+    entry->mode = CONTAINER;
+    entry->id = ++last_container;
+    entry->type = type;
+    snprintf(entry->alias, MAX_ALIAS_SIZE, "%s", alias);
+}
+
+void luos_host_build_network(uint16_t nb_containers, uint16_t containers_per_node)
+{
+    if (nb_containers > LUOS_HOST_MAX_CONTAINERS)
+    {
+        nb_containers = LUOS_HOST_MAX_CONTAINERS;
+    }
+    if (containers_per_node == 0)
+    {
+        containers_per_node = 1;
+    }
+    nb_entries = 0;
+    last_container = 0;
+    uint16_t node_id = 1;
+    add_node(node_id++);
+    add_container(GATE_MOD, "gate");
+    for (uint16_t i = 0; i < nb_containers; i++)
+    {
+        if ((i % containers_per_node) == 0)
+        {
+            add_node(node_id++);
+        }
+        char alias[MAX_ALIAS_SIZE];
+        snprintf(alias, sizeof(alias), "sensor%u", i);
+        add_container(SENSOR_TYPES[i % NB_SENSOR_TYPES], alias);
+    }
+    msg_head = msg_tail = nb_msgs = 0;
+}
+
+container_t *luos_host_gate(void)
+{
+    return &gate;
+}
+
+bool luos_host_receive(const msg_t *msg)
+{
+    if (((msg_head + 1) % LUOS_HOST_MAX_MSGS) == msg_tail)
+    {
+        return false;
+    }
+    msgs[msg_head] = *msg;
+    msg_read[msg_head] = false;
+    msg_head = (msg_head + 1) % LUOS_HOST_MAX_MSGS;
+    nb_msgs++;
+    return true;
+}
+
+uint32_t luos_host_take_sent_bytes(void)
+{
+    uint32_t bytes = sent_bytes;
+    sent_bytes = 0;
+    return bytes;
+}
+
+const char *luos_host_last_json(void)
+{
+    return last_json;
+}
+
+const uint8_t *luos_host_last_data(uint16_t *size)
+{
+    *size = last_data_size;
+    return last_data;
+}
+
+// Drops the read messages at the tail of the queue
+static void drop_read_msgs(void)
+{
+    while ((msg_tail != msg_head) && msg_read[msg_tail])
+    {
+        msg_tail = (msg_tail + 1) % LUOS_HOST_MAX_MSGS;
+    }
+}
+
+// Returns the oldest unread message from the given source, any if negative
+static msg_t *read_msg(int32_t source)
+{
+    for (uint16_t i = msg_tail; i != msg_head; i = (i + 1) % LUOS_HOST_MAX_MSGS)
+    {
+        if (!msg_read[i] && ((source < 0) || (msgs[i].header.source == source)))
+        {
+            msg_read[i] = true;
+            nb_msgs--;
+            drop_read_msgs();
+            return &msgs[i];
+        }
+    }
+    return NULL;
+}
+
+error_return_t Luos_ReadMsg(container_t *container, msg_t **returned_msg)
+{
+    *returned_msg = read_msg(-1);
+    return (*returned_msg != NULL) ? SUCCEED : FAILED;
+}
+
+error_return_t Luos_ReadFromContainer(container_t *container, short id, msg_t **returned_msg)
+{
+    *returned_msg = read_msg(id);
+    return (*returned_msg != NULL) ? SUCCEED : FAILED;
+}
+
+uint16_t Luos_NbrAvailableMsg(void)
+{
+    return nb_msgs;
+}
+
+error_return_t Luos_SendMsg(container_t *container, msg_t *msg)
+{
+    return SUCCEED;
+}
+
+error_return_t Luos_SendData(container_t *container, msg_t *msg, void *bin_data, uint16_t size)
+{
+    last_data_size = (size > LUOS_HOST_MAX_DATA) ? LUOS_HOST_MAX_DATA : size;
+    memcpy(last_data, bin_data, last_data_size);
+    return SUCCEED;
+}
+
+error_return_t Luos_TxComplete(void)
+{
+    return SUCCEED;
+}
+
+uint32_t Luos_GetSystick(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000 + now.tv_nsec / 1000000);
+}
+
+void Luos_Flush(void)
+{
+}
+
+void Luos_Loop(void)
+{
+}
+
+void Luos_SendBaudrate(container_t *container, uint32_t baudrate)
+{
+}
+
+routing_table_t *RoutingTB_Get(void)
+{
+    return routing_table;
+}
+
+uint16_t RoutingTB_GetLastEntry(void)
+{
+    return nb_entries;
+}
+
+uint16_t RoutingTB_GetLastContainer(void)
+{
+    return last_container;
+}
+
+void RoutingTB_DetectContainers(container_t *container)
+{
+}
+
+// Linear lookup, as done by Luos
+static routing_table_t *find_container(uint16_t id)
+{
+    for (uint16_t i = 0; i < nb_entries; i++)
+    {
+        if ((routing_table[i].mode == CONTAINER) && (routing_table[i].id == id))
+        {
+            return &routing_table[i];
+        }
+    }
+    return NULL;
+}
+
+char *RoutingTB_StringFromType(uint8_t type)
+{
+    static const char *TYPE_NAMES[LUOS_LAST_TYPE] = {
+        "Void", "Gate", "State", "Color", "Angle", "DistanceSensor", "DynamixelMotor",
+        "Imu", "LightSensor", "DCMotor", "Servo", "Voltage"};
+    return (char *)((type < LUOS_LAST_TYPE) ? TYPE_NAMES[type] : "Unknown");
+}
+
+char *RoutingTB_AliasFromId(uint16_t id)
+{
+    routing_table_t *entry = find_container(id);
+    return (entry != NULL) ? entry->alias : NULL;
+}
+
+uint16_t RoutingTB_IDFromAlias(char *alias)
+{
+    for (uint16_t i = 0; i < nb_entries; i++)
+    {
+        if ((routing_table[i].mode == CONTAINER) && (strcmp(routing_table[i].alias, alias) == 0))
+        {
+            return routing_table[i].id;
+        }
+    }
+    return 0xFFFF;
+}
+
+uint8_t RoutingTB_TypeFromID(uint16_t id)
+{
+    routing_table_t *entry = find_container(id);
+    return (entry != NULL) ? entry->type : VOID_MOD;
+}
+
+bool RoutingTB_ContainerIsSensor(uint8_t type)
+{
+    return (type == STATE_MOD) || (type == ANGLE_MOD) || (type == DISTANCE_MOD) ||
+           (type == IMU_MOD) || (type == LIGHT_MOD) || (type == VOLTAGE_MOD);
+}
+
+void RoutingTB_RemoveOnRoutingTable(uint16_t id)
+{
+}
+
+float AngularOD_PositionFrom_deg(float deg)
+{
+    return deg;
+}
+
+float AngularOD_SpeedFrom_deg_s(float deg_s)
+{
+    return deg_s;
+}
+
+float LinearOD_PositionFrom_mm(float mm)
+{
+    return mm / 1000.0f;
+}
+
+float LinearOD_Speedfrom_mm_s(float mm_s)
+{
+    return mm_s / 1000.0f;
+}
+
+float TimeOD_TimeFrom_s(float s)
+{
+    return s;
+}
+
+uint16_t crc16_compute(uint8_t const *p_data, uint32_t size, uint16_t const *p_crc)
+{
+    // CRC-16/CCITT, as computed by the nRF5 SDK
+    uint16_t crc = (p_crc == NULL) ? 0xFFFF : *p_crc;
+    for (uint32_t i = 0; i < size; i++)
+    {
+        crc = (uint8_t)(crc >> 8) | (crc << 8);
+        crc ^= p_data[i];
+        crc ^= (uint8_t)(crc & 0xFF) >> 4;
+        crc ^= (crc << 8) << 4;
+        crc ^= ((crc & 0xFF) << 4) << 1;
+    }
+    return crc;
+}
+
+void uart_write(const uint8_t *data, uint32_t length)
+{
+    sent_bytes += length;
+}
+
+void json_send(char *json)
+{
+    sent_bytes += strlen(json);
+    snprintf(last_json, sizeof(last_json), "%s", json);
+}
+
+void Gate_SendRoutingTable(bool diff)
+{
+    // Same size as the largest Gate scratch buffer
+    static char json[GATE_JSON_ARENA_SIZE / 2];
+    json_writer_t writer;
+    json_writer_init(&writer, json, sizeof(json));
+    bool complete = diff ? routing_table_diff_to_json(&writer) : routing_table_to_json(&writer);
+    if (!complete)
+    {
+        snprintf(json, sizeof(json), "{\"routing_table_overflow\":%u}\n", nb_entries);
+    }
+    json_send(json);
+}
+
+void bsp_board_leds_on(void)
+{
+}
@@ -0,0 +1,111 @@
+/* Reception ring test: commands received while older ones wait for
+** send_cmds around the end of the ring, and binary data holding the
+** characters that end or start a JSON command.
+*/
+#include <stdio.h>
+#include <string.h>
+#include "cmd.h"
+#include "luos_host.h"
+
+// Size of the commands of the wrap test, '\r' included.
+#define HANDLED_CMD_SIZE 4090
+#define LONG_CMD_SIZE 3900
+#define OVERFLOWING_CMD_SIZE 300
+
+static int nb_failures = 0;
+
+static void check(bool condition, const char *description)
+{
+    if (!condition)
+    {
+        printf("FAILED: %s\n", description);
+        nb_failures++;
+    }
+}
+
+// Feeds a detection command of the given size, padded with spaces, '\r' included
+static void feed_detection(uint32_t size)
+{
+    static char cmd[GATE_CMD_RING_SIZE];
+    const char *json = "{\"detection\":{}";
+    uint32_t length = strlen(json);
+    memcpy(cmd, json, length);
+    memset(cmd + length, ' ', size - length - 2);
+    cmd[size - 2] = '}';
+    cmd[size - 1] = '\r';
+    cmd_receive((const uint8_t *)cmd, size);
+}
+
+// Commands left unhandled at the beginning of the ring shall not be overwritten by the next wrap
+static void test_wrap(container_t *gate)
+{
+    feed_detection(HANDLED_CMD_SIZE);
+    send_cmds(gate);
+    detection_ask = 0;
+
+    // Wraps to the beginning of the ring, then fills it up to its end
+    feed_detection(strlen("{\"detection\":{}}\r"));
+    feed_detection(LONG_CMD_SIZE);
+    // Does not fit before the unhandled commands
+    feed_detection(OVERFLOWING_CMD_SIZE);
+    send_cmds(gate);
+
+    check(detection_ask == 2, "both unhandled detections are kept");
+    check(strcmp(luos_host_last_json(), "{\"overflow\":1}\n") == 0, "the dropped command is reported");
+    check(!cmds_pending(), "no command left");
+    detection_ask = 0;
+}
+
+// Binary data is framed by its announced size, whatever bytes it holds
+static void test_binary(container_t *gate)
+{
+    const char json[] = "{\"containers\":{\"sensor1\":{\"target_rot_position\":[6]}}}\r";
+    const uint8_t data[] = {'\r', '{', '\r', '}', '{', '\r'};
+    cmd_receive((const uint8_t *)json, strlen(json));
+    cmd_receive(data, sizeof(data));
+    feed_detection(strlen("{\"detection\":{}}\r"));
+    send_cmds(gate);
+
+    uint16_t size = 0;
+    const uint8_t *sent = luos_host_last_data(&size);
+    check((size == sizeof(data)) && (memcmp(sent, data, sizeof(data)) == 0), "the binary data is sent whole");
+    check(detection_ask == 1, "the following command is handled");
+    check(!cmds_pending(), "no command left");
+    detection_ask = 0;
+}
+
+// Only single size arrays under a binary key announce binary data, whitespace and strings aside
+static void test_binary_scan(container_t *gate)
+{
+    // Spaced announcement, after a string holding escaped quotes and brackets
+    const char json[] = "{\"containers\":{\"sensor1\":{\"rename\":\"a\\\":[9]\",\"target_rot_position\" : [ 4 ]}}}\r";
+    const uint8_t data[] = {'}', '\r', '{', '\r'};
+    cmd_receive((const uint8_t *)json, strlen(json));
+    cmd_receive(data, sizeof(data));
+    // A key which does not accept binary data announces nothing
+    const char ratio[] = "{\"containers\":{\"sensor1\":{\"power_ratio\":[3]}}}\r";
+    cmd_receive((const uint8_t *)ratio, strlen(ratio));
+    feed_detection(strlen("{\"detection\":{}}\r"));
+    send_cmds(gate);
+
+    check(detection_ask == 1, "commands after the binary data are handled");
+    check(!cmds_pending(), "no command left");
+    detection_ask = 0;
+}
+
+int main(void)
+{
+    luos_host_build_network(4, 2);
+    container_t *gate = luos_host_gate();
+
+    test_wrap(gate);
+    test_binary(gate);
+    test_binary_scan(gate);
+
+    if (nb_failures > 0)
+    {
+        return 1;
+    }
+    printf("OK\n");
+    return 0;
+}
@@ -1,9 +1,11 @@
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
 #include "json_mnger.h"
 #include "cmd.h"
 #include "convert.h"
 #include "gate.h"
+#include "bin_protocol.h"
 
 #include "app_luos_list.h"      // LUOS_MESH_BRIDGE
 
@@ -28,117 +30,749 @@ static uint16_t find_gate_container_id(const routing_table_t* rtb,
                                        uint16_t nb_entries);
 #endif /* LUOS_MESH_BRIDGE */
 
+// Sends received messages as binary telemetry frames.
+static void format_data_binary(container_t *container);
+
+//******************* container cache ****************************
+// Alias and type of each container, resolved once at detection instead of looked up in the routing table for each message
+static struct
+{
+    char *alias[GATE_MAX_CONTAINERS + 1];
+    uint8_t type[GATE_MAX_CONTAINERS + 1];
+} cache;
+
+// Resolves the alias and type of each container, IDs may change with a new detection
+void container_cache_build(void)
+{
+    memset(&cache, 0, sizeof(cache));
+    uint16_t last_id = RoutingTB_GetLastContainer();
+    if (last_id > GATE_MAX_CONTAINERS)
+    {
+        last_id = GATE_MAX_CONTAINERS;
+    }
+    for (uint16_t id = 1; id <= last_id; id++)
+    {
+        cache.alias[id] = RoutingTB_AliasFromId(id);
+        cache.type[id] = RoutingTB_TypeFromID(id);
+    }
+}
+
+// Returns the alias of the given container, or 0 if unknown
+static char *container_alias(uint16_t id)
+{
+    if ((id <= GATE_MAX_CONTAINERS) && (cache.alias[id] != 0))
+    {
+        return cache.alias[id];
+    }
+    // Not cached: out of the cache or received before its detection
+    return RoutingTB_AliasFromId(id);
+}
+
 //******************* sensor update ****************************
-// This function will gather data from sensors and create a json string for you
-void collect_data(container_t *container)
+// Data collection state, requests are pipelined instead of sent one by one
+static struct
 {
+    // Refresh period of containers without their own one
+    uint32_t default_period_ms;
+    // Refresh period of each container, 0 for the default one
+    uint32_t period_ms[GATE_MAX_CONTAINERS + 1];
+    // Containers pushing their changed values by themselves, never asked
+    bool subscribed[GATE_MAX_CONTAINERS + 1];
+    // Subscription requested to each container, renewed as Mesh Bridges drop them with their tables
+    uint16_t subscription_ms[GATE_MAX_CONTAINERS + 1];
+    float subscription_deadband[GATE_MAX_CONTAINERS + 1];
+    // Time at which each subscription shall be renewed, and given up if not acknowledged again
+    uint32_t renew_due[GATE_MAX_CONTAINERS + 1];
+    uint32_t lease_end[GATE_MAX_CONTAINERS + 1];
+    // Time at which each container shall be asked again
+    uint32_t next_due[GATE_MAX_CONTAINERS + 1];
+    // Container from which due ones are searched, so that all get their turn
+    uint16_t cursor;
+    // Containers beyond GATE_MAX_CONTAINERS are asked in turn with the default period
+    uint16_t overflow_cursor;
+    uint32_t overflow_next_due;
+    // Requests waiting for their reply
+    struct
+    {
+        uint16_t id;
+        uint32_t deadline;
+    } pending[GATE_COLLECT_MAX_PENDING];
+    uint8_t nb_pending;
+} collect = {.default_period_ms = GATE_REFRESH_RATE_MS};
+
+// Frees the pending request of the given container, if any
+static void collect_data_received(uint16_t id);
+
+// Returns true if the data of the given container is collected by the Gate
+static bool collect_is_collected(uint16_t id);
+
+// Returns true if the given container has a pending request
+static bool collect_data_is_pending(uint16_t id);
+
+// Asks containers beyond GATE_MAX_CONTAINERS to publish their data
+static void collect_data_poll_overflow(container_t *container, msg_t *msg, uint32_t now);
+
+#ifdef LUOS_MESH_BRIDGE
+// Renews due subscriptions, and asks again containers whose subscription was not acknowledged
+static void collect_renew_subscriptions(container_t *container, uint16_t last_id, uint32_t now);
+#endif /* LUOS_MESH_BRIDGE */
+
+// Sends data requests to due containers while less than GATE_COLLECT_MAX_PENDING wait for their reply
+void collect_data_poll(container_t *container)
+{
+    uint32_t now = Luos_GetSystick();
+    // Skip containers which missed their deadline
+    uint8_t i = 0;
+    while (i < collect.nb_pending)
+    {
+        if ((int32_t)(now - collect.pending[i].deadline) >= 0)
+        {
+            collect.pending[i] = collect.pending[--collect.nb_pending];
+        }
+        else
+        {
+            i++;
+        }
+    }
     msg_t json_msg;
     json_msg.header.target_mode = ID;
     json_msg.header.cmd = ASK_PUB_CMD;
     json_msg.header.size = 0;
-    // ask containers to publish datas
-    for (uint8_t i = 1; i <= RoutingTB_GetLastContainer(); i++)
+    // Containers beyond GATE_MAX_CONTAINERS have no state of their own
+    uint16_t last_id = RoutingTB_GetLastContainer();
+    if (last_id > GATE_MAX_CONTAINERS)
     {
+        collect_data_poll_overflow(container, &json_msg, now);
+        last_id = GATE_MAX_CONTAINERS;
+    }
+#ifdef LUOS_MESH_BRIDGE
+    collect_renew_subscriptions(container, last_id, now);
+#endif /* LUOS_MESH_BRIDGE */
+    // ask due containers to publish datas, all due ones are batched in the same pass
+    for (uint16_t n = 0; (n < last_id) && (collect.nb_pending < GATE_COLLECT_MAX_PENDING); n++)
+    {
+        uint16_t id = (uint16_t)((collect.cursor + n) % last_id) + 1;
+        if (((int32_t)(now - collect.next_due[id]) < 0) || collect.subscribed[id] || collect_data_is_pending(id))
+        {
+            continue;
+        }
         // Check if this container is a sensor
-        if ((RoutingTB_ContainerIsSensor(RoutingTB_TypeFromID(i))) || (RoutingTB_TypeFromID(i) >= LUOS_LAST_TYPE))
+        if (collect_is_collected(id))
         {
             // This container is a sensor so create a msg and send it
-            json_msg.header.target = i;
+            json_msg.header.target = id;
             Luos_SendMsg(container, &json_msg);
-#ifdef GATE_TIMEOUT
-            // Get the current number of message available
-            int back_nbr_msg = Luos_NbrAvailableMsg();
-            // Get the current time
-            uint32_t send_time = Luos_GetSystick();
-            // Wait for a reply before continuing
-            while ((back_nbr_msg == Luos_NbrAvailableMsg()) & (send_time == Luos_GetSystick()))
+            collect.pending[collect.nb_pending].id = id;
+            collect.pending[collect.nb_pending].deadline = now + GATE_COLLECT_TIMEOUT_MS;
+            collect.nb_pending++;
+        }
+        uint32_t period = collect.period_ms[id] ? collect.period_ms[id] : collect.default_period_ms;
+        collect.next_due[id] += period;
+        if ((int32_t)(now - collect.next_due[id]) >= 0)
+        {
+            // Late, do not try to catch up
+            collect.next_due[id] = now + period;
+        }
+        collect.cursor = id % last_id;
+    }
+}
+
+static void collect_data_poll_overflow(container_t *container, msg_t *msg, uint32_t now)
+{
+    uint16_t last_id = RoutingTB_GetLastContainer();
+    if ((int32_t)(now - collect.overflow_next_due) < 0)
+    {
+        return;
+    }
+    if (collect.overflow_cursor <= GATE_MAX_CONTAINERS)
+    {
+        collect.overflow_cursor = GATE_MAX_CONTAINERS + 1;
+    }
+    // Go on with the current round while requests can be sent
+    while ((collect.overflow_cursor <= last_id) && (collect.nb_pending < GATE_COLLECT_MAX_PENDING))
+    {
+        uint16_t id = collect.overflow_cursor++;
+        if (collect_is_collected(id) && !collect_data_is_pending(id))
+        {
+            msg->header.target = id;
+            Luos_SendMsg(container, msg);
+            collect.pending[collect.nb_pending].id = id;
+            collect.pending[collect.nb_pending].deadline = now + GATE_COLLECT_TIMEOUT_MS;
+            collect.nb_pending++;
+        }
+    }
+    if (collect.overflow_cursor > last_id)
+    {
+        // Round done, start the next one after the default period
+        collect.overflow_cursor = GATE_MAX_CONTAINERS + 1;
+        collect.overflow_next_due = now + collect.default_period_ms;
+    }
+}
+
+#ifdef LUOS_MESH_BRIDGE
+static void collect_renew_subscriptions(container_t *container, uint16_t last_id, uint32_t now)
+{
+    for (uint16_t id = 1; id <= last_id; id++)
+    {
+        if (!collect.subscribed[id])
+        {
+            continue;
+        }
+        if ((int32_t)(now - collect.lease_end[id]) >= 0)
+        {
+            // Lost subscription, ask again until the next acknowledgment
+            collect.subscribed[id] = false;
+            collect.next_due[id] = now;
+        }
+        else if ((collect.subscription_ms[id] != 0) && ((int32_t)(now - collect.renew_due[id]) >= 0))
+        {
+            mesh_bridge_subscription_t subscription = {.period_ms = collect.subscription_ms[id],
+                                                       .deadband = collect.subscription_deadband[id]};
+            msg_t msg;
+            msg.header.target_mode = ID;
+            msg.header.target = id;
+            msg.header.cmd = MESH_BRIDGE_SUBSCRIBE;
+            msg.header.size = sizeof(mesh_bridge_subscription_t);
+            memcpy(msg.data, &subscription, sizeof(mesh_bridge_subscription_t));
+            Luos_SendMsg(container, &msg);
+            collect.renew_due[id] = now + GATE_SUBSCRIPTION_RENEW_MS;
+        }
+    }
+}
+#endif /* LUOS_MESH_BRIDGE */
+
+void collect_set_refresh_period(uint16_t id, uint32_t period_ms)
+{
+    if ((id == 0) || (id > GATE_MAX_CONTAINERS))
+    {
+        return;
+    }
+    collect.period_ms[id] = period_ms;
+    // Apply the new period from now on
+    collect.next_due[id] = Luos_GetSystick();
+}
+
+void collect_set_subscribed(uint16_t id, bool subscribed)
+{
+    if ((id == 0) || (id > GATE_MAX_CONTAINERS))
+    {
+        return;
+    }
+    uint32_t now = Luos_GetSystick();
+    collect.subscribed[id] = subscribed;
+    // Ask again from now on if unsubscribed
+    collect.next_due[id] = now;
+    // Each acknowledgment extends the subscription for two renewals
+    collect.renew_due[id] = now + GATE_SUBSCRIPTION_RENEW_MS;
+    collect.lease_end[id] = now + 2 * GATE_SUBSCRIPTION_RENEW_MS;
+}
+
+void collect_set_subscription(uint16_t id, uint16_t period_ms, float deadband)
+{
+    if ((id == 0) || (id > GATE_MAX_CONTAINERS))
+    {
+        return;
+    }
+    collect.subscription_ms[id] = period_ms;
+    collect.subscription_deadband[id] = deadband;
+}
+
+void collect_set_default_refresh_period(uint32_t period_ms)
+{
+    if (period_ms > 0)
+    {
+        collect.default_period_ms = period_ms;
+    }
+}
+
+// Forgets container periods and requests, IDs may change with a new detection
+void collect_data_reset(void)
+{
+    memset(collect.period_ms, 0, sizeof(collect.period_ms));
+    memset(collect.next_due, 0, sizeof(collect.next_due));
+    memset(collect.subscribed, 0, sizeof(collect.subscribed));
+    // Mesh Bridges drop their subscriptions on detection
+    memset(collect.subscription_ms, 0, sizeof(collect.subscription_ms));
+    collect.cursor = 0;
+    collect.overflow_cursor = GATE_MAX_CONTAINERS + 1;
+    collect.overflow_next_due = Luos_GetSystick();
+    collect.nb_pending = 0;
+}
+
+static bool collect_is_collected(uint16_t id)
+{
+    uint8_t type = (id <= GATE_MAX_CONTAINERS) ? cache.type[id] : RoutingTB_TypeFromID(id);
+    return RoutingTB_ContainerIsSensor(type) || (type >= LUOS_LAST_TYPE);
+}
+
+static bool collect_data_is_pending(uint16_t id)
+{
+    for (uint8_t i = 0; i < collect.nb_pending; i++)
+    {
+        if (collect.pending[i].id == id)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void collect_data_received(uint16_t id)
+{
+    for (uint8_t i = 0; i < collect.nb_pending; i++)
+    {
+        if (collect.pending[i].id == id)
+        {
+            collect.pending[i] = collect.pending[--collect.nb_pending];
+            return;
+        }
+    }
+}
+
+//******************* delta encoding ****************************
+// Last value sent for a field of a container
+typedef struct
+{
+    uint16_t id;
+    uint8_t cmd;
+    uint8_t size;
+    uint8_t data[GATE_DELTA_MAX_VALUE_SIZE];
+} delta_value_t;
+
+// Size of a kept field whose value was never sent
+#define DELTA_NOT_SENT 0xFF
+_Static_assert(GATE_DELTA_MAX_VALUE_SIZE < DELTA_NOT_SENT, "Kept values shall be smaller than the not sent marker!");
+
+// Delta encoding state, unchanged fields are only sent in keyframes
+static struct
+{
+    bool enabled;
+    uint32_t keyframe_ms;
+    uint32_t next_keyframe;
+    // Containers whose whole field set is still owed by the current keyframe round, and their number
+    bool keyframe[GATE_MAX_CONTAINERS + 1];
+    uint16_t nb_keyframes;
+    // Containers whose data was written by the current pass
+    bool formatted[GATE_MAX_CONTAINERS + 1];
+    // Fields whose float values are only sent once they changed by more than their deadband
+    struct
+    {
+        uint8_t cmd;
+        float deadband;
+    } deadbands[GATE_DELTA_MAX_DEADBANDS];
+    uint8_t nb_deadbands;
+    delta_value_t values[GATE_DELTA_MAX_VALUES];
+    uint16_t nb_values;
+} delta = {.keyframe_ms = GATE_DELTA_KEYFRAME_MS};
+
+void delta_enable(bool enable)
+{
+    delta.enabled = enable;
+    // Start with a keyframe
+    delta_reset();
+}
+
+// Forgets sent values, IDs may change with a new detection
+void delta_reset(void)
+{
+    delta.nb_values = 0;
+    delta.next_keyframe = Luos_GetSystick();
+    memset(delta.keyframe, 0, sizeof(delta.keyframe));
+    delta.nb_keyframes = 0;
+}
+
+void delta_set_keyframe_period(uint32_t period_ms)
+{
+    if (period_ms > 0)
+    {
+        delta.keyframe_ms = period_ms;
+        delta.next_keyframe = Luos_GetSystick();
+    }
+}
+
+// Returns false if no deadband is left for this field
+bool delta_set_deadband(uint8_t cmd, float deadband)
+{
+    for (uint8_t i = 0; i < delta.nb_deadbands; i++)
+    {
+        if (delta.deadbands[i].cmd == cmd)
+        {
+            delta.deadbands[i].deadband = deadband;
+            return true;
+        }
+    }
+    if (delta.nb_deadbands >= GATE_DELTA_MAX_DEADBANDS)
+    {
+        return false;
+    }
+    delta.deadbands[delta.nb_deadbands].cmd = cmd;
+    delta.deadbands[delta.nb_deadbands].deadband = deadband;
+    delta.nb_deadbands++;
+    return true;
+}
+
+// Starts a pass reading messages, and a keyframe round if one is due
+static void delta_start_pass(void)
+{
+    memset(delta.formatted, 0, sizeof(delta.formatted));
+    uint32_t now = Luos_GetSystick();
+    if ((int32_t)(now - delta.next_keyframe) < 0)
+    {
+        return;
+    }
+    delta.next_keyframe = now + delta.keyframe_ms;
+    // Every collected container owes its whole field set, whichever pass reads its data
+    uint16_t last_id = RoutingTB_GetLastContainer();
+    if (last_id > GATE_MAX_CONTAINERS)
+    {
+        last_id = GATE_MAX_CONTAINERS;
+    }
+    delta.nb_keyframes = 0;
+    for (uint16_t id = 1; id <= GATE_MAX_CONTAINERS; id++)
+    {
+        delta.keyframe[id] = (id <= last_id) && collect_is_collected(id);
+        delta.nb_keyframes += delta.keyframe[id];
+    }
+}
+
+// Marks the given container as written by the current pass
+static void delta_formatted(uint16_t id)
+{
+    if ((id > 0) && (id <= GATE_MAX_CONTAINERS))
+    {
+        delta.formatted[id] = true;
+    }
+}
+
+// Ends the keyframe of the containers written by the current pass
+static void delta_end_pass(void)
+{
+    for (uint16_t id = 1; (id <= GATE_MAX_CONTAINERS) && (delta.nb_keyframes > 0); id++)
+    {
+        if (delta.formatted[id] && delta.keyframe[id])
+        {
+            delta.keyframe[id] = false;
+            delta.nb_keyframes--;
+        }
+    }
+}
+
+// Returns true if the whole field set of the given container is sent
+static bool delta_is_keyframe(uint16_t id)
+{
+    if ((id > 0) && (id <= GATE_MAX_CONTAINERS))
+    {
+        return delta.keyframe[id];
+    }
+    // Out of the table: sent whole for the whole round
+    return delta.nb_keyframes > 0;
+}
+
+// Returns true if the given float values differ by more than the deadband of their field
+static bool delta_value_changed(const delta_value_t *sent, const msg_t *msg)
+{
+    if (sent->size != msg->header.size)
+    {
+        return true;
+    }
+    float deadband = 0.0f;
+    for (uint8_t i = 0; i < delta.nb_deadbands; i++)
+    {
+        if (delta.deadbands[i].cmd == msg->header.cmd)
+        {
+            deadband = delta.deadbands[i].deadband;
+            break;
+        }
+    }
+    if ((deadband <= 0.0f) || ((sent->size % sizeof(float)) != 0))
+    {
+        // Any change, or not a float value
+        return memcmp(sent->data, msg->data, sent->size) != 0;
+    }
+    for (uint8_t offset = 0; offset < sent->size; offset += sizeof(float))
+    {
+        float sent_value;
+        float new_value;
+        memcpy(&sent_value, &sent->data[offset], sizeof(float));
+        memcpy(&new_value, &msg->data[offset], sizeof(float));
+        float change = new_value - sent_value;
+        if ((change > deadband) || (change < -deadband))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns true if the given message shall be sent, with the slot keeping its last sent value or -1
+static bool delta_filter(const msg_t *msg, int16_t *slot)
+{
+    *slot = -1;
+    if (!delta.enabled || (msg->header.size > GATE_DELTA_MAX_VALUE_SIZE))
+    {
+        return true;
+    }
+    delta_value_t *sent = NULL;
+    for (uint16_t i = 0; i < delta.nb_values; i++)
+    {
+        if ((delta.values[i].id == msg->header.source) && (delta.values[i].cmd == msg->header.cmd))
+        {
+            sent = &delta.values[i];
+            break;
+        }
+    }
+    if (sent == NULL)
+    {
+        if (delta.nb_values >= GATE_DELTA_MAX_VALUES)
+        {
+            // Value cannot be kept: always send it
+            return true;
+        }
+        sent = &delta.values[delta.nb_values++];
+        sent->id = msg->header.source;
+        sent->cmd = msg->header.cmd;
+        sent->size = DELTA_NOT_SENT;
+    }
+    else if (!delta_is_keyframe(msg->header.source) && !delta_value_changed(sent, msg))
+    {
+        return false;
+    }
+    *slot = (int16_t)(sent - delta.values);
+    return true;
+}
+
+// Keeps the given value as the last sent one of its slot, once actually written
+static void delta_commit(int16_t slot, const uint8_t *data, uint8_t size)
+{
+    if (slot < 0)
+    {
+        return;
+    }
+    // Kept on each send, so that slow drifts are sent once large enough
+    delta.values[slot].size = size;
+    memcpy(delta.values[slot].data, data, size);
+}
+
+//******************* refresh staging ****************************
+_Static_assert(GATE_STAGE_MAX_FIELDS <= UINT8_MAX, "Staged fields shall be indexed by a byte!");
+_Static_assert(GATE_STAGE_SIZE >= 2 * GATE_STAGE_FIELD_SIZE, "Staging buffer shall hold several fields!");
+
+// No staged field or container
+#define STAGE_NONE 0xFF
+
+// Formatted field of a container, staged until its container section is written
+typedef struct
+{
+    uint16_t start;
+    uint16_t length;
+    // Next field of the same container
+    uint8_t next;
+    // Value kept as the last sent one once the field is written, in delta mode
+    int16_t delta_slot;
+    uint8_t delta_size;
+    uint8_t delta_data[GATE_DELTA_MAX_VALUE_SIZE];
+} stage_field_t;
+
+// Fields read in a single pass over the received messages, grouped by container
+static struct
+{
+    char text[GATE_STAGE_SIZE];
+    json_writer_t writer;
+    stage_field_t fields[GATE_STAGE_MAX_FIELDS];
+    uint8_t nb_fields;
+    // Containers in the order of their first field
+    struct
+    {
+        uint16_t id;
+        char *alias;
+        uint8_t first;
+        uint8_t last;
+    } containers[GATE_STAGE_MAX_FIELDS];
+    uint8_t nb_containers;
+    // Staged container of each cached ID, STAGE_NONE if none
+    uint8_t slot[GATE_MAX_CONTAINERS + 1];
+} stage;
+
+// Returns the staged container of the given ID, adding it if needed
+static uint8_t stage_container(uint16_t id, char *alias)
+{
+    if ((id <= GATE_MAX_CONTAINERS) && (stage.slot[id] != STAGE_NONE))
+    {
+        return stage.slot[id];
+    }
+    if (id > GATE_MAX_CONTAINERS)
+    {
+        // Not cached: rare, search the staged ones
+        for (uint8_t i = 0; i < stage.nb_containers; i++)
+        {
+            if (stage.containers[i].id == id)
             {
-                Luos_Loop();
+                return i;
             }
-#endif
         }
     }
+    uint8_t slot = stage.nb_containers++;
+    stage.containers[slot].id = id;
+    stage.containers[slot].alias = alias;
+    stage.containers[slot].first = STAGE_NONE;
+    stage.containers[slot].last = STAGE_NONE;
+    if (id <= GATE_MAX_CONTAINERS)
+    {
+        stage.slot[id] = slot;
+    }
+    return slot;
+}
+
+// Formats the given message as a field of its container, returns false if it does not fit
+static bool stage_msg(msg_t *msg, char *alias, int16_t delta_slot)
+{
+    uint32_t start = stage.writer.length;
+    msg_to_json(msg, &stage.writer);
+    if (stage.writer.overflow)
+    {
+        json_writer_rewind(&stage.writer, start);
+        return false;
+    }
+    if (stage.writer.length == start)
+    {
+        // Not converted
+        return true;
+    }
+    uint8_t field = stage.nb_fields++;
+    stage.fields[field].start = (uint16_t)start;
+    stage.fields[field].length = (uint16_t)(stage.writer.length - start);
+    stage.fields[field].next = STAGE_NONE;
+    stage.fields[field].delta_slot = delta_slot;
+    if (delta_slot >= 0)
+    {
+        stage.fields[field].delta_size = (uint8_t)msg->header.size;
+        memcpy(stage.fields[field].delta_data, msg->data, msg->header.size);
+    }
+    uint8_t slot = stage_container(msg->header.source, alias);
+    if (stage.containers[slot].first == STAGE_NONE)
+    {
+        stage.containers[slot].first = field;
+    }
+    else
+    {
+        stage.fields[stage.containers[slot].last].next = field;
+    }
+    stage.containers[slot].last = field;
+    return true;
 }
 
 // This function will create a json string for containers datas
-void format_data(container_t *container, char *json)
+void format_data(container_t *container, json_writer_t *json)
 {
     msg_t *json_msg = 0;
     uint8_t json_ok = false;
-    if ((Luos_NbrAvailableMsg() > 0))
+    bool data_lost = false;
+    json_writer_rewind(json, 0);
+    if (Luos_NbrAvailableMsg() == 0)
     {
-        // loop into containers.
-        uint16_t i = 1;
-        // get the oldest message
-        while (Luos_ReadMsg(container, &json_msg) == SUCCEED)
+        return;
+    }
+    // Keyframes are only decided by passes reading messages
+    delta_start_pass();
+    if (bin_protocol_is_enabled())
+    {
+        // Nothing is left for the JSON
+        format_data_binary(container);
+        delta_end_pass();
+        return;
+    }
+    // Single pass over the received messages, staging the fields of each container
+    json_writer_init(&stage.writer, stage.text, GATE_STAGE_SIZE);
+    stage.nb_fields = 0;
+    stage.nb_containers = 0;
+    memset(stage.slot, STAGE_NONE, sizeof(stage.slot));
+    // Remaining messages are read by the next refresh, so that none is lost
+    while ((stage.nb_fields < GATE_STAGE_MAX_FIELDS)
+           && (stage.writer.capacity - stage.writer.length >= GATE_STAGE_FIELD_SIZE)
+           && (Luos_ReadMsg(container, &json_msg) == SUCCEED))
+    {
+        // check if this is an assert
+        if (json_msg->header.cmd == ASSERT)
         {
-            // check if this is an assert
-            if (json_msg->header.cmd == ASSERT)
-            {
-                char error_json[256] = "\0";
-                luos_assert_t assertion;
-                memcpy(assertion.unmap, json_msg->data, json_msg->header.size);
-                assertion.unmap[json_msg->header.size] = '\0';
-                sprintf(error_json, "{\"assert\":{\"node_id\":%d,\"file\":\"%s\",\"line\":%d}}\n", json_msg->header.source, assertion.file, (unsigned int)assertion.line);
-                json_send(error_json);
-                continue;
-            }
-
-            #ifdef LUOS_MESH_BRIDGE
-            bool mesh_bridge_cmd = is_mesh_bridge_cmd(container,
-                                                      json_msg);
-            if (mesh_bridge_cmd)
-            {
-                continue;
-            }
-            #endif /* LUOS_MESH_BRIDGE */
+            char error_json[256] = "\0";
+            luos_assert_t assertion;
+            memcpy(assertion.unmap, json_msg->data, json_msg->header.size);
+            assertion.unmap[json_msg->header.size] = '\0';
+            sprintf(error_json, "{\"assert\":{\"node_id\":%d,\"file\":\"%s\",\"line\":%d}}\n", json_msg->header.source, assertion.file, (unsigned int)assertion.line);
+            json_send(error_json);
+            continue;
+        }
 
-            // get the source of this message
-            i = json_msg->header.source;
-            // Create container description
-            char *alias;
-            alias = RoutingTB_AliasFromId(i);
+        #ifdef LUOS_MESH_BRIDGE
+        bool mesh_bridge_cmd = is_mesh_bridge_cmd(container,
+                                                  json_msg);
+        if (mesh_bridge_cmd)
+        {
+            continue;
+        }
+        #endif /* LUOS_MESH_BRIDGE */
 
-            if (alias != 0)
-            {
-                json_ok = true;
-                sprintf(json, "%s{\"%s\":{", json, alias);
-                // now add json data from container
-                msg_to_json(json_msg, &json[strlen(json)]);
-                // Check if we receive other messages from this container
-                while (Luos_ReadFromContainer(container, i, &json_msg) == SUCCEED)
-                {
-                    // we receive some, add it to the Json
-                    msg_to_json(json_msg, &json[strlen(json)]);
-                }
-                if (json[strlen(json) - 1] != '{')
-                {
-                    // remove the last "," char
-                    json[strlen(json) - 1] = '\0';
-                }
-                // End the container section
-                sprintf(json, "%s},", json);
-            }
+        collect_data_received(json_msg->header.source);
+        char *alias = container_alias(json_msg->header.source);
+        // only changed fields in delta mode
+        int16_t delta_slot;
+        if ((alias != 0) && delta_filter(json_msg, &delta_slot) && !stage_msg(json_msg, alias, delta_slot))
+        {
+            data_lost = true;
         }
-        if (json_ok)
+    }
+    // Keep room to close the container section
+    json_writer_reserve(json, sizeof("}") - 1);
+    // Write each container section once
+    for (uint8_t slot = 0; slot < stage.nb_containers; slot++)
+    {
+        // Start of the container section, to drop it if it does not fit
+        uint32_t section_start = json->length;
+        json_writer_append(json, "{\"");
+        json_writer_append(json, stage.containers[slot].alias);
+        json_writer_append(json, "\":{");
+        for (uint8_t field = stage.containers[slot].first; field != STAGE_NONE; field = stage.fields[field].next)
         {
-            // remove the last "," char
-            json[strlen(json) - 1] = '\0';
-
-            // Close the container section
-            sprintf(json, "%s}", json);
+            json_writer_write(json, &stage.text[stage.fields[field].start], stage.fields[field].length);
+        }
+        // remove the last "," char
+        json_writer_trim(json, ',');
+        // End the container section
+        json_writer_append(json, "},");
+        if (json->overflow)
+        {
+            // Data of this container is lost, keep the previous ones
+            json_writer_rewind(json, section_start);
+            data_lost = true;
         }
         else
         {
-            //create a void string
-            *json = '\0';
+            json_ok = true;
+            // Sent values are only kept once written
+            for (uint8_t field = stage.containers[slot].first; field != STAGE_NONE; field = stage.fields[field].next)
+            {
+                delta_commit(stage.fields[field].delta_slot, stage.fields[field].delta_data, stage.fields[field].delta_size);
+            }
+            delta_formatted(stage.containers[slot].id);
         }
     }
+    delta_end_pass();
+    json_writer_release(json, sizeof("}") - 1);
+    if (json_ok)
+    {
+        // remove the last "," char
+        json_writer_trim(json, ',');
+
+        // Close the container section
+        json_writer_append(json, "}");
+    }
     else
     {
         //create a void string
-        *json = '\0';
+        json_writer_rewind(json, 0);
     }
+    // Let the caller know that some data did not fit
+    json->overflow |= data_lost;
 }
 
 unsigned int get_delay(void)
@@ -151,6 +785,33 @@ void set_delay(unsigned int new_delayms)
     delayms = new_delayms;
 }
 
+static void format_data_binary(container_t *container)
+{
+    msg_t *bin_msg = 0;
+    while (Luos_ReadMsg(container, &bin_msg) == SUCCEED)
+    {
+        #ifdef LUOS_MESH_BRIDGE
+        bool mesh_bridge_cmd = is_mesh_bridge_cmd(container, bin_msg);
+        if (mesh_bridge_cmd)
+        {
+            continue;
+        }
+        #endif /* LUOS_MESH_BRIDGE */
+
+        // Assertions are also forwarded raw
+        collect_data_received(bin_msg->header.source);
+        int16_t delta_slot = -1;
+        if ((bin_msg->header.cmd == ASSERT) || delta_filter(bin_msg, &delta_slot))
+        {
+            // Telemetry frames are flushed when full, never dropped
+            bin_protocol_add_telemetry(bin_msg);
+            delta_commit(delta_slot, bin_msg->data, (uint8_t)bin_msg->header.size);
+            delta_formatted(bin_msg->header.source);
+        }
+    }
+    bin_protocol_flush_telemetry();
+}
+
 #ifdef LUOS_MESH_BRIDGE
 static bool is_mesh_bridge_cmd(container_t* container, const msg_t* msg)
 {
@@ -186,6 +847,20 @@ static bool is_mesh_bridge_cmd(container_t* container, const msg_t* msg)
     }
         break;
 
+    case MESH_BRIDGE_SUBSCRIBED:
+    {
+        // Subscribed containers push their values, stop asking them
+        uint16_t period_ms = 0;
+        memcpy(&period_ms, msg->data, sizeof(uint16_t));
+        collect_set_subscribed(msg->header.source, period_ms != 0);
+
+        #ifdef DEBUG
+        printf("Container %u subscription period: %u ms!\n",
+               msg->header.source, period_ms);
+        #endif /* DEBUG */
+    }
+        break;
+
     case MESH_BRIDGE_INTERNAL_TABLES_UPDATED:
         #ifdef DEBUG
         printf("Mesh Bridge internal tables updated!\n");
@@ -6,12 +6,102 @@
 #include "luos.h"
 #include "cmd.h"
 #include "convert.h"
+#include "json_writer.h"
 
 #define JSON_BUFF_SIZE 1024
-#define JSON_BUF_NUM 3
 
-void collect_data(container_t *container);
-void format_data(container_t *container, char *json);
+// Memory reserved for the refresh and routing table JSON, shared out at each detection
+#ifndef GATE_JSON_ARENA_SIZE
+#define GATE_JSON_ARENA_SIZE 8192
+#endif
+
+// Estimated JSON size of a routing table entry, to size buffers from the routing table
+#ifndef GATE_JSON_ENTRY_SIZE
+#define GATE_JSON_ENTRY_SIZE 128
+#endif
+
+// Largest refresh JSON sent at once, longer ones are split into several messages
+#ifndef GATE_LINK_MTU
+#define GATE_LINK_MTU 1024
+#endif
+
+// Default time in ms between two data requests to the same container
+#ifndef GATE_REFRESH_RATE_MS
+#define GATE_REFRESH_RATE_MS 2000
+#endif
+
+// Time in ms between two checks for due containers and refresh JSON sends
+#ifndef GATE_REFRESH_TICK_MS
+#define GATE_REFRESH_TICK_MS 10
+#endif
+
+// Highest container ID with its own refresh period, higher ones are asked in turn with the default one
+#ifndef GATE_MAX_CONTAINERS
+#define GATE_MAX_CONTAINERS 64
+#endif
+
+// Maximum number of data requests waiting for their reply at the same time
+#ifndef GATE_COLLECT_MAX_PENDING
+#define GATE_COLLECT_MAX_PENDING 4
+#endif
+
+// Time in ms between two renewals of a subscription, given up if none of two is acknowledged
+#ifndef GATE_SUBSCRIPTION_RENEW_MS
+#define GATE_SUBSCRIPTION_RENEW_MS 5000
+#endif
+
+// Time in ms after which a container not replying to a data request is skipped
+#ifndef GATE_COLLECT_TIMEOUT_MS
+#define GATE_COLLECT_TIMEOUT_MS 200
+#endif
+
+// Time in ms between two keyframes holding every field, in delta mode
+#ifndef GATE_DELTA_KEYFRAME_MS
+#define GATE_DELTA_KEYFRAME_MS 5000
+#endif
+
+// Number of fields whose last sent value is kept in delta mode, other ones are always sent
+#ifndef GATE_DELTA_MAX_VALUES
+#define GATE_DELTA_MAX_VALUES 128
+#endif
+
+// Maximum size of a kept field value, larger ones are always sent
+#ifndef GATE_DELTA_MAX_VALUE_SIZE
+#define GATE_DELTA_MAX_VALUE_SIZE 16
+#endif
+
+// Maximum number of fields with their own deadband
+#ifndef GATE_DELTA_MAX_DEADBANDS
+#define GATE_DELTA_MAX_DEADBANDS 8
+#endif
+
+// Size of the staging buffer holding the formatted fields of a refresh until their container section is written
+#ifndef GATE_STAGE_SIZE
+#define GATE_STAGE_SIZE 2048
+#endif
+
+// Maximum number of fields staged by a refresh, remaining messages are read by the next one
+#ifndef GATE_STAGE_MAX_FIELDS
+#define GATE_STAGE_MAX_FIELDS 64
+#endif
+
+// Largest JSON of a field, messages are only read while the staging buffer can hold it
+#ifndef GATE_STAGE_FIELD_SIZE
+#define GATE_STAGE_FIELD_SIZE 512
+#endif
+
+void container_cache_build(void);
+void collect_data_poll(container_t *container);
+void collect_data_reset(void);
+void collect_set_refresh_period(uint16_t id, uint32_t period_ms);
+void collect_set_subscribed(uint16_t id, bool subscribed);
+void collect_set_subscription(uint16_t id, uint16_t period_ms, float deadband);
+void collect_set_default_refresh_period(uint32_t period_ms);
+void delta_enable(bool enable);
+void delta_reset(void);
+void delta_set_keyframe_period(uint32_t period_ms);
+bool delta_set_deadband(uint8_t cmd, float deadband);
+void format_data(container_t *container, json_writer_t *json);
 unsigned int get_delay(void);
 void set_delay(unsigned int new_delayms);
 
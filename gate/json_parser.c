@@ -0,0 +1,505 @@
+#include "json_parser.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <float.h>          // DBL_MAX_10_EXP, DBL_MIN_10_EXP, DBL_DIG
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t, int32_t
+#include <stdlib.h>         // bsearch
+#include <string.h>         // strncmp, strlen
+
+// LUOS
+#include "luos_utils.h"     // LUOS_ASSERT
+
+/*      DEFINES                                                     */
+
+/* Largest exponent magnitude applied to a number: beyond it, any parsed
+** mantissa already overflows to infinity or underflows to zero.
+*/
+#define JSON_PARSER_MAX_EXPONENT    (DBL_MAX_10_EXP - DBL_MIN_10_EXP + DBL_DIG)
+
+/*      TYPEDEFS                                                    */
+
+// Key searched by `json_parser_lookup`.
+typedef struct
+{
+    const char* str;
+    uint16_t    length;
+
+} lookup_key_t;
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Adds a token of the given type to the parser, as a child of the given
+** parent if any. Returns its index, or JSON_PARSER_NOT_FOUND if the
+** token array is full or a key is expected but the token is not a string.
+*/
+static int32_t add_token(json_parser_t* parser, uint16_t max_tokens,
+                         json_token_type_t type, uint32_t start,
+                         int32_t parent, uint16_t* nb_children);
+
+// Returns true if the given character ends a primitive token.
+static bool is_primitive_end(char c);
+
+// Compares a lookup key with a table entry key, in `strcmp` order.
+static int compare_key(const void* key, const void* entry);
+
+bool json_parser_parse(json_parser_t* parser, char* js, uint32_t length,
+                       json_token_t* tokens, uint16_t max_tokens)
+{
+    // Check parameters.
+    LUOS_ASSERT(parser != NULL);
+    LUOS_ASSERT(js != NULL);
+    LUOS_ASSERT(tokens != NULL);
+    LUOS_ASSERT(length <= UINT16_MAX);
+
+    parser->js          = js;
+    parser->tokens      = tokens;
+    parser->nb_tokens   = 0;
+
+    // Open objects and arrays, with their number of direct children.
+    int32_t     parents[JSON_PARSER_MAX_DEPTH];
+    uint16_t    nb_children[JSON_PARSER_MAX_DEPTH];
+    uint8_t     depth   = 0;
+
+    for (uint32_t pos = 0; (pos < length) && (js[pos] != '\0'); pos++)
+    {
+        int32_t     parent      = (depth > 0) ? parents[depth - 1]
+                                              : JSON_PARSER_NOT_FOUND;
+        uint16_t*   children    = (depth > 0) ? &nb_children[depth - 1]
+                                              : NULL;
+        int32_t     token;
+
+        switch (js[pos])
+        {
+        case '{':
+        case '[':
+            if (depth == JSON_PARSER_MAX_DEPTH)
+            {
+                return false;
+            }
+
+            token = add_token(parser, max_tokens,
+                              (js[pos] == '{') ? JSON_TOKEN_OBJECT
+                                               : JSON_TOKEN_ARRAY,
+                              pos, parent, children);
+            if (token == JSON_PARSER_NOT_FOUND)
+            {
+                return false;
+            }
+
+            parents[depth]      = token;
+            nb_children[depth]  = 0;
+            depth++;
+            break;
+
+        case '}':
+        case ']':
+            if ((depth == 0)
+                || (tokens[parent].type != ((js[pos] == '}')
+                                            ? JSON_TOKEN_OBJECT
+                                            : JSON_TOKEN_ARRAY))
+                || ((tokens[parent].type == JSON_TOKEN_OBJECT)
+                    && ((*children % 2) != 0)))
+            {
+                // Unbalanced, or key without value.
+                return false;
+            }
+
+            tokens[parent].end  = pos + 1;
+            depth--;
+
+            if (depth == 0)
+            {
+                // First value complete, ignore what follows.
+                return true;
+            }
+            break;
+
+        case '"':
+            token = add_token(parser, max_tokens, JSON_TOKEN_STRING,
+                              pos + 1, parent, children);
+            if (token == JSON_PARSER_NOT_FOUND)
+            {
+                return false;
+            }
+
+            for (pos++; (pos < length) && (js[pos] != '"'); pos++)
+            {
+                if ((js[pos] == '\\') || (js[pos] == '\0'))
+                {
+                    // Escaped character, or end of text.
+                    if ((js[pos] == '\0') || (++pos >= length))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            if (pos >= length)
+            {
+                return false;
+            }
+
+            tokens[token].end   = pos;
+
+            if (depth == 0)
+            {
+                return true;
+            }
+            break;
+
+        case ' ':
+        case '\t':
+        case '\n':
+        case '\r':
+        case ':':
+        case ',':
+            break;
+
+        default:
+            token = add_token(parser, max_tokens, JSON_TOKEN_PRIMITIVE,
+                              pos, parent, children);
+            if (token == JSON_PARSER_NOT_FOUND)
+            {
+                return false;
+            }
+
+            while ((pos + 1 < length) && !is_primitive_end(js[pos + 1]))
+            {
+                pos++;
+            }
+
+            tokens[token].end   = pos + 1;
+
+            if (depth == 0)
+            {
+                return true;
+            }
+            break;
+        }
+    }
+
+    // Text ended before the first value was complete.
+    return false;
+}
+
+uint16_t json_parser_skip(const json_parser_t* parser, uint16_t index)
+{
+    // Check parameters.
+    LUOS_ASSERT(parser != NULL);
+    LUOS_ASSERT(index < parser->nb_tokens);
+
+    // Children lie within the text of their parent.
+    uint16_t    end     = parser->tokens[index].end;
+    uint16_t    next    = index + 1;
+    while ((next < parser->nb_tokens)
+           && (parser->tokens[next].start < end))
+    {
+        next++;
+    }
+
+    return next;
+}
+
+int32_t json_parser_find(const json_parser_t* parser, int32_t object,
+                         const char* key)
+{
+    // Check parameters.
+    LUOS_ASSERT(parser != NULL);
+    LUOS_ASSERT(key != NULL);
+
+    if (!json_parser_is(parser, object, JSON_TOKEN_OBJECT))
+    {
+        return JSON_PARSER_NOT_FOUND;
+    }
+
+    uint16_t    key_length  = strlen(key);
+    uint16_t    key_index   = object + 1;
+    for (uint16_t i = 0; i < parser->tokens[object].size; i++)
+    {
+        const json_token_t* token   = parser->tokens + key_index;
+        if (((token->end - token->start) == key_length)
+            && (strncmp(parser->js + token->start, key, key_length) == 0))
+        {
+            return key_index + 1;
+        }
+
+        key_index   = json_parser_skip(parser, key_index + 1);
+    }
+
+    return JSON_PARSER_NOT_FOUND;
+}
+
+int32_t json_parser_array_item(const json_parser_t* parser, int32_t array,
+                               uint16_t item)
+{
+    // Check parameter.
+    LUOS_ASSERT(parser != NULL);
+
+    if (!json_parser_is(parser, array, JSON_TOKEN_ARRAY)
+        || (item >= parser->tokens[array].size))
+    {
+        return JSON_PARSER_NOT_FOUND;
+    }
+
+    uint16_t    index   = array + 1;
+    for (uint16_t i = 0; i < item; i++)
+    {
+        index   = json_parser_skip(parser, index);
+    }
+
+    return index;
+}
+
+const void* json_parser_lookup(const json_parser_t* parser, uint16_t key,
+                               const void* table, uint16_t nb_entries,
+                               uint16_t entry_size)
+{
+    // Check parameters.
+    LUOS_ASSERT(parser != NULL);
+    LUOS_ASSERT(key < parser->nb_tokens);
+    LUOS_ASSERT(table != NULL);
+
+    const json_token_t* token       = parser->tokens + key;
+
+    return json_parser_lookup_str(parser->js + token->start,
+                                  token->end - token->start, table,
+                                  nb_entries, entry_size);
+}
+
+const void* json_parser_lookup_str(const char* str, uint16_t length,
+                                   const void* table, uint16_t nb_entries,
+                                   uint16_t entry_size)
+{
+    // Check parameters.
+    LUOS_ASSERT(str != NULL);
+    LUOS_ASSERT(table != NULL);
+
+    lookup_key_t        lookup_key  =
+    {
+        .str    = str,
+        .length = length,
+    };
+
+    return bsearch(&lookup_key, table, nb_entries, entry_size, compare_key);
+}
+
+bool json_parser_is(const json_parser_t* parser, int32_t index,
+                    json_token_type_t type)
+{
+    // Check parameter.
+    LUOS_ASSERT(parser != NULL);
+
+    return (index >= 0) && (index < parser->nb_tokens)
+           && (parser->tokens[index].type == type);
+}
+
+bool json_parser_is_number(const json_parser_t* parser, int32_t index)
+{
+    if (!json_parser_is(parser, index, JSON_TOKEN_PRIMITIVE))
+    {
+        return false;
+    }
+
+    char    first   = parser->js[parser->tokens[index].start];
+
+    return (first == '-') || ((first >= '0') && (first <= '9'));
+}
+
+bool json_parser_is_bool(const json_parser_t* parser, int32_t index)
+{
+    if (!json_parser_is(parser, index, JSON_TOKEN_PRIMITIVE))
+    {
+        return false;
+    }
+
+    const char* str     = parser->js + parser->tokens[index].start;
+    uint32_t    length  = parser->tokens[index].end
+                          - parser->tokens[index].start;
+
+    return ((length == strlen("true")) && (strncmp(str, "true", length) == 0))
+           || ((length == strlen("false"))
+               && (strncmp(str, "false", length) == 0));
+}
+
+bool json_parser_is_true(const json_parser_t* parser, int32_t index)
+{
+    return json_parser_is_bool(parser, index)
+           && (parser->js[parser->tokens[index].start] == 't');
+}
+
+double json_parser_get_double(const json_parser_t* parser, int32_t index)
+{
+    if (!json_parser_is_number(parser, index))
+    {
+        return 0.0;
+    }
+
+    const char* str     = parser->js + parser->tokens[index].start;
+    const char* end     = parser->js + parser->tokens[index].end;
+    bool        negative    = (*str == '-');
+    if (negative)
+    {
+        str++;
+    }
+
+    // Integer and fraction parts.
+    double      value       = 0.0;
+    double      scale       = 1.0;
+    bool        fraction    = false;
+    for (; (str < end) && (*str != 'e') && (*str != 'E'); str++)
+    {
+        if (*str == '.')
+        {
+            fraction    = true;
+        }
+        else if ((*str >= '0') && (*str <= '9'))
+        {
+            value   = value * 10.0 + (*str - '0');
+            if (fraction)
+            {
+                scale   *= 10.0;
+            }
+        }
+        else
+        {
+            return 0.0;
+        }
+    }
+    value   /= scale;
+
+    // Exponent.
+    if (str < end)
+    {
+        str++;
+        bool        negative_exponent   = (str < end) && (*str == '-');
+        if ((str < end) && ((*str == '-') || (*str == '+')))
+        {
+            str++;
+        }
+
+        int32_t     exponent    = 0;
+        for (; (str < end) && (*str >= '0') && (*str <= '9'); str++)
+        {
+            exponent    = exponent * 10 + (*str - '0');
+            if (exponent > JSON_PARSER_MAX_EXPONENT)
+            {
+                // Saturated: further digits change nothing.
+                exponent    = JSON_PARSER_MAX_EXPONENT;
+            }
+        }
+
+        for (int32_t i = 0; i < exponent; i++)
+        {
+            value   = negative_exponent ? value / 10.0 : value * 10.0;
+        }
+    }
+
+    return negative ? -value : value;
+}
+
+int32_t json_parser_get_int(const json_parser_t* parser, int32_t index)
+{
+    double  value   = json_parser_get_double(parser, index);
+
+    // Saturate like the cast of the previous parser.
+    if (value >= INT32_MAX)
+    {
+        return INT32_MAX;
+    }
+    if (value <= INT32_MIN)
+    {
+        return INT32_MIN;
+    }
+
+    return (int32_t)value;
+}
+
+char* json_parser_get_string(const json_parser_t* parser, int32_t index)
+{
+    if (!json_parser_is(parser, index, JSON_TOKEN_STRING))
+    {
+        return NULL;
+    }
+
+    // Overwrite the closing quote.
+    const json_token_t* token   = parser->tokens + index;
+    parser->js[token->end]      = '\0';
+
+    return parser->js + token->start;
+}
+
+static int32_t add_token(json_parser_t* parser, uint16_t max_tokens,
+                         json_token_type_t type, uint32_t start,
+                         int32_t parent, uint16_t* nb_children)
+{
+    if (parser->nb_tokens >= max_tokens)
+    {
+        return JSON_PARSER_NOT_FOUND;
+    }
+
+    if (parent != JSON_PARSER_NOT_FOUND)
+    {
+        json_token_t*   parent_token    = parser->tokens + parent;
+        if (parent_token->type == JSON_TOKEN_ARRAY)
+        {
+            parent_token->size++;
+        }
+        else if ((*nb_children % 2) == 0)
+        {
+            // Object keys are strings.
+            if (type != JSON_TOKEN_STRING)
+            {
+                return JSON_PARSER_NOT_FOUND;
+            }
+            parent_token->size++;
+        }
+
+        (*nb_children)++;
+    }
+
+    int32_t         index   = parser->nb_tokens++;
+    json_token_t*   token   = parser->tokens + index;
+    token->start    = start;
+    token->end      = start;
+    token->size     = 0;
+    token->type     = type;
+
+    return index;
+}
+
+static bool is_primitive_end(char c)
+{
+    switch (c)
+    {
+    case '\0':
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case ']':
+    case '}':
+        return true;
+    default:
+        return false;
+    }
+}
+
+static int compare_key(const void* key, const void* entry)
+{
+    const lookup_key_t* lookup_key  = (const lookup_key_t*)key;
+    const char*         entry_key   = *(const char* const*)entry;
+
+    int result  = strncmp(lookup_key->str, entry_key, lookup_key->length);
+    if (result != 0)
+    {
+        return result;
+    }
+
+    // Equal prefixes: the shorter key comes first.
+    return (entry_key[lookup_key->length] == '\0') ? 0 : -1;
+}
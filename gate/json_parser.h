@@ -0,0 +1,132 @@
+#ifndef JSON_PARSER_H
+#define JSON_PARSER_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t, int32_t
+
+/*      DEFINES                                                     */
+
+// Index returned when a token is not found.
+#define JSON_PARSER_NOT_FOUND   (-1)
+
+// Maximum nesting depth of parsed JSON.
+#define JSON_PARSER_MAX_DEPTH   8
+
+/*      TYPEDEFS                                                    */
+
+// JSON token types.
+typedef enum
+{
+    JSON_TOKEN_OBJECT,
+    JSON_TOKEN_ARRAY,
+    JSON_TOKEN_STRING,
+
+    // Number, boolean or null.
+    JSON_TOKEN_PRIMITIVE,
+
+} json_token_type_t;
+
+/* JSON token, located in the parsed text. Tokens are stored in document
+** order: the children of an object or array follow it, and the value of
+** an object key follows the key.
+*/
+typedef struct
+{
+    // Offset of the first character, after the opening quote of strings.
+    uint16_t    start;
+
+    // Offset after the last character, on the closing quote of strings.
+    uint16_t    end;
+
+    // Number of keys of an object, or of items of an array.
+    uint16_t    size;
+
+    // Token type, see `json_token_type_t`.
+    uint8_t     type;
+
+} json_token_t;
+
+/* Allocation-free JSON parser: tokenizes a JSON text in place, in a
+** token array provided by the caller. Strings are only terminated in the
+** text when read, and are not unescaped.
+*/
+typedef struct
+{
+    // Parsed JSON text.
+    char*           js;
+
+    // Token array, and number of used tokens.
+    json_token_t*   tokens;
+    uint16_t        nb_tokens;
+
+} json_parser_t;
+
+/* Tokenizes the first JSON value of the given text, which ends at the
+** first NUL character or after the given length. Characters following
+** the value are ignored. Returns false if the text is not valid JSON or
+** needs more than the given number of tokens.
+*/
+bool json_parser_parse(json_parser_t* parser, char* js, uint32_t length,
+                       json_token_t* tokens, uint16_t max_tokens);
+
+// Returns the index of the token following the given one and its children.
+uint16_t json_parser_skip(const json_parser_t* parser, uint16_t index);
+
+/* Returns the index of the value of the given key in the given object,
+** or JSON_PARSER_NOT_FOUND.
+*/
+int32_t json_parser_find(const json_parser_t* parser, int32_t object,
+                         const char* key);
+
+/* Returns the index of the given item of the given array, or
+** JSON_PARSER_NOT_FOUND.
+*/
+int32_t json_parser_array_item(const json_parser_t* parser, int32_t array,
+                               uint16_t item);
+
+/* Looks the given key token up in the given table, sorted by key in
+** `strcmp` order, whose entries begin with their `const char*` key.
+** Returns the matching entry, or NULL.
+*/
+const void* json_parser_lookup(const json_parser_t* parser, uint16_t key,
+                               const void* table, uint16_t nb_entries,
+                               uint16_t entry_size);
+
+/* Looks the given key string, of the given length, up in the given
+** table, as `json_parser_lookup` does. Returns the matching entry, or
+** NULL.
+*/
+const void* json_parser_lookup_str(const char* str, uint16_t length,
+                                   const void* table, uint16_t nb_entries,
+                                   uint16_t entry_size);
+
+// Returns true if the given token is of the given type.
+bool json_parser_is(const json_parser_t* parser, int32_t index,
+                    json_token_type_t type);
+
+// Returns true if the given token is a number.
+bool json_parser_is_number(const json_parser_t* parser, int32_t index);
+
+// Returns true if the given token is a boolean.
+bool json_parser_is_bool(const json_parser_t* parser, int32_t index);
+
+// Returns true if the given token is the `true` boolean.
+bool json_parser_is_true(const json_parser_t* parser, int32_t index);
+
+// Returns the value of the given number token, 0 if it is not a number.
+double json_parser_get_double(const json_parser_t* parser, int32_t index);
+
+/* Returns the value of the given number token, truncated to an integer,
+** 0 if it is not a number.
+*/
+int32_t json_parser_get_int(const json_parser_t* parser, int32_t index);
+
+/* Terminates the given string token in place and returns it, or returns
+** NULL if it is not a string.
+*/
+char* json_parser_get_string(const json_parser_t* parser, int32_t index);
+
+#endif /* ! JSON_PARSER_H */
@@ -0,0 +1,292 @@
+#include "json_writer.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdarg.h>         // va_*
+#include <stdbool.h>        // bool
+#include <math.h>           // isfinite, signbit
+#include <stdint.h>         // uint*_t
+#include <stdio.h>          // vsnprintf
+#include <string.h>         // memcpy, strlen
+
+// LUOS
+#include "luos_utils.h"     // LUOS_ASSERT
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+// Powers of ten scaling the formatted floats.
+static const uint32_t   POW10[JSON_WRITER_MAX_DECIMALS + 1] =
+{
+    1, 10, 100, 1000, 10000, 100000, 1000000
+};
+
+// Bound of the scaled floats formatted without printf, below 2^63.
+#define MAX_SCALED_FLOAT    1e18
+
+// Size of the text of a formatted number.
+#define NUMBER_TEXT_SIZE    32
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Writes the digits of the given value backwards from the given end of
+** a text, and returns its new start.
+*/
+static char* format_digits(char* end, uint64_t value);
+
+void json_writer_init(json_writer_t* writer, char* buf, uint32_t size)
+{
+    // Check parameters.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT(buf != NULL);
+    LUOS_ASSERT(size > 0);
+
+    writer->buf         = buf;
+    writer->capacity    = size - 1;
+    writer->length      = 0;
+    writer->overflow    = false;
+
+    writer->buf[0]      = '\0';
+}
+
+void json_writer_reserve(json_writer_t* writer, uint32_t nb_bytes)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT(writer->capacity - writer->length >= nb_bytes);
+
+    writer->capacity    -= nb_bytes;
+}
+
+void json_writer_release(json_writer_t* writer, uint32_t nb_bytes)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    writer->capacity    += nb_bytes;
+}
+
+bool json_writer_append(json_writer_t* writer, const char* str)
+{
+    // Check parameters.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT(str != NULL);
+
+    uint32_t    str_length  = strlen(str);
+    if (str_length > (writer->capacity - writer->length))
+    {
+        writer->overflow    = true;
+        return false;
+    }
+
+    // Copy string with its terminating NUL character.
+    memcpy(writer->buf + writer->length, str, str_length + 1);
+    writer->length      += str_length;
+
+    return true;
+}
+
+bool json_writer_write(json_writer_t* writer, const char* bytes,
+                       uint32_t nb_bytes)
+{
+    // Check parameters.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT((bytes != NULL) || (nb_bytes == 0));
+
+    if (nb_bytes > (writer->capacity - writer->length))
+    {
+        writer->overflow    = true;
+        return false;
+    }
+
+    memcpy(writer->buf + writer->length, bytes, nb_bytes);
+    writer->length              += nb_bytes;
+    writer->buf[writer->length] = '\0';
+
+    return true;
+}
+
+bool json_writer_printf(json_writer_t* writer, const char* format, ...)
+{
+    // Check parameters.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT(format != NULL);
+
+    uint32_t    available   = writer->capacity - writer->length;
+
+    va_list     args;
+    va_start(args, format);
+    int         written     = vsnprintf(writer->buf + writer->length,
+                                        available + 1, format, args);
+    va_end(args);
+
+    if ((written < 0) || ((uint32_t)written > available))
+    {
+        // Drop the truncated fragment.
+        writer->buf[writer->length] = '\0';
+        writer->overflow            = true;
+        return false;
+    }
+
+    writer->length      += written;
+
+    return true;
+}
+
+bool json_writer_float(json_writer_t* writer, float value, uint8_t decimals)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    if (!isfinite(value) || (decimals > JSON_WRITER_MAX_DECIMALS))
+    {
+        return json_writer_printf(writer, "%.*f", decimals, (double)value);
+    }
+
+    // Exact: a float mantissa times 10^6 fits in a double mantissa.
+    bool        negative    = signbit(value);
+    double      scaled      = (double)value * POW10[decimals];
+    if (negative)
+    {
+        scaled  = -scaled;
+    }
+
+    if (scaled >= MAX_SCALED_FLOAT)
+    {
+        return json_writer_printf(writer, "%.*f", decimals, (double)value);
+    }
+
+    // Round half to even, as printf does with the exact value.
+    uint64_t    fixed       = (uint64_t)scaled;
+    double      remainder   = scaled - (double)fixed;
+    if ((remainder > 0.5) || ((remainder == 0.5) && ((fixed & 1) != 0)))
+    {
+        fixed++;
+    }
+
+    // Split the integer and fractional parts, with 32-bit divisions if possible.
+    uint64_t    integer;
+    uint32_t    fraction;
+    if (fixed <= UINT32_MAX)
+    {
+        integer     = (uint32_t)fixed / POW10[decimals];
+        fraction    = (uint32_t)fixed % POW10[decimals];
+    }
+    else
+    {
+        integer     = fixed / POW10[decimals];
+        fraction    = (uint32_t)(fixed - integer * POW10[decimals]);
+    }
+
+    char        text[NUMBER_TEXT_SIZE];
+    char*       end         = text + NUMBER_TEXT_SIZE;
+    char*       start       = end;
+    if (decimals > 0)
+    {
+        for (uint8_t digit_idx = 0; digit_idx < decimals; digit_idx++)
+        {
+            *--start    = '0' + (fraction % 10);
+            fraction    /= 10;
+        }
+        *--start    = '.';
+    }
+
+    start   = format_digits(start, integer);
+    if (negative)
+    {
+        // Also for values rounded to zero, as printf does.
+        *--start    = '-';
+    }
+
+    return json_writer_write(writer, start, end - start);
+}
+
+bool json_writer_uint(json_writer_t* writer, uint32_t value)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    char    text[NUMBER_TEXT_SIZE];
+    char*   end     = text + NUMBER_TEXT_SIZE;
+    char*   start   = format_digits(end, value);
+
+    return json_writer_write(writer, start, end - start);
+}
+
+bool json_writer_int(json_writer_t* writer, int32_t value)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    // Magnitude computed unsigned, so that INT32_MIN does not overflow.
+    uint32_t    magnitude   = (value < 0) ? (0u - (uint32_t)value) : (uint32_t)value;
+
+    char        text[NUMBER_TEXT_SIZE];
+    char*       end         = text + NUMBER_TEXT_SIZE;
+    char*       start       = format_digits(end, magnitude);
+    if (value < 0)
+    {
+        *--start    = '-';
+    }
+
+    return json_writer_write(writer, start, end - start);
+}
+
+bool json_writer_trim(json_writer_t* writer, char last)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    if (json_writer_last(writer) != last)
+    {
+        return false;
+    }
+
+    writer->length--;
+    writer->buf[writer->length] = '\0';
+
+    return true;
+}
+
+char json_writer_last(const json_writer_t* writer)
+{
+    // Check parameter.
+    LUOS_ASSERT(writer != NULL);
+
+    if (writer->length == 0)
+    {
+        return '\0';
+    }
+
+    return writer->buf[writer->length - 1];
+}
+
+void json_writer_rewind(json_writer_t* writer, uint32_t length)
+{
+    // Check parameters.
+    LUOS_ASSERT(writer != NULL);
+    LUOS_ASSERT(length <= writer->length);
+
+    writer->length              = length;
+    writer->buf[writer->length] = '\0';
+    writer->overflow            = false;
+}
+
+static char* format_digits(char* end, uint64_t value)
+{
+    // 64-bit divisions are software calls on the target: only for the top digits.
+    while (value > UINT32_MAX)
+    {
+        *--end  = '0' + (char)(value % 10);
+        value   /= 10;
+    }
+
+    uint32_t    small   = (uint32_t)value;
+    do
+    {
+        *--end  = '0' + (small % 10);
+        small   /= 10;
+    } while (small != 0);
+
+    return end;
+}
@@ -0,0 +1,100 @@
+#ifndef JSON_WRITER_H
+#define JSON_WRITER_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint32_t
+
+/*      DEFINES                                                     */
+
+/* Largest number of decimals of a float formatted without printf, so
+** that its scaled value stays exact in a double.
+*/
+#define JSON_WRITER_MAX_DECIMALS    6
+
+/*      TYPEDEFS                                                    */
+
+/* Streaming JSON writer: appends fragments at a tracked cursor in a
+** bounded buffer, which stays NUL-terminated.
+**
+** A fragment is either fully written or not at all: when it does not
+** fit, the buffer is left unchanged and the overflow flag is set.
+*/
+typedef struct
+{
+    // Destination buffer.
+    char*       buf;
+
+    // Usable size, terminating NUL character and reserved bytes excluded.
+    uint32_t    capacity;
+
+    // Current length of the written JSON.
+    uint32_t    length;
+
+    // Describes if a fragment did not fit since the last rewind.
+    bool        overflow;
+
+} json_writer_t;
+
+/* Initializes the given writer on the given buffer of the given size in
+** bytes, and empties the buffer.
+*/
+void json_writer_init(json_writer_t* writer, char* buf, uint32_t size);
+
+/* Reserves the given number of bytes at the end of the buffer, so that
+** closing characters can still be written after an overflow.
+*/
+void json_writer_reserve(json_writer_t* writer, uint32_t nb_bytes);
+
+// Gives back the given number of previously reserved bytes.
+void json_writer_release(json_writer_t* writer, uint32_t nb_bytes);
+
+/* Appends the given string. Returns false and sets the overflow flag if
+** it does not fit.
+*/
+bool json_writer_append(json_writer_t* writer, const char* str);
+
+/* Appends the given number of bytes of the given string, which may
+** continue. Returns false and sets the overflow flag if they do not fit.
+*/
+bool json_writer_write(json_writer_t* writer, const char* bytes,
+                       uint32_t nb_bytes);
+
+/* Appends the given formatted fragment. Returns false and sets the
+** overflow flag if it does not fit.
+*/
+bool json_writer_printf(json_writer_t* writer, const char* format, ...)
+    __attribute__((format(printf, 2, 3)));
+
+/* Appends the given float with the given number of decimals, as printf
+** "%.*f" does, without its cost. Returns false and sets the overflow flag
+** if it does not fit.
+*/
+bool json_writer_float(json_writer_t* writer, float value, uint8_t decimals);
+
+/* Appends the given unsigned integer. Returns false and sets the
+** overflow flag if it does not fit.
+*/
+bool json_writer_uint(json_writer_t* writer, uint32_t value);
+
+/* Appends the given integer. Returns false and sets the overflow flag if
+** it does not fit.
+*/
+bool json_writer_int(json_writer_t* writer, int32_t value);
+
+/* Removes the last written character if it is the given one. Returns
+** true if it was removed.
+*/
+bool json_writer_trim(json_writer_t* writer, char last);
+
+// Returns the last written character, or '\0' if nothing was written.
+char json_writer_last(const json_writer_t* writer);
+
+/* Moves the cursor back to the given length, dropping everything written
+** after it, and clears the overflow flag.
+*/
+void json_writer_rewind(json_writer_t* writer, uint32_t length);
+
+#endif /* ! JSON_WRITER_H */
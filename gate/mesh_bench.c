@@ -0,0 +1,462 @@
+#include "mesh_bench.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t
+#include <stdlib.h>         // qsort
+#include <string.h>         // memset
+
+// LUOS
+#include "app_luos_list.h"  // LUOS_MESH_BRIDGE
+#include "luos.h"           // container_t, msg_t, Luos_*
+#include "luos_utils.h"     // LUOS_ASSERT
+
+#ifdef LUOS_MESH_BRIDGE
+
+// CUSTOM
+#include "gate.h"           // json_send
+#include "json_writer.h"    // json_writer_*
+#include "mesh_bridge.h"    // MESH_BRIDGE_ECHO*
+
+/*      DEFINES                                                     */
+
+// Size of the JSON line of a benchmark result.
+#define MESH_BENCH_JSON_SIZE    384
+
+/*      TYPEDEFS                                                    */
+
+// Echo request waiting for its reply.
+typedef struct
+{
+    // Describes if the slot is used.
+    bool        in_use;
+
+    // Destination of the request.
+    uint16_t    target;
+
+    // Sequence number of the request, echoed by its reply.
+    uint32_t    seq;
+
+    // Systick value when the request was sent.
+    uint32_t    send_tick;
+
+} pending_request_t;
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+// Upper bounds of the latency histogram buckets.
+static const uint32_t       BUCKET_BOUNDS[MESH_BENCH_NB_BUCKETS - 1]    = MESH_BENCH_BUCKET_BOUNDS;
+
+// Latency samples of the current run.
+static uint32_t             s_latencies[MESH_BENCH_MAX_SAMPLES];
+
+// Requests waiting for a reply in the current run.
+static pending_request_t    s_pending[MESH_BENCH_MAX_WINDOW];
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Marks the pending request sent to the given target with the given
+** sequence number as answered, and returns its latency in the given
+** pointer. Returns false if no such request is pending.
+*/
+static bool pending_request_complete(uint16_t target, uint32_t seq,
+                                     uint32_t now, uint32_t* latency);
+
+/* Returns true if the given message is an echo reply from one of the
+** destinations of the given parameters.
+*/
+static bool is_echo_reply(const mesh_bench_params_t* params,
+                          const msg_t* msg);
+
+// Returns the latency at the given percentile of the sorted samples.
+static uint32_t percentile(const uint32_t* sorted, uint32_t nb_samples,
+                           uint32_t percent);
+
+// Comparison function for latency sorting.
+static int latency_cmp(const void* a, const void* b);
+
+/* Writes the counters and the latency distribution of the given result
+** as JSON members with the given writer.
+*/
+static void result_to_json(const mesh_bench_result_t* result,
+                           json_writer_t* json);
+
+void mesh_bench_run(container_t* container,
+                    const mesh_bench_params_t* params,
+                    mesh_bench_result_t* result)
+{
+    // Check parameters.
+    LUOS_ASSERT(container != NULL);
+    LUOS_ASSERT(params != NULL);
+    LUOS_ASSERT(result != NULL);
+    LUOS_ASSERT(params->nb_targets > 0);
+    LUOS_ASSERT(params->nb_targets <= MESH_BENCH_MAX_TARGETS);
+
+    memset(result, 0, sizeof(mesh_bench_result_t));
+    memset(s_pending, 0, sizeof(s_pending));
+
+    uint16_t    window          = params->window;
+    if (window == 0 || window > MESH_BENCH_MAX_WINDOW)
+    {
+        window = MESH_BENCH_MAX_WINDOW;
+    }
+    result->window              = window;
+
+    uint8_t     payload_size    = params->payload_size;
+    if (payload_size < MESH_BENCH_MIN_PAYLOAD)
+    {
+        payload_size = MESH_BENCH_MIN_PAYLOAD;
+    }
+    else if (payload_size > MESH_BRIDGE_ECHO_MAX_SIZE)
+    {
+        payload_size = MESH_BRIDGE_ECHO_MAX_SIZE;
+    }
+    result->payload_size        = payload_size;
+
+    uint32_t    timeout_ms      = params->timeout_ms;
+    if (timeout_ms == 0)
+    {
+        timeout_ms = MESH_BENCH_DEFAULT_TIMEOUT;
+    }
+
+    uint32_t    nb_requests     = params->repetitions * params->nb_targets;
+    uint32_t    nb_pending      = 0;
+    uint32_t    nb_samples      = 0;
+    uint32_t    latency_sum     = 0;
+
+    /* Echo request: the sequence number, then filler bytes up to the
+    ** payload size.
+    */
+    msg_t       request;
+    memset(&request, 0, sizeof(msg_t));
+    request.header.cmd          = MESH_BRIDGE_ECHO;
+    request.header.target_mode  = params->target_mode;
+    request.header.size         = payload_size;
+    for (uint8_t i = MESH_BENCH_MIN_PAYLOAD; i < payload_size; i++)
+    {
+        request.data[i] = i;
+    }
+
+    result->latency_min_ms      = UINT32_MAX;
+
+    uint32_t    begin_tick      = Luos_GetSystick();
+
+    while ((result->nb_sent < nb_requests) || (nb_pending > 0))
+    {
+        // Fill the window with new requests.
+        for (uint16_t slot_idx = 0;
+             (slot_idx < window) && (result->nb_sent < nb_requests);
+             slot_idx++)
+        {
+            pending_request_t*  slot    = s_pending + slot_idx;
+            if (slot->in_use)
+            {
+                continue;
+            }
+
+            uint16_t    target  = params->targets[result->nb_sent % params->nb_targets];
+
+            uint32_t    seq     = result->nb_sent;
+
+            request.header.target   = target;
+            memcpy(request.data, &seq, sizeof(uint32_t));
+
+            slot->in_use            = true;
+            slot->target            = target;
+            slot->seq               = seq;
+            slot->send_tick         = Luos_GetSystick();
+
+            Luos_SendMsg(container, &request);
+
+            result->nb_sent++;
+            nb_pending++;
+        }
+
+        // Let Luos dispatch received messages.
+        Luos_Loop();
+
+        uint32_t    now         = Luos_GetSystick();
+
+        /* Match replies with pending requests, and drain the other
+        ** messages: the Gate loop does not read them during the run.
+        */
+        msg_t*      reply   = NULL;
+        while (Luos_ReadMsg(container, &reply) == SUCCEED)
+        {
+            if (!is_echo_reply(params, reply))
+            {
+                result->nb_drained++;
+                continue;
+            }
+
+            uint32_t    seq;
+            memcpy(&seq, reply->data, sizeof(uint32_t));
+
+            uint32_t    latency;
+            bool        matched;
+            matched = pending_request_complete(reply->header.source, seq,
+                                               now, &latency);
+            if (!matched)
+            {
+                /* Late reply to a request already counted as lost, or
+                ** reply to another requester: drop it.
+                */
+                result->nb_unmatched++;
+                continue;
+            }
+
+            nb_pending--;
+            result->nb_received++;
+            latency_sum += latency;
+
+            if (latency < result->latency_min_ms)
+            {
+                result->latency_min_ms = latency;
+            }
+            if (latency > result->latency_max_ms)
+            {
+                result->latency_max_ms = latency;
+            }
+            uint16_t    bucket  = 0;
+            while ((bucket < (MESH_BENCH_NB_BUCKETS - 1))
+                   && (latency >= BUCKET_BOUNDS[bucket]))
+            {
+                bucket++;
+            }
+            result->histogram[bucket]++;
+
+            if (nb_samples < MESH_BENCH_MAX_SAMPLES)
+            {
+                s_latencies[nb_samples] = latency;
+                nb_samples++;
+            }
+        }
+
+        // Drop requests waiting for too long.
+        for (uint16_t slot_idx = 0; slot_idx < window; slot_idx++)
+        {
+            pending_request_t*  slot    = s_pending + slot_idx;
+            if (slot->in_use && ((now - slot->send_tick) > timeout_ms))
+            {
+                slot->in_use    = false;
+                nb_pending--;
+            }
+        }
+    }
+
+    result->duration_ms = Luos_GetSystick() - begin_tick;
+
+    if (nb_samples > 0)
+    {
+        qsort(s_latencies, nb_samples, sizeof(uint32_t), latency_cmp);
+
+        result->latency_p50_ms  = percentile(s_latencies, nb_samples, 50);
+        result->latency_p90_ms  = percentile(s_latencies, nb_samples, 90);
+        result->latency_p99_ms  = percentile(s_latencies, nb_samples, 99);
+    }
+    else
+    {
+        result->latency_min_ms  = 0;
+    }
+
+    if (result->duration_ms > 0)
+    {
+        result->throughput  = (float)result->nb_received * 1000.0
+                              / (float)result->duration_ms;
+    }
+
+    if (result->nb_sent > 0)
+    {
+        result->drop_rate   = (float)(result->nb_sent - result->nb_received)
+                              * 100.0 / (float)result->nb_sent;
+    }
+}
+
+void mesh_bench_sweep(container_t* container,
+                      const mesh_bench_sweep_t* sweep)
+{
+    // Check parameters.
+    LUOS_ASSERT(container != NULL);
+    LUOS_ASSERT(sweep != NULL);
+
+    mesh_bench_params_t params;
+    memset(&params, 0, sizeof(mesh_bench_params_t));
+    memcpy(params.targets, sweep->targets, sizeof(params.targets));
+    params.repetitions  = sweep->repetitions;
+    params.timeout_ms   = sweep->timeout_ms;
+
+    uint16_t    first_nb_targets    = sweep->sweep_targets ? 1 : sweep->nb_targets;
+
+    for (uint16_t nb_targets = first_nb_targets;
+         nb_targets <= sweep->nb_targets; nb_targets++)
+    {
+        for (uint16_t mode_idx = 0; mode_idx < sweep->nb_target_modes;
+             mode_idx++)
+        {
+            for (uint16_t window_idx = 0; window_idx < sweep->nb_windows;
+                 window_idx++)
+            {
+                for (uint16_t size_idx = 0;
+                     size_idx < sweep->nb_payload_sizes; size_idx++)
+                {
+                    params.nb_targets   = nb_targets;
+                    params.target_mode  = sweep->target_modes[mode_idx];
+                    params.window       = sweep->windows[window_idx];
+                    params.payload_size = sweep->payload_sizes[size_idx];
+
+                    mesh_bench_result_t result;
+                    mesh_bench_run(container, &params, &result);
+
+                    char            buf[MESH_BENCH_JSON_SIZE];
+                    json_writer_t   json;
+                    json_writer_init(&json, buf, sizeof(buf));
+                    json_writer_append(&json, "{\"mesh_benchmark\":{\"destinations\":");
+                    json_writer_uint(&json, nb_targets);
+                    json_writer_append(&json, (params.target_mode == IDACK) ? ",\"mode\":\"IDACK\"," : ",\"mode\":\"ID\",");
+                    result_to_json(&result, &json);
+                    json_writer_append(&json, ",\"duration_ms\":");
+                    json_writer_uint(&json, result.duration_ms);
+                    json_writer_append(&json, ",\"throughput\":");
+                    json_writer_float(&json, result.throughput, 2);
+                    json_writer_append(&json, ",\"drop_rate\":");
+                    json_writer_float(&json, result.drop_rate, 2);
+                    json_writer_append(&json, "}}\n");
+                    json_send(buf);
+                }
+            }
+        }
+    }
+}
+
+void mesh_bench_echo(container_t* container,
+                     const mesh_bench_params_t* params)
+{
+    // Check parameters.
+    LUOS_ASSERT(container != NULL);
+    LUOS_ASSERT(params != NULL);
+
+    mesh_bench_result_t result;
+    mesh_bench_run(container, params, &result);
+
+    // Useful data rate in bits per second, as the local benchmark.
+    float           goodput = result.throughput * result.payload_size * 8;
+
+    char            buf[MESH_BENCH_JSON_SIZE];
+    json_writer_t   json;
+    json_writer_init(&json, buf, sizeof(buf));
+    json_writer_append(&json, "{\"benchmark\":{\"mode\":\"echo\",");
+    result_to_json(&result, &json);
+    json_writer_append(&json, ",\"data_rate\":");
+    json_writer_float(&json, goodput, 2);
+    json_writer_append(&json, ",\"fail_rate\":");
+    json_writer_float(&json, result.drop_rate, 2);
+    json_writer_append(&json, "}}\n");
+    json_send(buf);
+}
+
+static bool is_echo_reply(const mesh_bench_params_t* params,
+                          const msg_t* msg)
+{
+    if ((msg->header.cmd != MESH_BRIDGE_ECHO)
+        || (msg->header.size < MESH_BENCH_MIN_PAYLOAD))
+    {
+        return false;
+    }
+
+    for (uint16_t target_idx = 0; target_idx < params->nb_targets;
+         target_idx++)
+    {
+        if (params->targets[target_idx] == msg->header.source)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static bool pending_request_complete(uint16_t target, uint32_t seq,
+                                     uint32_t now, uint32_t* latency)
+{
+    for (uint16_t slot_idx = 0; slot_idx < MESH_BENCH_MAX_WINDOW;
+         slot_idx++)
+    {
+        pending_request_t*  slot    = s_pending + slot_idx;
+        if (slot->in_use && (slot->target == target) && (slot->seq == seq))
+        {
+            *latency        = now - slot->send_tick;
+            slot->in_use    = false;
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static uint32_t percentile(const uint32_t* sorted, uint32_t nb_samples,
+                           uint32_t percent)
+{
+    // Nearest-rank method.
+    uint32_t    rank    = (percent * nb_samples + 99) / 100;
+    if (rank == 0)
+    {
+        rank = 1;
+    }
+
+    return sorted[rank - 1];
+}
+
+static int latency_cmp(const void* a, const void* b)
+{
+    uint32_t    lhs = *(const uint32_t*)a;
+    uint32_t    rhs = *(const uint32_t*)b;
+
+    return (lhs > rhs) - (lhs < rhs);
+}
+
+static void result_to_json(const mesh_bench_result_t* result,
+                           json_writer_t* json)
+{
+    static const char* const    LATENCY_KEYS[] = {
+        "\"min\":", ",\"p50\":", ",\"p90\":", ",\"p99\":", ",\"max\":"
+    };
+    const uint32_t              latencies[] = {
+        result->latency_min_ms, result->latency_p50_ms,
+        result->latency_p90_ms, result->latency_p99_ms,
+        result->latency_max_ms
+    };
+
+    json_writer_append(json, "\"window\":");
+    json_writer_uint(json, result->window);
+    json_writer_append(json, ",\"size\":");
+    json_writer_uint(json, result->payload_size);
+    json_writer_append(json, ",\"sent\":");
+    json_writer_uint(json, result->nb_sent);
+    json_writer_append(json, ",\"received\":");
+    json_writer_uint(json, result->nb_received);
+    json_writer_append(json, ",\"unmatched\":");
+    json_writer_uint(json, result->nb_unmatched);
+    json_writer_append(json, ",\"drained\":");
+    json_writer_uint(json, result->nb_drained);
+
+    json_writer_append(json, ",\"latency_ms\":{");
+    for (uint16_t i = 0; i < sizeof(latencies) / sizeof(uint32_t); i++)
+    {
+        json_writer_append(json, LATENCY_KEYS[i]);
+        json_writer_uint(json, latencies[i]);
+    }
+
+    json_writer_append(json, ",\"histogram\":[");
+    for (uint16_t bucket = 0; bucket < MESH_BENCH_NB_BUCKETS; bucket++)
+    {
+        json_writer_uint(json, result->histogram[bucket]);
+        json_writer_append(json, ",");
+    }
+    json_writer_trim(json, ',');
+    json_writer_append(json, "]}");
+}
+
+#endif /* LUOS_MESH_BRIDGE */
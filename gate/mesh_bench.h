@@ -0,0 +1,166 @@
+#ifndef MESH_BENCH_H
+#define MESH_BENCH_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t
+
+// LUOS
+#include "luos.h"           // container_t
+
+/*      DEFINES                                                     */
+
+// Maximum number of destinations in a benchmark run.
+#define MESH_BENCH_MAX_TARGETS      8
+
+// Maximum number of echo requests waiting for a reply.
+#define MESH_BENCH_MAX_WINDOW       16
+
+// Maximum number of latency samples kept by a benchmark run.
+#define MESH_BENCH_MAX_SAMPLES      512
+
+// Maximum number of values for each swept parameter.
+#define MESH_BENCH_MAX_SWEEP_VALUES 4
+
+// Default time in ms after which an echo request is considered lost.
+#define MESH_BENCH_DEFAULT_TIMEOUT  2000
+
+// Number of buckets in the latency histogram.
+#define MESH_BENCH_NB_BUCKETS       8
+
+// Upper bounds in ms of the latency histogram buckets but the last one.
+#define MESH_BENCH_BUCKET_BOUNDS    { 10, 20, 50, 100, 200, 500, 1000 }
+
+/* Smallest size in bytes of an echo payload, which starts with the
+** sequence number of the request, on 32 bits so that it never wraps
+** during a run.
+*/
+#define MESH_BENCH_MIN_PAYLOAD      sizeof(uint32_t)
+
+/*      TYPEDEFS                                                    */
+
+// Parameters of a single benchmark run.
+typedef struct
+{
+    // Destination container IDs, requests are sent round-robin.
+    uint16_t    targets[MESH_BENCH_MAX_TARGETS];
+
+    // Number of destinations.
+    uint16_t    nb_targets;
+
+    // Number of echo requests sent to each destination.
+    uint32_t    repetitions;
+
+    // Target mode of the echo requests (ID or IDACK).
+    uint8_t     target_mode;
+
+    // Maximum number of requests waiting for a reply (queue depth).
+    uint16_t    window;
+
+    // Time in ms after which a request is considered lost.
+    uint32_t    timeout_ms;
+
+    // Size in bytes of the echo payloads.
+    uint8_t     payload_size;
+
+} mesh_bench_params_t;
+
+// Results of a single benchmark run.
+typedef struct
+{
+    // Queue depth and payload size actually used, once clamped.
+    uint16_t    window;
+    uint8_t     payload_size;
+
+    // Number of echo requests sent.
+    uint32_t    nb_sent;
+
+    // Number of echo replies received in time.
+    uint32_t    nb_received;
+
+    /* Number of replies dropped because no pending request had their
+    ** sequence number (late or unexpected replies).
+    */
+    uint32_t    nb_unmatched;
+
+    /* Number of other messages received by the container during the
+    ** run, drained so that they do not fill the Luos message buffer.
+    */
+    uint32_t    nb_drained;
+
+    // Total duration of the run in ms.
+    uint32_t    duration_ms;
+
+    // Round-trip latency distribution in ms.
+    uint32_t    latency_min_ms;
+    uint32_t    latency_p50_ms;
+    uint32_t    latency_p90_ms;
+    uint32_t    latency_p99_ms;
+    uint32_t    latency_max_ms;
+
+    // Number of replies in each latency bucket.
+    uint32_t    histogram[MESH_BENCH_NB_BUCKETS];
+
+    // Received replies per second.
+    float       throughput;
+
+    // Percentage of requests without reply.
+    float       drop_rate;
+
+} mesh_bench_result_t;
+
+// Parameters of a benchmark sweep.
+typedef struct
+{
+    /* Destinations: runs use the first 1, 2, ... up to all of them if
+    ** `sweep_targets` is set, all of them otherwise.
+    */
+    uint16_t    targets[MESH_BENCH_MAX_TARGETS];
+    uint16_t    nb_targets;
+    bool        sweep_targets;
+
+    // Target modes to test.
+    uint8_t     target_modes[MESH_BENCH_MAX_SWEEP_VALUES];
+    uint16_t    nb_target_modes;
+
+    // Queue depths to test.
+    uint16_t    windows[MESH_BENCH_MAX_SWEEP_VALUES];
+    uint16_t    nb_windows;
+
+    // Echo payload sizes to test.
+    uint8_t     payload_sizes[MESH_BENCH_MAX_SWEEP_VALUES];
+    uint16_t    nb_payload_sizes;
+
+    // Number of echo requests sent to each destination in each run.
+    uint32_t    repetitions;
+
+    // Time in ms after which a request is considered lost.
+    uint32_t    timeout_ms;
+
+} mesh_bench_sweep_t;
+
+/* Sends echo requests (`MESH_BRIDGE_ECHO` messages, answered by the
+** Mesh Bridge of the destination) from the given container following
+** the given parameters, and fills the given results with the measured
+** round-trip latencies. Blocks until every request was either answered
+** or timed out; other messages received meanwhile are dropped.
+*/
+void mesh_bench_run(container_t* container,
+                    const mesh_bench_params_t* params,
+                    mesh_bench_result_t* result);
+
+/* Runs one benchmark for each combination of the given sweep
+** parameters, and sends each result as a JSON line to the pilot.
+*/
+void mesh_bench_sweep(container_t* container,
+                      const mesh_bench_sweep_t* sweep);
+
+/* Runs one benchmark with the given parameters and sends the result as
+** the reply to an echo mode `benchmark` command to the pilot.
+*/
+void mesh_bench_echo(container_t* container,
+                     const mesh_bench_params_t* params);
+
+#endif /* ! MESH_BENCH_H */
@@ -0,0 +1,200 @@
+#include "stream.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t
+#include <stdio.h>          // snprintf
+#include <string.h>         // memcpy, memset
+
+// LUOS
+#include "luos.h"           // container_t, msg_t, Luos_*
+#include "luos_utils.h"     // LUOS_ASSERT
+
+// CUSTOM
+#include "cmd.h"            // GATE_CMD_RING_SIZE
+#include "gate.h"           // json_send
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+_Static_assert(GATE_STREAM_WINDOW * GATE_STREAM_MAX_CHUNK < GATE_CMD_RING_SIZE,
+               "Stream chunks sent ahead do not fit in the reception ring!");
+
+// The current stream.
+static struct
+{
+    // Describes if a stream is open.
+    bool        open;
+
+    // Gate container, forwarding the data.
+    container_t*    container;
+
+    // Destination container and command of the data.
+    uint16_t    target;
+    uint8_t     cmd;
+
+    // Total size of the data, and size of the data already sent.
+    uint16_t    size;
+    uint16_t    sent;
+
+    // Sequence number of the next expected chunk.
+    uint32_t    next_seq;
+
+    // Describes if forwarded chunks wait for their acknowledgement.
+    bool        ack_pending;
+
+    // Message being filled, sent once full or at the end of the data.
+    msg_t       msg;
+    uint16_t    msg_fill;
+
+} s_stream  =
+{
+    // No stream is open at start.
+    0
+};
+
+/*      STATIC FUNCTIONS                                            */
+
+// Sends the stream state to the pilot, with the given error if not NULL.
+static void send_state(const char* error);
+
+// Sends the message being filled on the Luos network.
+static void send_msg(void);
+
+void stream_open(container_t* container, uint16_t target, int16_t cmd,
+                 uint32_t size)
+{
+    // Check parameter.
+    LUOS_ASSERT(container != NULL);
+
+    memset(&s_stream, 0, sizeof(s_stream));
+
+    if (cmd < 0)
+    {
+        send_state("key");
+        return;
+    }
+
+    if ((size == 0) || (size > GATE_STREAM_MAX_SIZE))
+    {
+        send_state("size");
+        return;
+    }
+
+    s_stream.open                   = true;
+    s_stream.container              = container;
+    s_stream.target                 = target;
+    s_stream.cmd                    = (uint8_t)cmd;
+    s_stream.size                   = (uint16_t)size;
+    s_stream.msg.header.target_mode = IDACK;
+    s_stream.msg.header.target      = target;
+    s_stream.msg.header.cmd         = s_stream.cmd;
+
+    send_state(NULL);
+}
+
+void stream_chunk(uint32_t seq, const uint8_t* data, uint32_t size)
+{
+    // Check parameter.
+    LUOS_ASSERT((data != NULL) || (size == 0));
+
+    if (!s_stream.open)
+    {
+        send_state("closed");
+        return;
+    }
+
+    uint32_t    remaining   = s_stream.size - s_stream.sent - s_stream.msg_fill;
+    if ((seq != s_stream.next_seq) || (size == 0)
+        || (size > GATE_STREAM_MAX_CHUNK) || (size > remaining))
+    {
+        // Dropped: the pilot sends again from the expected chunk.
+        send_state(NULL);
+        return;
+    }
+
+    while (size > 0)
+    {
+        uint32_t    copy_size   = MAX_DATA_MSG_SIZE - s_stream.msg_fill;
+        if (copy_size > size)
+        {
+            copy_size   = size;
+        }
+
+        memcpy(s_stream.msg.data + s_stream.msg_fill, data, copy_size);
+        s_stream.msg_fill   += copy_size;
+        data                += copy_size;
+        size                -= copy_size;
+
+        if ((s_stream.msg_fill == MAX_DATA_MSG_SIZE)
+            || (s_stream.sent + s_stream.msg_fill == s_stream.size))
+        {
+            send_msg();
+        }
+    }
+
+    s_stream.next_seq++;
+    s_stream.ack_pending    = true;
+}
+
+void stream_poll(void)
+{
+    if (!s_stream.ack_pending || (Luos_TxComplete() == FAILED))
+    {
+        return;
+    }
+
+    s_stream.ack_pending    = false;
+    send_state(NULL);
+
+    if (s_stream.sent == s_stream.size)
+    {
+        // Every byte was sent.
+        s_stream.open   = false;
+    }
+}
+
+bool stream_is_busy(void)
+{
+    return s_stream.ack_pending;
+}
+
+static void send_state(const char* error)
+{
+    char    json[80];
+
+    if (error != NULL)
+    {
+        snprintf(json, sizeof(json), "{\"stream\":{\"error\":\"%s\"}}\n",
+                 error);
+    }
+    else if (s_stream.open && (s_stream.sent == s_stream.size))
+    {
+        snprintf(json, sizeof(json), "{\"stream\":{\"next\":%lu,\"done\":true}}\n",
+                 (unsigned long)s_stream.next_seq);
+    }
+    else
+    {
+        snprintf(json, sizeof(json),
+                 "{\"stream\":{\"next\":%lu,\"window\":%u,\"chunk\":%u}}\n",
+                 (unsigned long)s_stream.next_seq,
+                 (unsigned int)GATE_STREAM_WINDOW,
+                 (unsigned int)GATE_STREAM_MAX_CHUNK);
+    }
+
+    json_send(json);
+}
+
+static void send_msg(void)
+{
+    // Remaining size of the data, so that the container gathers the messages.
+    s_stream.msg.header.size    = s_stream.size - s_stream.sent;
+
+    // Flow control keeps the wait short: the pilot waits for acknowledgements.
+    while (Luos_SendMsg(s_stream.container, &s_stream.msg) == FAILED)
+        ;
+
+    s_stream.sent       += s_stream.msg_fill;
+    s_stream.msg_fill   = 0;
+}
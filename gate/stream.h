@@ -0,0 +1,52 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>        // bool
+#include <stdint.h>         // uint*_t
+
+// LUOS
+#include "luos.h"           // container_t
+
+/*      DEFINES                                                     */
+
+/* Number of chunks the pilot may send ahead of the last acknowledged
+** one.
+*/
+#ifndef GATE_STREAM_WINDOW
+#define GATE_STREAM_WINDOW      2
+#endif /* ! GATE_STREAM_WINDOW */
+
+// Maximum size in bytes of a chunk.
+#ifndef GATE_STREAM_MAX_CHUNK
+#define GATE_STREAM_MAX_CHUNK   1024
+#endif /* ! GATE_STREAM_MAX_CHUNK */
+
+// Maximum size in bytes of a stream, bounded by the Luos message size.
+#define GATE_STREAM_MAX_SIZE    UINT16_MAX
+
+/* Opens a stream of the given size to the given container, whose data
+** is forwarded with the given command, replacing the current stream.
+** The pilot is told the first expected chunk, or the error: a negative
+** command means the container or its key does not accept binary data.
+*/
+void stream_open(container_t* container, uint16_t target, int16_t cmd,
+                 uint32_t size);
+
+/* Forwards the given chunk of the current stream to its container if it
+** is the expected one. It is acknowledged once sent, otherwise the pilot
+** is told the expected chunk.
+*/
+void stream_chunk(uint32_t seq, const uint8_t* data, uint32_t size);
+
+/* Acknowledges the forwarded chunks once sent on the Luos network.
+** Shall be called from the main loop.
+*/
+void stream_poll(void);
+
+// Returns true if forwarded chunks wait for their acknowledgement.
+bool stream_is_busy(void);
+
+#endif /* ! STREAM_H */
@@ -0,0 +1,86 @@
+/* Host stand-in for the Mesh SDK access layer: models are added to the
+** node, and published or replied messages are handed to the simulated
+** medium (see sim_node.h).
+*/
+#ifndef ACCESS_H
+#define ACCESS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "nrf_mesh.h"
+#include "sdk_errors.h"
+
+#define ACCESS_OPCODE_VENDOR(opcode, company) { (opcode), (company) }
+#define ACCESS_MODEL_VENDOR(id, company) { .model_id = (id), .company_id = (company) }
+
+typedef uint16_t access_model_handle_t;
+
+typedef struct
+{
+    uint16_t opcode;
+    uint16_t company_id;
+} access_opcode_t;
+
+typedef struct
+{
+    uint16_t model_id;
+    uint16_t company_id;
+} access_model_id_t;
+
+typedef struct
+{
+    access_opcode_t opcode;
+    const uint8_t *p_buffer;
+    uint16_t length;
+    bool force_segmented;
+    nrf_mesh_transmic_size_t transmic_size;
+    nrf_mesh_tx_token_t access_token;
+} access_message_tx_t;
+
+typedef struct
+{
+    nrf_mesh_address_t src;
+    nrf_mesh_address_t dst;
+    int8_t rssi;
+    uint8_t ttl;
+} access_message_rx_meta_t;
+
+typedef struct
+{
+    access_opcode_t opcode;
+    const uint8_t *p_data;
+    uint16_t length;
+    access_message_rx_meta_t meta_data;
+} access_message_rx_t;
+
+typedef void (*access_opcode_handler_cb_t)(access_model_handle_t handle,
+                                           const access_message_rx_t *p_message,
+                                           void *p_args);
+
+typedef struct
+{
+    access_opcode_t opcode;
+    access_opcode_handler_cb_t handler;
+} access_opcode_handler_t;
+
+typedef void (*access_publish_timeout_cb_t)(access_model_handle_t handle, void *p_args);
+
+typedef struct
+{
+    access_model_id_t model_id;
+    uint16_t element_index;
+    const access_opcode_handler_t *p_opcode_handlers;
+    uint32_t opcode_count;
+    void *p_args;
+    access_publish_timeout_cb_t publish_timeout_cb;
+} access_model_add_params_t;
+
+uint32_t access_model_add(const access_model_add_params_t *p_model_params,
+                          access_model_handle_t *p_model_handle);
+uint32_t access_model_publish(access_model_handle_t handle,
+                              const access_message_tx_t *p_message);
+uint32_t access_model_reply(access_model_handle_t handle,
+                            const access_message_rx_t *p_message,
+                            const access_message_tx_t *p_reply);
+
+#endif /* ! ACCESS_H */
@@ -0,0 +1,10 @@
+// Host stand-in for the Mesh SDK access layer configuration.
+#ifndef ACCESS_CONFIG_H
+#define ACCESS_CONFIG_H
+
+#include <stdint.h>
+#include "access.h"
+
+uint32_t access_model_subscription_list_alloc(access_model_handle_t handle);
+
+#endif /* ! ACCESS_CONFIG_H */
@@ -0,0 +1,10 @@
+// Host stand-in for the nRF5 SDK error check.
+#ifndef APP_ERROR_H
+#define APP_ERROR_H
+
+#include "luos_utils.h"
+#include "sdk_errors.h"
+
+#define APP_ERROR_CHECK(err_code) LUOS_ASSERT((err_code) == NRF_SUCCESS)
+
+#endif /* ! APP_ERROR_H */
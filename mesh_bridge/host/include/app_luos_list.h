@@ -0,0 +1,5 @@
+// Host stand-in for the application types: the Mesh Bridge defaults apply.
+#ifndef APP_LUOS_LIST_H
+#define APP_LUOS_LIST_H
+
+#endif /* ! APP_LUOS_LIST_H */
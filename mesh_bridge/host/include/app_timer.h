@@ -0,0 +1,45 @@
+/* Host stand-in for the nRF5 SDK application timers, scheduled on the
+** virtual clock of the simulation (see app_timer_host.c).
+*/
+#ifndef APP_TIMER_H
+#define APP_TIMER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "sdk_errors.h"
+
+#define APP_TIMER_CLOCK_FREQ 32768
+#define APP_TIMER_TICKS(ms) ((uint32_t)(((uint64_t)(ms) * APP_TIMER_CLOCK_FREQ) / 1000))
+
+typedef enum
+{
+    APP_TIMER_MODE_SINGLE_SHOT,
+    APP_TIMER_MODE_REPEATED
+} app_timer_mode_t;
+
+typedef void (*app_timer_timeout_handler_t)(void *p_context);
+
+typedef struct
+{
+    app_timer_timeout_handler_t handler;
+    app_timer_mode_t mode;
+    bool active;
+    // Incremented on each start and stop, to ignore stale expirations.
+    uint32_t generation;
+    uint32_t ticks;
+    void *context;
+} app_timer_t;
+
+typedef app_timer_t *app_timer_id_t;
+
+#define APP_TIMER_DEF(timer_id)                     \
+    static app_timer_t timer_id##_data = { 0 };     \
+    static const app_timer_id_t timer_id = &timer_id##_data
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler);
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context);
+ret_code_t app_timer_stop(app_timer_id_t timer_id);
+uint32_t app_timer_cnt_get(void);
+
+#endif /* ! APP_TIMER_H */
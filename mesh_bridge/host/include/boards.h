@@ -0,0 +1,17 @@
+// Host stand-in for the board LEDs: simulated nodes have none.
+#ifndef BOARDS_H
+#define BOARDS_H
+
+#include <stdint.h>
+
+static inline void bsp_board_led_on(uint32_t led_idx)
+{
+    (void)led_idx;
+}
+
+static inline void bsp_board_led_off(uint32_t led_idx)
+{
+    (void)led_idx;
+}
+
+#endif /* ! BOARDS_H */
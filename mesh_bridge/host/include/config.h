@@ -0,0 +1,9 @@
+// Host stand-in for the Luos configuration constants.
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#define MAX_ALIAS_SIZE 16
+#define MAX_DATA_MSG_SIZE 128
+#define BROADCAST_VAL 0x0FFF
+
+#endif /* ! CONFIG_H */
@@ -0,0 +1,17 @@
+// Host stand-in for the Mesh SDK configuration server events.
+#ifndef CONFIG_SERVER_EVENTS_H
+#define CONFIG_SERVER_EVENTS_H
+
+typedef enum
+{
+    CONFIG_SERVER_EVT_NODE_RESET,
+} config_server_evt_type_t;
+
+typedef struct
+{
+    config_server_evt_type_t type;
+} config_server_evt_t;
+
+typedef void (*config_server_evt_cb_t)(const config_server_evt_t *p_evt);
+
+#endif /* ! CONFIG_SERVER_EVENTS_H */
@@ -0,0 +1,15 @@
+// Host stand-in for the Mesh SDK device state manager.
+#ifndef DEVICE_STATE_MANAGER_H
+#define DEVICE_STATE_MANAGER_H
+
+#include <stdint.h>
+
+typedef struct
+{
+    uint16_t address_start;
+    uint16_t count;
+} dsm_local_unicast_address_t;
+
+void dsm_local_unicast_addresses_get(dsm_local_unicast_address_t *p_address);
+
+#endif /* ! DEVICE_STATE_MANAGER_H */
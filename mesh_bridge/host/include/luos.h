@@ -0,0 +1,38 @@
+/* Host stand-in for the Luos API, on a single Luos node per simulated
+** Mesh node (see luos_host.c).
+*/
+#ifndef LUOS_H
+#define LUOS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+#include "luos_list.h"
+#include "robus_struct.h"
+#include "routing_table.h"
+
+typedef enum
+{
+    SUCCEED,
+    FAILED
+} error_return_t;
+
+typedef union
+{
+    struct __attribute__((__packed__))
+    {
+        uint8_t major;
+        uint8_t minor;
+        uint8_t build;
+    };
+    uint8_t unmap[3];
+} revision_t;
+
+container_t *Luos_CreateContainer(void (*cont_cb)(container_t *container, msg_t *msg),
+                                  uint8_t type, const char *alias, revision_t revision);
+void Luos_DestroyContainer(container_t *container);
+error_return_t Luos_SendMsg(container_t *container, msg_t *msg);
+uint32_t Luos_GetSystick(void);
+void Luos_Loop(void);
+
+#endif /* ! LUOS_H */
@@ -0,0 +1,31 @@
+/* Host stand-in for the Luos container types and commands used by the
+** Mesh Bridge and the simulated containers.
+*/
+#ifndef LUOS_LIST_H
+#define LUOS_LIST_H
+
+// Container types.
+typedef enum
+{
+    VOID_MOD,
+    GATE_MOD,
+    STATE_MOD,
+    LUOS_LAST_TYPE
+} luos_type_t;
+
+// Container commands.
+enum
+{
+    ASSERT,
+    ASK_PUB_CMD,
+    REVISION,
+    LUOS_REVISION,
+    LUOS_STATISTICS,
+    NODE_UUID,
+    WRITE_ALIAS,
+    SETID,
+    IO_STATE,
+    LUOS_PROTOCOL_NB
+};
+
+#endif /* ! LUOS_LIST_H */
@@ -0,0 +1,21 @@
+/* Host stand-in for the Luos assertion, kept in release builds so that
+** the tests and the simulation stop on the first broken invariant.
+*/
+#ifndef LUOS_UTILS_H
+#define LUOS_UTILS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LUOS_ASSERT(expr)                                               \
+    do                                                                  \
+    {                                                                   \
+        if (!(expr))                                                    \
+        {                                                               \
+            fprintf(stderr, "%s:%d: assertion failed: %s\n", __FILE__,  \
+                    __LINE__, #expr);                                   \
+            abort();                                                    \
+        }                                                               \
+    } while (0)
+
+#endif /* ! LUOS_UTILS_H */
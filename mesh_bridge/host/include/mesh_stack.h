@@ -0,0 +1,7 @@
+// Host stand-in for the Mesh SDK stack initialization types.
+#ifndef MESH_STACK_H
+#define MESH_STACK_H
+
+typedef void (*mesh_stack_models_init_cb_t)(void);
+
+#endif /* ! MESH_STACK_H */
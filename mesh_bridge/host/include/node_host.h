@@ -0,0 +1,31 @@
+/* State shared by the host stand-ins of a simulated node, each loaded
+** copy of the node module having its own.
+*/
+#ifndef NODE_HOST_H
+#define NODE_HOST_H
+
+#include <stdint.h>
+#include "access.h"
+#include "sim_node.h"
+
+// Services of the harness, and handle of this node for the harness.
+extern const sim_medium_t *g_sim_medium;
+extern void *g_sim_node;
+
+// Unicast address of this node.
+extern uint16_t g_sim_address;
+
+// Hands an access message received from the medium to the added models.
+void access_host_receive(uint16_t src_addr, uint16_t dst_addr, access_opcode_t opcode,
+                         const uint8_t *data, uint16_t length);
+
+// Forwards a TX complete event to the registered Mesh event handlers.
+void access_host_tx_complete(nrf_mesh_tx_token_t token);
+
+// Returns the number of Luos messages waiting for the next loop.
+uint16_t luos_host_nb_pending(void);
+
+// Returns the number of Luos messages dropped for lack of a target container.
+uint32_t luos_host_nb_unroutable(void);
+
+#endif /* ! NODE_HOST_H */
@@ -0,0 +1,34 @@
+// Host stand-in for the Mesh SDK core types.
+#ifndef NRF_MESH_H
+#define NRF_MESH_H
+
+#include <stdint.h>
+#include "nrf_mesh_defines.h"
+
+typedef uint32_t nrf_mesh_tx_token_t;
+
+typedef enum
+{
+    NRF_MESH_TRANSMIC_SIZE_SMALL,
+    NRF_MESH_TRANSMIC_SIZE_LARGE,
+    NRF_MESH_TRANSMIC_SIZE_DEFAULT,
+} nrf_mesh_transmic_size_t;
+
+typedef enum
+{
+    NRF_MESH_ADDRESS_TYPE_INVALID,
+    NRF_MESH_ADDRESS_TYPE_UNICAST,
+    NRF_MESH_ADDRESS_TYPE_VIRTUAL,
+    NRF_MESH_ADDRESS_TYPE_GROUP,
+} nrf_mesh_address_type_t;
+
+typedef struct
+{
+    nrf_mesh_address_type_t type;
+    uint16_t value;
+    const uint8_t *p_virtual_uuid;
+} nrf_mesh_address_t;
+
+nrf_mesh_tx_token_t nrf_mesh_unique_token_get(void);
+
+#endif /* ! NRF_MESH_H */
@@ -0,0 +1,8 @@
+// Host stand-in for the Mesh SDK protocol constants.
+#ifndef NRF_MESH_DEFINES_H
+#define NRF_MESH_DEFINES_H
+
+// Unsegmented upper transport payload, TransMIC included, as in the SDK.
+#define NRF_MESH_UNSEG_PAYLOAD_SIZE_MAX 15
+
+#endif /* ! NRF_MESH_DEFINES_H */
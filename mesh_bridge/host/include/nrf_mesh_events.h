@@ -0,0 +1,36 @@
+// Host stand-in for the Mesh SDK core events.
+#ifndef NRF_MESH_EVENTS_H
+#define NRF_MESH_EVENTS_H
+
+#include "nrf_mesh.h"
+
+typedef enum
+{
+    NRF_MESH_EVT_MESSAGE_RECEIVED,
+    NRF_MESH_EVT_TX_COMPLETE,
+} nrf_mesh_evt_type_t;
+
+typedef struct
+{
+    nrf_mesh_tx_token_t token;
+} nrf_mesh_evt_tx_complete_t;
+
+typedef struct
+{
+    nrf_mesh_evt_type_t type;
+    union
+    {
+        nrf_mesh_evt_tx_complete_t tx_complete;
+    } params;
+} nrf_mesh_evt_t;
+
+typedef void (*nrf_mesh_evt_handler_cb_t)(const nrf_mesh_evt_t *p_evt);
+
+typedef struct
+{
+    nrf_mesh_evt_handler_cb_t evt_cb;
+} nrf_mesh_evt_handler_t;
+
+void nrf_mesh_evt_handler_add(nrf_mesh_evt_handler_t *p_handler_params);
+
+#endif /* ! NRF_MESH_EVENTS_H */
@@ -0,0 +1,9 @@
+/* Host stand-in for the Mesh SDK provisioning context: simulated nodes
+** start as provisioned.
+*/
+#ifndef NRF_MESH_PROV_H
+#define NRF_MESH_PROV_H
+
+typedef struct nrf_mesh_prov_ctx nrf_mesh_prov_ctx_t;
+
+#endif /* ! NRF_MESH_PROV_H */
@@ -0,0 +1,9 @@
+// Host stand-in for the Mesh SDK provisioning events.
+#ifndef NRF_MESH_PROV_EVENTS_H
+#define NRF_MESH_PROV_EVENTS_H
+
+typedef struct nrf_mesh_prov_evt nrf_mesh_prov_evt_t;
+
+typedef void (*nrf_mesh_prov_evt_handler_cb_t)(const nrf_mesh_prov_evt_t *p_evt);
+
+#endif /* ! NRF_MESH_PROV_EVENTS_H */
@@ -0,0 +1,36 @@
+// Host stand-in for the Luos message structures.
+#ifndef ROBUS_STRUCT_H
+#define ROBUS_STRUCT_H
+
+#include <stdint.h>
+#include "config.h"
+
+// Target modes.
+typedef enum
+{
+    ID,
+    IDACK,
+    TYPE,
+    BROADCAST,
+    MULTICAST,
+    NODEIDACK,
+    NODEID
+} target_mode_t;
+
+typedef struct __attribute__((__packed__))
+{
+    uint16_t protocol : 4;
+    uint16_t target : 12;
+    uint16_t target_mode : 4;
+    uint16_t source : 12;
+    uint8_t cmd;
+    uint16_t size;
+} header_t;
+
+typedef struct __attribute__((__packed__))
+{
+    header_t header;
+    uint8_t data[MAX_DATA_MSG_SIZE];
+} msg_t;
+
+#endif /* ! ROBUS_STRUCT_H */
@@ -0,0 +1,48 @@
+/* Host stand-in for the Luos routing table of a simulated node (see
+** luos_host.c).
+*/
+#ifndef ROUTING_TABLE_H
+#define ROUTING_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "config.h"
+
+#define NBR_PORT 4
+
+typedef enum
+{
+    CLEAR,
+    CONTAINER,
+    NODE
+} entry_mode_t;
+
+typedef struct __attribute__((__packed__))
+{
+    entry_mode_t mode;
+    union
+    {
+        struct __attribute__((__packed__))
+        {
+            uint16_t id;
+            uint8_t type;
+            char alias[MAX_ALIAS_SIZE];
+        };
+        struct __attribute__((__packed__))
+        {
+            uint16_t node_id;
+            uint16_t certified;
+            uint16_t port_table[NBR_PORT];
+        };
+    };
+} routing_table_t;
+
+typedef struct container_t container_t;
+
+routing_table_t *RoutingTB_Get(void);
+uint16_t RoutingTB_GetLastEntry(void);
+void RoutingTB_DetectContainers(container_t *container);
+char *RoutingTB_StringFromType(uint8_t type);
+uint16_t RoutingTB_FindFutureContainerID(uint16_t consumer_id, uint16_t producer_id);
+
+#endif /* ! ROUTING_TABLE_H */
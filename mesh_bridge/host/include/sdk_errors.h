@@ -0,0 +1,14 @@
+// Host stand-in for the nRF5 SDK error codes.
+#ifndef SDK_ERRORS_H
+#define SDK_ERRORS_H
+
+#include <stdint.h>
+
+#define NRF_SUCCESS 0
+#define NRF_ERROR_NO_MEM 4
+#define NRF_ERROR_INVALID_STATE 8
+#define NRF_ERROR_INVALID_PARAM 7
+
+typedef uint32_t ret_code_t;
+
+#endif /* ! SDK_ERRORS_H */
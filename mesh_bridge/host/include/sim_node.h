@@ -0,0 +1,68 @@
+/* Interface between the Mesh simulation harness and a simulated node.
+**
+** A node is a shared module holding the Mesh Bridge sources, the Luos
+** RTB and Luos MSG models and the host stand-ins of the SDKs, so that
+** each loaded copy keeps its own static state. The harness owns the
+** virtual clock and the medium: it gives each node the services below,
+** and calls the node through the table returned by `sim_node_api`.
+*/
+#ifndef SIM_NODE_H
+#define SIM_NODE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "access.h"
+#include "mesh_bridge.h"
+#include "robus_struct.h"
+
+// Largest access payload carried by the simulated medium.
+#define SIM_MAX_ACCESS_PAYLOAD 64
+
+// Function of a node called back by the harness, with its argument and tag.
+typedef void (*sim_node_cb_t)(void *arg, uintptr_t tag);
+
+// Services of the harness, given to each node.
+typedef struct
+{
+    // Current virtual time in microseconds.
+    uint64_t (*now_us)(void);
+    // Calls back the given function of the node after the given delay.
+    void (*schedule)(void *node, uint64_t delay_us, sim_node_cb_t cb, void *arg, uintptr_t tag);
+    // Sends an access message, published to a group or replied to a unicast address.
+    void (*transmit)(void *node, uint16_t src_addr, uint16_t dst_addr, access_opcode_t opcode,
+                     const uint8_t *data, uint16_t length, nrf_mesh_tx_token_t token);
+    // Hands a message received by the application container of the node.
+    void (*app_receive)(void *node, const msg_t *msg);
+} sim_medium_t;
+
+// Functions of a node, called by the harness.
+typedef struct
+{
+    /* Starts the node with the given unicast address: Mesh Bridge and
+    ** application container with the given alias, then detection.
+    */
+    void (*init)(const sim_medium_t *medium, void *node, uint16_t address, const char *app_alias);
+    // Hands an access message received from the medium.
+    void (*receive)(uint16_t src_addr, uint16_t dst_addr, access_opcode_t opcode,
+                    const uint8_t *data, uint16_t length);
+    // Signals the end of the transmission of the message with the given token.
+    void (*tx_complete)(nrf_mesh_tx_token_t token);
+    // Runs the Luos and Mesh Bridge loops until no local message is pending.
+    void (*loop)(void);
+    // Sends a message from the application container to the Mesh Bridge container.
+    void (*bridge_send)(uint8_t cmd, const void *data, uint16_t size);
+    // Sends a message from the application container to the container with the given ID, in ID or IDACK mode.
+    void (*app_send)(uint16_t target, uint8_t target_mode, uint8_t cmd, const void *data, uint16_t size);
+    // Returns the ID of the container with the given alias, 0 if not in the routing table.
+    uint16_t (*find_id)(const char *alias);
+    // Copies the runtime statistics of the Mesh Bridge.
+    void (*stats)(mesh_bridge_stats_t *stats);
+    // Returns the number of local messages dropped for lack of a target container.
+    uint32_t (*nb_unroutable)(void);
+} sim_node_api_t;
+
+// Only exported symbol of a node module.
+typedef const sim_node_api_t *(*sim_node_api_get_t)(void);
+#define SIM_NODE_API_SYMBOL "sim_node_api"
+
+#endif /* ! SIM_NODE_H */
@@ -0,0 +1,126 @@
+/* Access layer and Mesh core stand-ins of a simulated node: published
+** and replied messages go to the medium of the harness, and received
+** ones are dispatched to the opcode handlers of the added models.
+*/
+#include <string.h>
+#include "access.h"
+#include "access_config.h"
+#include "luos_mesh_common.h"
+#include "luos_utils.h"
+#include "node_host.h"
+#include "nrf_mesh.h"
+#include "nrf_mesh_events.h"
+
+#define ACCESS_HOST_MAX_MODELS 4
+#define ACCESS_HOST_MAX_EVT_HANDLERS 4
+
+static access_model_add_params_t models[ACCESS_HOST_MAX_MODELS];
+static uint16_t nb_models = 0;
+
+static nrf_mesh_evt_handler_t *evt_handlers[ACCESS_HOST_MAX_EVT_HANDLERS];
+static uint16_t nb_evt_handlers = 0;
+
+static nrf_mesh_tx_token_t last_token = 0;
+
+static uint16_t element_address(access_model_handle_t handle)
+{
+    LUOS_ASSERT(handle < nb_models);
+    return g_sim_address + models[handle].element_index;
+}
+
+uint32_t access_model_add(const access_model_add_params_t *p_model_params,
+                          access_model_handle_t *p_model_handle)
+{
+    if (nb_models >= ACCESS_HOST_MAX_MODELS)
+    {
+        return NRF_ERROR_NO_MEM;
+    }
+    models[nb_models] = *p_model_params;
+    *p_model_handle = nb_models++;
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_subscription_list_alloc(access_model_handle_t handle)
+{
+    // Every model is subscribed to the Luos group.
+    return (handle < nb_models) ? NRF_SUCCESS : NRF_ERROR_INVALID_PARAM;
+}
+
+uint32_t access_model_publish(access_model_handle_t handle, const access_message_tx_t *p_message)
+{
+    if (p_message->length > SIM_MAX_ACCESS_PAYLOAD)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    g_sim_medium->transmit(g_sim_node, element_address(handle), LUOS_GROUP_ADDRESS,
+                           p_message->opcode, p_message->p_buffer, p_message->length,
+                           p_message->access_token);
+    return NRF_SUCCESS;
+}
+
+uint32_t access_model_reply(access_model_handle_t handle, const access_message_rx_t *p_message,
+                            const access_message_tx_t *p_reply)
+{
+    if (p_reply->length > SIM_MAX_ACCESS_PAYLOAD)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    g_sim_medium->transmit(g_sim_node, element_address(handle), p_message->meta_data.src.value,
+                           p_reply->opcode, p_reply->p_buffer, p_reply->length,
+                           p_reply->access_token);
+    return NRF_SUCCESS;
+}
+
+void access_host_receive(uint16_t src_addr, uint16_t dst_addr, access_opcode_t opcode,
+                         const uint8_t *data, uint16_t length)
+{
+    access_message_rx_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.opcode = opcode;
+    msg.p_data = data;
+    msg.length = length;
+    msg.meta_data.src.type = NRF_MESH_ADDRESS_TYPE_UNICAST;
+    msg.meta_data.src.value = src_addr;
+    msg.meta_data.dst.type = (dst_addr == LUOS_GROUP_ADDRESS) ? NRF_MESH_ADDRESS_TYPE_GROUP : NRF_MESH_ADDRESS_TYPE_UNICAST;
+    msg.meta_data.dst.value = dst_addr;
+
+    for (access_model_handle_t handle = 0; handle < nb_models; handle++)
+    {
+        const access_model_add_params_t *model = models + handle;
+        if (dst_addr != LUOS_GROUP_ADDRESS && dst_addr != element_address(handle))
+        {
+            continue;
+        }
+        for (uint32_t i = 0; i < model->opcode_count; i++)
+        {
+            const access_opcode_handler_t *handler = model->p_opcode_handlers + i;
+            if (handler->opcode.opcode == opcode.opcode && handler->opcode.company_id == opcode.company_id)
+            {
+                handler->handler(handle, &msg, model->p_args);
+            }
+        }
+    }
+}
+
+void nrf_mesh_evt_handler_add(nrf_mesh_evt_handler_t *p_handler_params)
+{
+    LUOS_ASSERT(nb_evt_handlers < ACCESS_HOST_MAX_EVT_HANDLERS);
+    evt_handlers[nb_evt_handlers++] = p_handler_params;
+}
+
+nrf_mesh_tx_token_t nrf_mesh_unique_token_get(void)
+{
+    return ++last_token;
+}
+
+void access_host_tx_complete(nrf_mesh_tx_token_t token)
+{
+    nrf_mesh_evt_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.type = NRF_MESH_EVT_TX_COMPLETE;
+    evt.params.tx_complete.token = token;
+    for (uint16_t i = 0; i < nb_evt_handlers; i++)
+    {
+        evt_handlers[i]->evt_cb(&evt);
+    }
+}
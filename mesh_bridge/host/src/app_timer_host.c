@@ -0,0 +1,72 @@
+/* Application timers of a simulated node: each start schedules an
+** expiration on the virtual clock of the harness, which is ignored if
+** the timer was stopped or restarted in the meantime.
+*/
+#include <stddef.h>
+#include "app_timer.h"
+#include "node_host.h"
+
+static uint64_t ticks_to_us(uint32_t ticks)
+{
+    return ((uint64_t)ticks * 1000000u + APP_TIMER_CLOCK_FREQ - 1) / APP_TIMER_CLOCK_FREQ;
+}
+
+static void timer_expire(void *arg, uintptr_t generation)
+{
+    app_timer_t *timer = (app_timer_t *)arg;
+    if (!timer->active || timer->generation != (uint32_t)generation)
+    {
+        // Stopped or restarted since.
+        return;
+    }
+    if (timer->mode == APP_TIMER_MODE_REPEATED)
+    {
+        g_sim_medium->schedule(g_sim_node, ticks_to_us(timer->ticks), timer_expire, timer, timer->generation);
+    }
+    else
+    {
+        timer->active = false;
+    }
+    timer->handler(timer->context);
+}
+
+ret_code_t app_timer_create(app_timer_id_t const *p_timer_id, app_timer_mode_t mode,
+                            app_timer_timeout_handler_t timeout_handler)
+{
+    if (timeout_handler == NULL)
+    {
+        return NRF_ERROR_INVALID_PARAM;
+    }
+    app_timer_t *timer = *p_timer_id;
+    timer->handler = timeout_handler;
+    timer->mode = mode;
+    timer->active = false;
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_start(app_timer_id_t timer_id, uint32_t timeout_ticks, void *p_context)
+{
+    if (timer_id->handler == NULL || timeout_ticks == 0)
+    {
+        return NRF_ERROR_INVALID_STATE;
+    }
+    timer_id->generation++;
+    timer_id->active = true;
+    timer_id->ticks = timeout_ticks;
+    timer_id->context = p_context;
+    g_sim_medium->schedule(g_sim_node, ticks_to_us(timeout_ticks), timer_expire, timer_id, timer_id->generation);
+    return NRF_SUCCESS;
+}
+
+ret_code_t app_timer_stop(app_timer_id_t timer_id)
+{
+    timer_id->generation++;
+    timer_id->active = false;
+    return NRF_SUCCESS;
+}
+
+uint32_t app_timer_cnt_get(void)
+{
+    // 24-bit RTC counter.
+    return (uint32_t)((g_sim_medium->now_us() * APP_TIMER_CLOCK_FREQ) / 1000000u) & 0xFFFFFF;
+}
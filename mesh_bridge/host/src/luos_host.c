@@ -0,0 +1,208 @@
+/* Luos stand-in of a simulated node: a single Luos node holding the
+** Mesh Bridge, the application container and the local instances of
+** remote containers. Messages between them are queued by Luos_SendMsg
+** and dispatched by Luos_Loop; detection numbers the containers in
+** creation order.
+*/
+#include <stdlib.h>
+#include <string.h>
+#include "luos.h"
+#include "luos_utils.h"
+#include "mesh_bridge.h"
+#include "node_host.h"
+
+#define LUOS_HOST_MAX_CONTAINERS 32
+#define LUOS_HOST_MSG_QUEUE_SIZE 64
+
+struct container_t
+{
+    void (*cont_cb)(container_t *container, msg_t *msg);
+    uint8_t type;
+    char alias[MAX_ALIAS_SIZE];
+    uint16_t id;
+};
+
+// Live containers, in creation order.
+static container_t *containers[LUOS_HOST_MAX_CONTAINERS];
+static uint16_t nb_containers = 0;
+
+static routing_table_t routing_table[LUOS_HOST_MAX_CONTAINERS + 1];
+static uint16_t last_entry = 0;
+
+static msg_t msg_queue[LUOS_HOST_MSG_QUEUE_SIZE];
+static uint16_t msg_head = 0;
+static uint16_t msg_tail = 0;
+
+static uint32_t nb_unroutable = 0;
+
+container_t *Luos_CreateContainer(void (*cont_cb)(container_t *container, msg_t *msg),
+                                  uint8_t type, const char *alias, revision_t revision)
+{
+    (void)revision;
+    LUOS_ASSERT(nb_containers < LUOS_HOST_MAX_CONTAINERS);
+    container_t *container = calloc(1, sizeof(container_t));
+    LUOS_ASSERT(container != NULL);
+    container->cont_cb = cont_cb;
+    container->type = type;
+    strncpy(container->alias, alias, MAX_ALIAS_SIZE - 1);
+    containers[nb_containers++] = container;
+    return container;
+}
+
+void Luos_DestroyContainer(container_t *container)
+{
+    for (uint16_t i = 0; i < nb_containers; i++)
+    {
+        if (containers[i] == container)
+        {
+            memmove(containers + i, containers + i + 1, (nb_containers - i - 1) * sizeof(container_t *));
+            nb_containers--;
+            free(container);
+            return;
+        }
+    }
+    LUOS_ASSERT(false);
+}
+
+error_return_t Luos_SendMsg(container_t *container, msg_t *msg)
+{
+    uint16_t next = (msg_head + 1) % LUOS_HOST_MSG_QUEUE_SIZE;
+    if (next == msg_tail)
+    {
+        nb_unroutable++;
+        return FAILED;
+    }
+    msg->header.source = container->id;
+    msg_queue[msg_head] = *msg;
+    msg_head = next;
+    return SUCCEED;
+}
+
+uint32_t Luos_GetSystick(void)
+{
+    return (uint32_t)(g_sim_medium->now_us() / 1000u);
+}
+
+static container_t *container_from_id(uint16_t id)
+{
+    for (uint16_t i = 0; i < nb_containers; i++)
+    {
+        if (id != 0 && containers[i]->id == id)
+        {
+            return containers[i];
+        }
+    }
+    return NULL;
+}
+
+void Luos_Loop(void)
+{
+    while (msg_tail != msg_head)
+    {
+        msg_t msg = msg_queue[msg_tail];
+        msg_tail = (msg_tail + 1) % LUOS_HOST_MSG_QUEUE_SIZE;
+
+        switch (msg.header.target_mode)
+        {
+        case ID:
+        case IDACK:
+        {
+            container_t *target = container_from_id(msg.header.target);
+            if (target == NULL)
+            {
+                nb_unroutable++;
+                break;
+            }
+            target->cont_cb(target, &msg);
+        }
+        break;
+
+        case BROADCAST:
+            // Handlers may create or destroy containers: iterate on a copy.
+        {
+            container_t *targets[LUOS_HOST_MAX_CONTAINERS];
+            uint16_t nb_targets = nb_containers;
+            memcpy(targets, containers, nb_targets * sizeof(container_t *));
+            for (uint16_t i = 0; i < nb_targets; i++)
+            {
+                if (targets[i]->id != msg.header.source && container_from_id(targets[i]->id) == targets[i])
+                {
+                    targets[i]->cont_cb(targets[i], &msg);
+                }
+            }
+        }
+        break;
+
+        default:
+            nb_unroutable++;
+            break;
+        }
+    }
+}
+
+uint16_t luos_host_nb_pending(void)
+{
+    return (uint16_t)((msg_head + LUOS_HOST_MSG_QUEUE_SIZE - msg_tail) % LUOS_HOST_MSG_QUEUE_SIZE);
+}
+
+uint32_t luos_host_nb_unroutable(void)
+{
+    return nb_unroutable;
+}
+
+routing_table_t *RoutingTB_Get(void)
+{
+    return routing_table;
+}
+
+uint16_t RoutingTB_GetLastEntry(void)
+{
+    return last_entry;
+}
+
+void RoutingTB_DetectContainers(container_t *container)
+{
+    (void)container;
+    memset(routing_table, 0, sizeof(routing_table));
+    routing_table[0].mode = NODE;
+    routing_table[0].node_id = 1;
+    routing_table[0].certified = 1;
+    for (uint16_t i = 0; i < nb_containers; i++)
+    {
+        routing_table_t *entry = routing_table + 1 + i;
+        containers[i]->id = i + 1;
+        entry->mode = CONTAINER;
+        entry->id = containers[i]->id;
+        entry->type = containers[i]->type;
+        memcpy(entry->alias, containers[i]->alias, MAX_ALIAS_SIZE);
+    }
+    last_entry = nb_containers + 1;
+}
+
+uint16_t RoutingTB_FindFutureContainerID(uint16_t consumer_id, uint16_t producer_id)
+{
+    (void)producer_id;
+    /* With a single Luos node, the detecting container is on the first
+    ** node and detection keeps the creation order: IDs are only shifted
+    ** by destroyed containers, which the Mesh Bridge already accounts
+    ** for.
+    */
+    return consumer_id;
+}
+
+char *RoutingTB_StringFromType(uint8_t type)
+{
+    switch (type)
+    {
+    case VOID_MOD:
+        return "void";
+    case GATE_MOD:
+        return "gate";
+    case STATE_MOD:
+        return "state";
+    case MESH_BRIDGE_MOD:
+        return "mesh_bridge";
+    default:
+        return "unknown";
+    }
+}
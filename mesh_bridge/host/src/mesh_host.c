@@ -0,0 +1,50 @@
+/* Mesh stack and provisioning stand-ins of a simulated node: nodes are
+** provisioned from the start, with the unicast address given by the
+** harness.
+*/
+#include <stdbool.h>
+#include "device_state_manager.h"
+#include "luos_mesh_common.h"
+#include "node_host.h"
+#include "provisioning.h"
+
+void _mesh_init(config_server_evt_cb_t cfg_srv_cb, mesh_stack_models_init_cb_t models_init_cb,
+                bool *device_provisioned)
+{
+    (void)cfg_srv_cb;
+    models_init_cb();
+    *device_provisioned = true;
+}
+
+void _provisioning_init(nrf_mesh_prov_ctx_t *prov_ctx, nrf_mesh_prov_evt_handler_cb_t event_handler)
+{
+    (void)prov_ctx;
+    (void)event_handler;
+}
+
+void mesh_start(void)
+{
+}
+
+void encryption_keys_generate(void)
+{
+}
+
+void auth_data_provide(nrf_mesh_prov_ctx_t *prov_ctx)
+{
+    (void)prov_ctx;
+}
+
+void provisioning_init(void)
+{
+}
+
+void prov_listening_start(void)
+{
+}
+
+void dsm_local_unicast_addresses_get(dsm_local_unicast_address_t *p_address)
+{
+    p_address->address_start = g_sim_address;
+    p_address->count = 1;
+}
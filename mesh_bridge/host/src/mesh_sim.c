@@ -0,0 +1,896 @@
+/* Runs several Mesh Bridges in one process, on a simulated Mesh medium
+** with configurable latency, loss and TX complete timing, then reports
+** the duration of their routing table exchanges and the latency and
+** throughput of messages sent between their application containers.
+**
+** Workload payload size, destination count, target mode and burst size
+** accept comma-separated lists: a run with fresh nodes is done for each
+** combination, then a summary row is printed for each run.
+**
+** Each node is a copy of the node module, loaded on its own so that it
+** keeps its own static state. Time is virtual: events are run in order
+** from a heap, and a run only depends on its options and seed.
+*/
+#include <dlfcn.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "luos_list.h"
+#include "luos_mesh_common.h"
+#include "luos_mesh_msg.h"
+#include "mesh_bridge.h"
+#include "sim_node.h"
+
+#ifndef MESH_SIM_NODE_PATH
+#define MESH_SIM_NODE_PATH "mesh_sim_node.so"
+#endif
+
+// Addresses of the nodes fit in the 4 bits of a Luos MSG destination.
+#define MAX_NODES LUOS_MESH_NETWORK_MAX_NODES
+
+// Command and minimum size of the workload messages, carrying a 24-bit message index.
+#define WORKLOAD_CMD IO_STATE
+#define WORKLOAD_MIN_SIZE 3
+#define MAX_MESSAGES (1u << 24)
+
+// Values of a swept option.
+#define MAX_SWEEP_VALUES 8
+#define MAX_RUNS (MAX_SWEEP_VALUES * MAX_SWEEP_VALUES * MAX_SWEEP_VALUES * MAX_SWEEP_VALUES)
+
+// Payload size of an unsegmented access message, and of a segment.
+#define UNSEG_PAYLOAD_MAX 11
+#define SEG_PAYLOAD_MAX 12
+#define VENDOR_OPCODE_SIZE 3
+
+// Time given to each step of the scenario to complete.
+#define EXT_RTB_TIMEOUT_US (60u * 1000000u)
+#define DRAIN_TIMEOUT_US (60u * 1000000u)
+
+typedef struct
+{
+    uint32_t values[MAX_SWEEP_VALUES];
+    uint16_t nb_values;
+} sweep_t;
+
+typedef struct
+{
+    uint16_t nb_nodes;
+    uint64_t latency_us;
+    uint64_t jitter_us;
+    double loss;
+    uint64_t tx_complete_us;
+    uint32_t nb_messages;
+    uint64_t interval_us;
+    uint64_t seed;
+    double min_delivery;
+    const char *node_path;
+    // Swept workload parameters.
+    sweep_t payload_size;
+    sweep_t nb_destinations;
+    sweep_t target_mode;
+    sweep_t burst;
+} options_t;
+
+// Workload parameters of a run, one of the swept combinations.
+typedef struct
+{
+    uint16_t payload_size;
+    uint16_t nb_destinations;
+    uint8_t target_mode;
+    uint16_t burst;
+} workload_t;
+
+// Results of a run, summarized once every run is done.
+typedef struct
+{
+    workload_t workload;
+    uint32_t nb_sent;
+    uint32_t nb_delivered;
+    double p50_ms;
+    double p99_ms;
+    double throughput;
+    uint16_t queue_high_water;
+    uint32_t nb_enqueue_failures;
+    bool passed;
+} run_result_t;
+
+typedef struct
+{
+    uint16_t index;
+    const sim_node_api_t *api;
+    void *handle;
+    uint16_t nb_filled;
+    bool rtb_complete;
+    uint64_t rtb_complete_us;
+    // ID of the application container of each node in the routing table of this one.
+    uint16_t app_ids[MAX_NODES];
+} node_t;
+
+typedef enum
+{
+    EVT_NODE_CB,
+    EVT_DELIVER,
+    EVT_TX_COMPLETE,
+    EVT_APP_SEND
+} event_type_t;
+
+typedef struct
+{
+    uint64_t time_us;
+    // Insertion order, so that events at the same time run in a reproducible order.
+    uint64_t seq;
+    event_type_t type;
+    node_t *node;
+    union
+    {
+        struct
+        {
+            sim_node_cb_t cb;
+            void *arg;
+            uintptr_t tag;
+        } call;
+        struct
+        {
+            uint16_t src_addr;
+            uint16_t dst_addr;
+            access_opcode_t opcode;
+            uint16_t length;
+            uint8_t data[SIM_MAX_ACCESS_PAYLOAD];
+        } packet;
+        nrf_mesh_tx_token_t token;
+        struct
+        {
+            uint16_t dst_node;
+            uint32_t msg_idx;
+        } send;
+    };
+} event_t;
+
+static options_t options = {
+    .nb_nodes = 3,
+    .latency_us = 8000,
+    .jitter_us = 8000,
+    .loss = 0.0,
+    .tx_complete_us = 15000,
+    .nb_messages = 500,
+    .interval_us = 100000,
+    .seed = 1,
+    .min_delivery = 0.0,
+    .node_path = MESH_SIM_NODE_PATH,
+    .payload_size = {.values = {WORKLOAD_MIN_SIZE}, .nb_values = 1},
+    .nb_destinations = {.values = {1}, .nb_values = 1},
+    .target_mode = {.values = {ID}, .nb_values = 1},
+    .burst = {.values = {1}, .nb_values = 1},
+};
+
+static workload_t workload;
+static run_result_t results[MAX_RUNS];
+static uint32_t nb_runs = 0;
+
+static node_t nodes[MAX_NODES];
+static uint64_t now = 0;
+static uint64_t random_state = 1;
+
+static event_t *events = NULL;
+static uint32_t nb_events = 0;
+static uint32_t events_size = 0;
+static uint64_t next_seq = 0;
+
+// Workload messages: send time, number of deliveries and latency.
+static uint64_t *msg_sent_us = NULL;
+static uint16_t *msg_received = NULL;
+static uint64_t *latencies_us = NULL;
+static uint32_t nb_latencies = 0;
+static uint32_t nb_duplicated = 0;
+static uint64_t first_send_us = 0;
+static uint64_t last_delivery_us = 0;
+
+// Medium counters.
+static uint32_t nb_transmitted = 0;
+static uint32_t nb_lost = 0;
+
+static uint64_t random_u64(void)
+{
+    random_state ^= random_state >> 12;
+    random_state ^= random_state << 25;
+    random_state ^= random_state >> 27;
+    return random_state * 2685821657736338717ull;
+}
+
+// Uniform in [0, 1)
+static double random_unit(void)
+{
+    return (double)(random_u64() >> 11) / 9007199254740992.0;
+}
+
+static bool event_before(const event_t *a, const event_t *b)
+{
+    return (a->time_us < b->time_us) || (a->time_us == b->time_us && a->seq < b->seq);
+}
+
+static event_t *event_push(uint64_t time_us, event_type_t type, node_t *node)
+{
+    if (nb_events == events_size)
+    {
+        events_size = events_size ? events_size * 2 : 256;
+        events = realloc(events, events_size * sizeof(event_t));
+        if (events == NULL)
+        {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    event_t evt;
+    memset(&evt, 0, sizeof(evt));
+    evt.time_us = time_us;
+    evt.seq = next_seq++;
+    evt.type = type;
+    evt.node = node;
+    // Sift up, the caller fills the event in place once its position is known.
+    uint32_t i = nb_events++;
+    while (i > 0 && event_before(&evt, events + (i - 1) / 2))
+    {
+        events[i] = events[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    events[i] = evt;
+    return events + i;
+}
+
+static event_t event_pop(void)
+{
+    event_t top = events[0];
+    event_t last = events[--nb_events];
+    uint32_t i = 0;
+    while (true)
+    {
+        uint32_t child = 2 * i + 1;
+        if (child >= nb_events)
+        {
+            break;
+        }
+        if (child + 1 < nb_events && event_before(events + child + 1, events + child))
+        {
+            child++;
+        }
+        if (!event_before(events + child, &last))
+        {
+            break;
+        }
+        events[i] = events[child];
+        i = child;
+    }
+    if (nb_events > 0)
+    {
+        events[i] = last;
+    }
+    return top;
+}
+
+static uint64_t medium_now_us(void)
+{
+    return now;
+}
+
+static void medium_schedule(void *node, uint64_t delay_us, sim_node_cb_t cb, void *arg, uintptr_t tag)
+{
+    event_t *evt = event_push(now + delay_us, EVT_NODE_CB, (node_t *)node);
+    evt->call.cb = cb;
+    evt->call.arg = arg;
+    evt->call.tag = tag;
+}
+
+static node_t *node_from_address(uint16_t address)
+{
+    return (address >= 1 && address <= options.nb_nodes) ? nodes + address - 1 : NULL;
+}
+
+// Number of segments of an access message, 1 if unsegmented
+static uint16_t nb_segments(uint16_t length)
+{
+    uint16_t payload = length + VENDOR_OPCODE_SIZE;
+    return (payload <= UNSEG_PAYLOAD_MAX) ? 1 : (payload + SEG_PAYLOAD_MAX - 1) / SEG_PAYLOAD_MAX;
+}
+
+static void medium_transmit(void *node, uint16_t src_addr, uint16_t dst_addr, access_opcode_t opcode,
+                            const uint8_t *data, uint16_t length, nrf_mesh_tx_token_t token)
+{
+    node_t *sender = (node_t *)node;
+    uint16_t segments = nb_segments(length);
+    nb_transmitted++;
+
+    // The sender is told its message is out once every segment was sent.
+    event_t *done = event_push(now + options.tx_complete_us * segments, EVT_TX_COMPLETE, sender);
+    done->token = token;
+
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        node_t *receiver = nodes + i;
+        if (receiver == sender || (dst_addr != LUOS_GROUP_ADDRESS && receiver != node_from_address(dst_addr)))
+        {
+            continue;
+        }
+        // A segmented message is lost with any of its segments.
+        bool lost = false;
+        for (uint16_t s = 0; s < segments; s++)
+        {
+            lost |= random_unit() < options.loss;
+        }
+        if (lost)
+        {
+            nb_lost++;
+            continue;
+        }
+        uint64_t arrival = now + options.tx_complete_us * (segments - 1) + options.latency_us
+                           + (uint64_t)(random_unit() * (double)options.jitter_us);
+        event_t *evt = event_push(arrival, EVT_DELIVER, receiver);
+        evt->packet.src_addr = src_addr;
+        evt->packet.dst_addr = dst_addr;
+        evt->packet.opcode = opcode;
+        evt->packet.length = length;
+        memcpy(evt->packet.data, data, length);
+    }
+}
+
+static void medium_app_receive(void *node, const msg_t *msg)
+{
+    node_t *receiver = (node_t *)node;
+    switch (msg->header.cmd)
+    {
+    case MESH_BRIDGE_LOCAL_CONTAINER_TABLE_FILLED:
+        memcpy(&receiver->nb_filled, msg->data, sizeof(uint16_t));
+        break;
+
+    case MESH_BRIDGE_EXT_RTB_COMPLETE:
+        receiver->rtb_complete = true;
+        receiver->rtb_complete_us = now;
+        break;
+
+    case WORKLOAD_CMD:
+    {
+        if (msg->header.size != workload.payload_size)
+        {
+            break;
+        }
+        uint32_t msg_idx = msg->data[0] | (msg->data[1] << 8) | ((uint32_t)msg->data[2] << 16);
+        if (msg_idx >= options.nb_messages)
+        {
+            break;
+        }
+        if (msg_received[msg_idx]++ > 0)
+        {
+            nb_duplicated++;
+            break;
+        }
+        latencies_us[nb_latencies++] = now - msg_sent_us[msg_idx];
+        last_delivery_us = now;
+    }
+    break;
+
+    default:
+        break;
+    }
+}
+
+static const sim_medium_t medium = {
+    .now_us = medium_now_us,
+    .schedule = medium_schedule,
+    .transmit = medium_transmit,
+    .app_receive = medium_app_receive,
+};
+
+static void app_send(node_t *src, uint16_t dst_node, uint32_t msg_idx)
+{
+    // The index is followed by padding up to the payload size.
+    uint8_t data[LUOS_MESH_MSG_MAX_DATA_SIZE] = {msg_idx & 0xFF, (msg_idx >> 8) & 0xFF, (msg_idx >> 16) & 0xFF};
+    msg_sent_us[msg_idx] = now;
+    src->api->app_send(src->app_ids[dst_node], workload.target_mode, WORKLOAD_CMD, data, workload.payload_size);
+}
+
+static void event_run(const event_t *evt)
+{
+    node_t *node = evt->node;
+    switch (evt->type)
+    {
+    case EVT_NODE_CB:
+        evt->call.cb(evt->call.arg, evt->call.tag);
+        break;
+    case EVT_DELIVER:
+        node->api->receive(evt->packet.src_addr, evt->packet.dst_addr, evt->packet.opcode, evt->packet.data,
+                           evt->packet.length);
+        break;
+    case EVT_TX_COMPLETE:
+        node->api->tx_complete(evt->token);
+        break;
+    case EVT_APP_SEND:
+        app_send(node, evt->send.dst_node, evt->send.msg_idx);
+        break;
+    }
+    node->api->loop();
+}
+
+// Runs events until the given condition holds, no event is left, or the deadline passes
+static bool run_until(bool (*done)(void), uint64_t deadline_us)
+{
+    while (!(done && done()))
+    {
+        if (nb_events == 0 || events[0].time_us > deadline_us)
+        {
+            return done == NULL;
+        }
+        event_t evt = event_pop();
+        now = evt.time_us;
+        event_run(&evt);
+    }
+    return true;
+}
+
+static bool all_rtb_complete(void)
+{
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        if (!nodes[i].rtb_complete)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Loads a private copy of the node module, so that its static state is not shared
+static bool node_load(node_t *node, const char *dir)
+{
+    char path[4096];
+    snprintf(path, sizeof(path), "%s/node%u.so", dir, node->index);
+    FILE *src = fopen(options.node_path, "rb");
+    FILE *dst = fopen(path, "wb");
+    if (src == NULL || dst == NULL)
+    {
+        fprintf(stderr, "cannot copy %s to %s\n", options.node_path, path);
+        return false;
+    }
+    char buffer[65536];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), src)) > 0)
+    {
+        fwrite(buffer, 1, size, dst);
+    }
+    fclose(src);
+    fclose(dst);
+
+    node->handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    unlink(path);
+    if (node->handle == NULL)
+    {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    sim_node_api_get_t api_get = (sim_node_api_get_t)dlsym(node->handle, SIM_NODE_API_SYMBOL);
+    if (api_get == NULL)
+    {
+        fprintf(stderr, "%s\n", dlerror());
+        return false;
+    }
+    node->api = api_get();
+    return true;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile_ms(double ratio)
+{
+    if (nb_latencies == 0)
+    {
+        return 0.0;
+    }
+    uint32_t idx = (uint32_t)(ratio * (nb_latencies - 1) + 0.5);
+    return (double)latencies_us[idx] / 1000.0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --nodes N             simulated Mesh Bridges, 2 to %u (3)\n"
+            "  --latency MS          delivery latency of a message (8)\n"
+            "  --jitter MS           random delivery delay added to the latency (8)\n"
+            "  --loss RATIO          loss probability of each segment and receiver (0)\n"
+            "  --tx-complete MS      sending time of a segment before TX complete (15)\n"
+            "  --messages N          workload messages between application containers (500)\n"
+            "  --interval MS         time between two workload bursts (100)\n"
+            "  --seed N              seed of the pseudo-random generator (1)\n"
+            "  --min-delivery RATIO  fail below this ratio of delivered messages (0)\n"
+            "  --node-lib PATH       node module to load (%s)\n"
+            "swept options, as comma-separated lists of up to %u values:\n"
+            "  --payload N,...       workload payload size, %u to %u bytes (%u)\n"
+            "  --destinations N,...  remote containers each workload message is sent to (1)\n"
+            "  --mode MODE,...       target mode of workload messages, id or idack (id)\n"
+            "  --burst N,...         messages sent at once every interval, filling the TX queues (1)\n",
+            name, MAX_NODES, MESH_SIM_NODE_PATH, MAX_SWEEP_VALUES, WORKLOAD_MIN_SIZE, (unsigned)LUOS_MESH_MSG_MAX_DATA_SIZE,
+            WORKLOAD_MIN_SIZE);
+}
+
+// Parses a comma-separated list of numbers, or of target modes
+static bool parse_sweep(const char *value, sweep_t *sweep, bool modes)
+{
+    sweep->nb_values = 0;
+    while (*value != '\0')
+    {
+        if (sweep->nb_values == MAX_SWEEP_VALUES)
+        {
+            return false;
+        }
+        char *end;
+        if (!modes)
+        {
+            sweep->values[sweep->nb_values++] = (uint32_t)strtoul(value, &end, 10);
+        }
+        else if (strncmp(value, "idack", 5) == 0)
+        {
+            sweep->values[sweep->nb_values++] = IDACK;
+            end = (char *)value + 5;
+        }
+        else if (strncmp(value, "id", 2) == 0)
+        {
+            sweep->values[sweep->nb_values++] = ID;
+            end = (char *)value + 2;
+        }
+        else
+        {
+            return false;
+        }
+        if (end == value || (*end != ',' && *end != '\0'))
+        {
+            return false;
+        }
+        value = (*end == ',') ? end + 1 : end;
+    }
+    return sweep->nb_values > 0;
+}
+
+static bool sweep_within(const sweep_t *sweep, uint32_t min, uint32_t max)
+{
+    for (uint16_t i = 0; i < sweep->nb_values; i++)
+    {
+        if (sweep->values[i] < min || sweep->values[i] > max)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool parse_options(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc)
+        {
+            return false;
+        }
+        const char *name = argv[i];
+        const char *value = argv[++i];
+        if (strcmp(name, "--nodes") == 0)
+        {
+            options.nb_nodes = (uint16_t)strtoul(value, NULL, 10);
+        }
+        else if (strcmp(name, "--latency") == 0)
+        {
+            options.latency_us = (uint64_t)(strtod(value, NULL) * 1000.0);
+        }
+        else if (strcmp(name, "--jitter") == 0)
+        {
+            options.jitter_us = (uint64_t)(strtod(value, NULL) * 1000.0);
+        }
+        else if (strcmp(name, "--loss") == 0)
+        {
+            options.loss = strtod(value, NULL);
+        }
+        else if (strcmp(name, "--tx-complete") == 0)
+        {
+            options.tx_complete_us = (uint64_t)(strtod(value, NULL) * 1000.0);
+        }
+        else if (strcmp(name, "--messages") == 0)
+        {
+            options.nb_messages = (uint32_t)strtoul(value, NULL, 10);
+        }
+        else if (strcmp(name, "--interval") == 0)
+        {
+            options.interval_us = (uint64_t)(strtod(value, NULL) * 1000.0);
+        }
+        else if (strcmp(name, "--seed") == 0)
+        {
+            options.seed = strtoull(value, NULL, 10);
+        }
+        else if (strcmp(name, "--min-delivery") == 0)
+        {
+            options.min_delivery = strtod(value, NULL);
+        }
+        else if (strcmp(name, "--node-lib") == 0)
+        {
+            options.node_path = value;
+        }
+        else if (strcmp(name, "--payload") == 0)
+        {
+            if (!parse_sweep(value, &options.payload_size, false))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(name, "--destinations") == 0)
+        {
+            if (!parse_sweep(value, &options.nb_destinations, false))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(name, "--mode") == 0)
+        {
+            if (!parse_sweep(value, &options.target_mode, true))
+            {
+                return false;
+            }
+        }
+        else if (strcmp(name, "--burst") == 0)
+        {
+            if (!parse_sweep(value, &options.burst, false))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.nb_nodes >= 2 && options.nb_nodes <= MAX_NODES && options.loss >= 0.0 && options.loss < 1.0
+           && options.tx_complete_us > 0 && options.nb_messages < MAX_MESSAGES
+           && sweep_within(&options.payload_size, WORKLOAD_MIN_SIZE, LUOS_MESH_MSG_MAX_DATA_SIZE)
+           && sweep_within(&options.nb_destinations, 1, options.nb_nodes - 1)
+           && sweep_within(&options.burst, 1, options.nb_messages ? options.nb_messages : 1);
+}
+
+static const char *target_mode_name(uint8_t target_mode)
+{
+    return (target_mode == IDACK) ? "idack" : "id";
+}
+
+// Starts fresh nodes, then exchanges their routing tables and runs the workload
+static bool run(run_result_t *result)
+{
+    // Every run starts from the same state, and only depends on its options.
+    now = 0;
+    nb_events = 0;
+    next_seq = 0;
+    random_state = options.seed ? options.seed : 0x9E3779B97F4A7C15ull;
+    nb_latencies = 0;
+    nb_duplicated = 0;
+    last_delivery_us = 0;
+    nb_transmitted = 0;
+    nb_lost = 0;
+    memset(nodes, 0, sizeof(nodes));
+    memset(result, 0, sizeof(run_result_t));
+    result->workload = workload;
+
+    char dir[] = "/tmp/mesh_sim.XXXXXX";
+    if (mkdtemp(dir) == NULL)
+    {
+        perror("mkdtemp");
+        exit(2);
+    }
+    bool loaded = true;
+    for (uint16_t i = 0; i < options.nb_nodes && loaded; i++)
+    {
+        nodes[i].index = i;
+        loaded = node_load(nodes + i, dir);
+    }
+    rmdir(dir);
+    if (!loaded)
+    {
+        exit(2);
+    }
+
+    printf("%u nodes, latency %.1f ms + %.1f ms jitter, loss %.3f, tx complete %.1f ms/segment, seed %" PRIu64 "\n",
+           options.nb_nodes, options.latency_us / 1000.0, options.jitter_us / 1000.0, options.loss,
+           options.tx_complete_us / 1000.0, options.seed);
+    printf("workload: %u byte payload, %u destination(s), %s, bursts of %u\n", workload.payload_size,
+           workload.nb_destinations, target_mode_name(workload.target_mode), workload.burst);
+
+    // Start the nodes and expose their application containers.
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        char alias[MAX_ALIAS_SIZE];
+        snprintf(alias, sizeof(alias), "app%u", i);
+        nodes[i].api->init(&medium, nodes + i, i + 1, alias);
+        nodes[i].api->bridge_send(MESH_BRIDGE_FILL_LOCAL_CONTAINER_TABLE, NULL, 0);
+        nodes[i].api->loop();
+    }
+
+    // Each node runs the routing table extension in turn.
+    bool passed = true;
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        for (uint16_t j = 0; j < options.nb_nodes; j++)
+        {
+            nodes[j].rtb_complete = false;
+        }
+        uint64_t start_us = now;
+        nodes[i].api->bridge_send(MESH_BRIDGE_EXT_RTB_CMD, NULL, 0);
+        nodes[i].api->loop();
+        bool complete = run_until(all_rtb_complete, now + EXT_RTB_TIMEOUT_US);
+        uint64_t last_us = start_us;
+        for (uint16_t j = 0; j < options.nb_nodes; j++)
+        {
+            if (nodes[j].rtb_complete && nodes[j].rtb_complete_us > last_us)
+            {
+                last_us = nodes[j].rtb_complete_us;
+            }
+        }
+        if (complete)
+        {
+            printf("ext-rtb from node %u: %.1f ms on the node, %.1f ms on the network\n", i,
+                   (nodes[i].rtb_complete_us - start_us) / 1000.0, (last_us - start_us) / 1000.0);
+        }
+        else
+        {
+            printf("ext-rtb from node %u: not complete after %.1f s\n", i, EXT_RTB_TIMEOUT_US / 1e6);
+            passed = false;
+        }
+        // Let the remaining timers expire before the next procedure.
+        run_until(NULL, now + EXT_RTB_TIMEOUT_US);
+    }
+
+    // Find the remote application containers in each routing table.
+    uint32_t nb_routes = 0;
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        for (uint16_t j = 0; j < options.nb_nodes; j++)
+        {
+            char alias[MAX_ALIAS_SIZE];
+            snprintf(alias, sizeof(alias), "app%u", j);
+            nodes[i].app_ids[j] = (i == j) ? 0 : nodes[i].api->find_id(alias);
+            nb_routes += (i != j && nodes[i].app_ids[j] != 0);
+        }
+    }
+    uint32_t nb_expected_routes = options.nb_nodes * (options.nb_nodes - 1);
+    printf("routes: %u of %u remote application containers\n", nb_routes, nb_expected_routes);
+    passed &= (nb_routes == nb_expected_routes);
+
+    /* Workload: bursts of messages from random nodes, each sent to random
+    ** distinct remote containers, at a fixed pace.
+    */
+    msg_sent_us = calloc(options.nb_messages + 1, sizeof(uint64_t));
+    msg_received = calloc(options.nb_messages + 1, sizeof(uint16_t));
+    latencies_us = calloc(options.nb_messages + 1, sizeof(uint64_t));
+    uint32_t nb_sent = 0;
+    uint32_t nb_bursts = 0;
+    first_send_us = now + options.interval_us;
+    for (uint32_t m = 0; m < options.nb_messages; nb_bursts++)
+    {
+        uint64_t send_us = first_send_us + nb_bursts * options.interval_us;
+        for (uint16_t b = 0; b < workload.burst && m < options.nb_messages; b++)
+        {
+            uint16_t src = random_u64() % options.nb_nodes;
+            bool chosen[MAX_NODES] = {false};
+            chosen[src] = true;
+            for (uint16_t d = 0; d < workload.nb_destinations && m < options.nb_messages; d++, m++)
+            {
+                uint16_t dst;
+                do
+                {
+                    dst = random_u64() % options.nb_nodes;
+                } while (chosen[dst]);
+                chosen[dst] = true;
+                if (nodes[src].app_ids[dst] == 0)
+                {
+                    continue;
+                }
+                event_t *evt = event_push(send_us, EVT_APP_SEND, nodes + src);
+                evt->send.dst_node = dst;
+                evt->send.msg_idx = m;
+                nb_sent++;
+            }
+        }
+    }
+    run_until(NULL, first_send_us + nb_bursts * options.interval_us + DRAIN_TIMEOUT_US);
+
+    qsort(latencies_us, nb_latencies, sizeof(uint64_t), compare_u64);
+    double delivery = nb_sent ? (double)nb_latencies / nb_sent : 0.0;
+    double duration_s = (last_delivery_us > first_send_us) ? (last_delivery_us - first_send_us) / 1e6 : 0.0;
+    printf("messages: %u sent, %u delivered (%.1f %%), %u duplicated\n", nb_sent, nb_latencies, 100.0 * delivery,
+           nb_duplicated);
+    printf("latency: p50 %.1f ms, p99 %.1f ms, max %.1f ms\n", percentile_ms(0.5), percentile_ms(0.99),
+           percentile_ms(1.0));
+    printf("throughput: %.2f msg/s over %.1f s\n", duration_s > 0.0 ? nb_latencies / duration_s : 0.0, duration_s);
+    printf("medium: %u access messages sent, %u receptions lost\n", nb_transmitted, nb_lost);
+    passed &= (delivery >= options.min_delivery);
+
+    result->nb_sent = nb_sent;
+    result->nb_delivered = nb_latencies;
+    result->p50_ms = percentile_ms(0.5);
+    result->p99_ms = percentile_ms(0.99);
+    result->throughput = duration_s > 0.0 ? nb_latencies / duration_s : 0.0;
+
+    printf("%4s %8s %8s %9s %10s %10s %8s %8s %8s %10s %10s\n", "node", "to_mesh", "from", "enq_fail", "dup_drops",
+           "q_high", "tx_min", "tx_avg", "tx_max", "bytes_air", "unroutable");
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        mesh_bridge_stats_t stats;
+        nodes[i].api->stats(&stats);
+        printf("%4u %8u %8u %9u %10u %10u %8u %8u %8u %10u %10u\n", i, stats.nb_msg_to_mesh, stats.nb_msg_from_mesh,
+               stats.nb_enqueue_failures, stats.nb_duplicate_drops, stats.queue_high_water, stats.tx_latency_min_ms,
+               stats.tx_latency_avg_ms, stats.tx_latency_max_ms, stats.bytes_on_air, nodes[i].api->nb_unroutable());
+        if (stats.queue_high_water > result->queue_high_water)
+        {
+            result->queue_high_water = stats.queue_high_water;
+        }
+        result->nb_enqueue_failures += stats.nb_enqueue_failures;
+    }
+
+    free(msg_sent_us);
+    free(msg_received);
+    free(latencies_us);
+    for (uint16_t i = 0; i < options.nb_nodes; i++)
+    {
+        dlclose(nodes[i].handle);
+    }
+
+    result->passed = passed;
+    printf("%s\n\n", passed ? "passed" : "FAILED");
+    return passed;
+}
+
+int main(int argc, char *argv[])
+{
+    if (!parse_options(argc, argv))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    // One run for each combination of the swept values.
+    bool passed = true;
+    for (uint16_t p = 0; p < options.payload_size.nb_values; p++)
+    {
+        for (uint16_t d = 0; d < options.nb_destinations.nb_values; d++)
+        {
+            for (uint16_t t = 0; t < options.target_mode.nb_values; t++)
+            {
+                for (uint16_t b = 0; b < options.burst.nb_values; b++)
+                {
+                    workload.payload_size = (uint16_t)options.payload_size.values[p];
+                    workload.nb_destinations = (uint16_t)options.nb_destinations.values[d];
+                    workload.target_mode = (uint8_t)options.target_mode.values[t];
+                    workload.burst = (uint16_t)options.burst.values[b];
+                    passed &= run(results + nb_runs++);
+                }
+            }
+        }
+    }
+
+    if (nb_runs > 1)
+    {
+        printf("%7s %5s %6s %6s %7s %9s %8s %8s %10s %7s %9s\n", "payload", "dests", "mode", "burst", "sent",
+               "delivered", "p50_ms", "p99_ms", "msg/s", "q_high", "enq_fail");
+        for (uint32_t i = 0; i < nb_runs; i++)
+        {
+            const run_result_t *result = results + i;
+            printf("%7u %5u %6s %6u %7u %9u %8.1f %8.1f %10.2f %7u %9u%s\n", result->workload.payload_size,
+                   result->workload.nb_destinations, target_mode_name(result->workload.target_mode),
+                   result->workload.burst, result->nb_sent, result->nb_delivered, result->p50_ms, result->p99_ms,
+                   result->throughput, result->queue_high_water, result->nb_enqueue_failures,
+                   result->passed ? "" : " FAILED");
+        }
+    }
+
+    printf("%s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,106 @@
+/* Entry point of a simulated node module: starts the Mesh Bridge with
+** an application container, and forwards the calls of the harness to
+** the host stand-ins.
+*/
+#include <string.h>
+#include "luos.h"
+#include "luos_utils.h"
+#include "mesh_bridge.h"
+#include "mesh_bridge_stats.h"
+#include "mesh_bridge_utils.h"
+#include "node_host.h"
+#include "sim_node.h"
+
+#ifndef REV
+#define REV {0,0,1}
+#endif
+
+const sim_medium_t *g_sim_medium = NULL;
+void *g_sim_node = NULL;
+uint16_t g_sim_address = 0;
+
+// Application container, driven by the harness.
+static container_t *app_container = NULL;
+
+static void app_msg_handler(container_t *container, msg_t *msg)
+{
+    (void)container;
+    g_sim_medium->app_receive(g_sim_node, msg);
+}
+
+static void node_init(const sim_medium_t *medium, void *node, uint16_t address, const char *app_alias)
+{
+    g_sim_medium = medium;
+    g_sim_node = node;
+    g_sim_address = address;
+
+    MeshBridge_Init();
+
+    revision_t revision = {.unmap = REV};
+    app_container = Luos_CreateContainer(app_msg_handler, VOID_MOD, app_alias, revision);
+
+    // The Luos network runs a detection at startup.
+    RoutingTB_DetectContainers(app_container);
+}
+
+static void node_loop(void)
+{
+    do
+    {
+        Luos_Loop();
+        MeshBridge_Loop();
+    } while (luos_host_nb_pending() > 0);
+}
+
+static void node_app_send(uint16_t target, uint8_t target_mode, uint8_t cmd, const void *data, uint16_t size)
+{
+    LUOS_ASSERT(size <= MAX_DATA_MSG_SIZE);
+    msg_t msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.header.target_mode = target_mode;
+    msg.header.target = target;
+    msg.header.cmd = cmd;
+    msg.header.size = size;
+    if (size > 0)
+    {
+        memcpy(msg.data, data, size);
+    }
+    Luos_SendMsg(app_container, &msg);
+}
+
+static void node_bridge_send(uint8_t cmd, const void *data, uint16_t size)
+{
+    uint16_t bridge_id = find_mesh_bridge_container_id(RoutingTB_Get(), RoutingTB_GetLastEntry());
+    LUOS_ASSERT(bridge_id != 0);
+    node_app_send(bridge_id, ID, cmd, data, size);
+}
+
+static uint16_t node_find_id(const char *alias)
+{
+    routing_table_t *rtb = RoutingTB_Get();
+    for (uint16_t i = 0; i < RoutingTB_GetLastEntry(); i++)
+    {
+        if (rtb[i].mode == CONTAINER && strncmp(rtb[i].alias, alias, MAX_ALIAS_SIZE) == 0)
+        {
+            return rtb[i].id;
+        }
+    }
+    return 0;
+}
+
+static const sim_node_api_t api = {
+    .init = node_init,
+    .receive = access_host_receive,
+    .tx_complete = access_host_tx_complete,
+    .loop = node_loop,
+    .bridge_send = node_bridge_send,
+    .app_send = node_app_send,
+    .find_id = node_find_id,
+    .stats = mesh_bridge_stats_get,
+    .nb_unroutable = luos_host_nb_unroutable,
+};
+
+__attribute__((visibility("default"))) const sim_node_api_t *sim_node_api(void)
+{
+    return &api;
+}
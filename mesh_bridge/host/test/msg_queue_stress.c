@@ -0,0 +1,220 @@
+/* Stress test of the Mesh TX queue: several producer threads enqueue
+** numbered elements while a single consumer thread peeks and pops them.
+** The consumer checks that no element is lost or duplicated, that the
+** elements of each producer come out in order, and that every peeked
+** element is fully written.
+**
+** Usage: msg_queue_stress [nb_producers] [nb_elements_per_producer]
+*/
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <inttypes.h>               // PRIu32
+#include <pthread.h>                // pthread_*
+#include <sched.h>                  // sched_yield
+#include <stdatomic.h>              // atomic_*
+#include <stdbool.h>                // bool
+#include <stdint.h>                 // uint*_t
+#include <stdio.h>                  // printf
+#include <stdlib.h>                 // strtoul
+#include <string.h>                 // memset
+
+// CUSTOM
+#include "luos_mesh_msg_queue.h"    // luos_mesh_msg_queue_*
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+#define MAX_NB_PRODUCERS            16
+#define DEFAULT_NB_PRODUCERS        4
+#define DEFAULT_NB_ELEMENTS         50000
+
+// Number of producer threads and of elements enqueued by each of them.
+static uint32_t     s_nb_producers      = DEFAULT_NB_PRODUCERS;
+static uint32_t     s_nb_elements       = DEFAULT_NB_ELEMENTS;
+
+// Number of producers still enqueueing.
+static atomic_uint  s_nb_running        = 0;
+
+// Errors seen by the consumer.
+static uint32_t     s_nb_torn           = 0;
+static uint32_t     s_nb_out_of_order   = 0;
+static uint32_t     s_nb_unknown        = 0;
+
+// Number of times a producer found the queue full.
+static atomic_uint  s_nb_full           = 0;
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Fills the content of the given element with a pattern only depending
+** on its producer and sequence number.
+*/
+static void element_fill(tx_queue_elm_t* elm, uint16_t producer,
+                         uint32_t seq)
+{
+    memset(elm, 0, sizeof(tx_queue_elm_t));
+    elm->model          = TX_QUEUE_MODEL_LUOS_MSG;
+    elm->model_handle   = producer;
+
+    uint8_t*    content = (uint8_t*)&(elm->content);
+    memcpy(content, &seq, sizeof(uint32_t));
+    for (uint32_t i = sizeof(uint32_t); i < sizeof(elm->content); i++)
+    {
+        content[i]  = (uint8_t)(seq * 31 + producer * 7 + i);
+    }
+}
+
+/* Returns true if the content of the given element matches the pattern
+** of its producer and sequence number, and stores both of them.
+*/
+static bool element_check(const tx_queue_elm_t* elm, uint16_t* producer,
+                          uint32_t* seq)
+{
+    if (elm->model != TX_QUEUE_MODEL_LUOS_MSG)
+    {
+        return false;
+    }
+
+    *producer   = elm->model_handle;
+
+    const uint8_t*  content = (const uint8_t*)&(elm->content);
+    memcpy(seq, content, sizeof(uint32_t));
+    for (uint32_t i = sizeof(uint32_t); i < sizeof(elm->content); i++)
+    {
+        if (content[i] != (uint8_t)(*seq * 31 + *producer * 7 + i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void* producer_run(void* arg)
+{
+    uint16_t        producer    = (uint16_t)(uintptr_t)arg;
+    tx_queue_elm_t  elm;
+
+    for (uint32_t seq = 0; seq < s_nb_elements; seq++)
+    {
+        element_fill(&elm, producer, seq);
+        while (!luos_mesh_msg_queue_enqueue(&elm))
+        {
+            // Queue is full: let the consumer run.
+            atomic_fetch_add(&s_nb_full, 1);
+            sched_yield();
+        }
+    }
+
+    atomic_fetch_sub(&s_nb_running, 1);
+
+    return NULL;
+}
+
+static void* consumer_run(void* arg)
+{
+    uint32_t*       next_seq    = (uint32_t*)arg;
+
+    while (true)
+    {
+        // Read the count before peeking, not to miss the last elements.
+        bool            running = atomic_load(&s_nb_running) > 0;
+        tx_queue_elm_t* elm     = luos_mesh_msg_queue_peek();
+
+        if (elm == NULL)
+        {
+            if (!running)
+            {
+                break;
+            }
+            // Wait for the producers.
+            sched_yield();
+            continue;
+        }
+
+        uint16_t        producer;
+        uint32_t        seq;
+        if (!element_check(elm, &producer, &seq))
+        {
+            s_nb_torn++;
+        }
+        else if (producer >= s_nb_producers || seq >= s_nb_elements)
+        {
+            s_nb_unknown++;
+        }
+        else if (seq != next_seq[producer])
+        {
+            // Covers lost, duplicated and reordered elements.
+            s_nb_out_of_order++;
+            next_seq[producer]  = seq + 1;
+        }
+        else
+        {
+            next_seq[producer]++;
+        }
+
+        luos_mesh_msg_queue_pop();
+    }
+
+    return NULL;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1)
+    {
+        s_nb_producers  = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2)
+    {
+        s_nb_elements   = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    if (s_nb_producers == 0 || s_nb_producers > MAX_NB_PRODUCERS
+        || s_nb_elements == 0)
+    {
+        fprintf(stderr, "usage: %s [1..%u producers] [elements]\n",
+                argv[0], MAX_NB_PRODUCERS);
+        return 2;
+    }
+
+    uint32_t        next_seq[MAX_NB_PRODUCERS]  = { 0 };
+    pthread_t       producers[MAX_NB_PRODUCERS];
+    pthread_t       consumer;
+
+    atomic_store(&s_nb_running, s_nb_producers);
+    pthread_create(&consumer, NULL, consumer_run, next_seq);
+    for (uint32_t i = 0; i < s_nb_producers; i++)
+    {
+        pthread_create(producers + i, NULL, producer_run,
+                       (void*)(uintptr_t)i);
+    }
+    for (uint32_t i = 0; i < s_nb_producers; i++)
+    {
+        pthread_join(producers[i], NULL);
+    }
+    pthread_join(consumer, NULL);
+
+    uint32_t        nb_missing  = 0;
+    for (uint32_t i = 0; i < s_nb_producers; i++)
+    {
+        nb_missing  += s_nb_elements - next_seq[i];
+    }
+
+    printf("%" PRIu32 " producers x %" PRIu32 " elements, queue full %u "
+           "times\n", s_nb_producers, s_nb_elements,
+           atomic_load(&s_nb_full));
+    printf("torn %" PRIu32 ", unknown %" PRIu32 ", out of order %" PRIu32
+           ", missing %" PRIu32 ", left in queue %u\n", s_nb_torn,
+           s_nb_unknown, s_nb_out_of_order, nb_missing,
+           luos_mesh_msg_queue_get_nb_elements());
+
+    bool            passed      = s_nb_torn == 0 && s_nb_unknown == 0
+                                  && s_nb_out_of_order == 0
+                                  && nb_missing == 0
+                                  && luos_mesh_msg_queue_is_empty()
+                                  && luos_mesh_msg_queue_get_nb_elements() == 0;
+
+    printf("%s\n", passed ? "passed" : "FAILED");
+
+    return passed ? 0 : 1;
+}
@@ -119,8 +119,18 @@ typedef struct
 
 } tx_queue_elm_t;
 
+/* The queue is a lock-free ring with several producers and a single
+** consumer:
+**  *   Any context (Luos message handlers, Mesh callbacks, timers) may
+**      call `luos_mesh_msg_queue_enqueue`.
+**  *   Only the context owning the right to send (see the message queue
+**      manager) may call `luos_mesh_msg_queue_peek` and
+**      `luos_mesh_msg_queue_pop`.
+*/
+
 /* Stores the given element in the internal message queue. Returns false
-** if the queue is full, true otherwise.
+** if the queue is full, true otherwise. The last slots are kept for Luos
+** RTB messages: Luos MSG messages find the queue full before them.
 */
 bool luos_mesh_msg_queue_enqueue(const tx_queue_elm_t* elm);
 
@@ -130,4 +140,14 @@ tx_queue_elm_t* luos_mesh_msg_queue_peek(void);
 // Pops the last queue element from the queue.
 void luos_mesh_msg_queue_pop(void);
 
+/* Returns true if no committed element is waiting in the queue, false
+** otherwise. Can be called from any context.
+*/
+bool luos_mesh_msg_queue_is_empty(void);
+
+/* Returns the number of reserved queue slots, including elements still
+** being written by a producer. Can be called from any context.
+*/
+uint16_t luos_mesh_msg_queue_get_nb_elements(void);
+
 #endif /* ! LUOS_MESH_MSG_QUEUE_H */
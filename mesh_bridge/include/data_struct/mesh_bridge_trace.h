@@ -0,0 +1,103 @@
+#ifndef MESH_BRIDGE_TRACE_H
+#define MESH_BRIDGE_TRACE_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdint.h>         // uint*_t
+
+/*      DEFINES                                                     */
+
+/* Number of events kept in the trace ring, shall be a power of two.
+** Oldest events are overwritten when the ring is not drained in time.
+*/
+#ifndef MESH_BRIDGE_TRACE_SIZE
+#define MESH_BRIDGE_TRACE_SIZE  128
+#endif /* ! MESH_BRIDGE_TRACE_SIZE */
+
+// Value of the `magic` field of each record, for stream alignment.
+#define MESH_BRIDGE_TRACE_MAGIC 0x5A
+
+/* Records an event in the trace ring. Compiled out unless the
+** MESH_BRIDGE_TRACE macro is defined in the configuration.
+*/
+#ifdef MESH_BRIDGE_TRACE
+#define MESH_BRIDGE_TRACE_EVT(event, arg0, arg1)    \
+    mesh_bridge_trace_record((event), (arg0), (arg1))
+#else /* ! MESH_BRIDGE_TRACE */
+#define MESH_BRIDGE_TRACE_EVT(event, arg0, arg1)
+#endif /* MESH_BRIDGE_TRACE */
+
+/*      TYPEDEFS                                                    */
+
+// Traced events, with the meaning of their arguments.
+typedef enum
+{
+    // Records lost since last drain. arg1: number of lost records.
+    MESH_BRIDGE_TRACE_LOST          = 0,
+
+    // Luos message to a remote container. arg0: target; arg1: command.
+    MESH_BRIDGE_TRACE_SEND,
+
+    // TX queue insertion. arg0: model; arg1: number of queued elements.
+    MESH_BRIDGE_TRACE_ENQUEUE,
+
+    // TX queue full. arg0: model.
+    MESH_BRIDGE_TRACE_ENQUEUE_FAIL,
+
+    // Access layer publication. arg0: model; arg1: token.
+    MESH_BRIDGE_TRACE_PUBLISH,
+
+    // Mesh TX complete event. arg1: token.
+    MESH_BRIDGE_TRACE_TX_COMPLETE,
+
+    /* Luos MSG command reception. arg0: source node address; arg1:
+    ** command and payload size.
+    */
+    MESH_BRIDGE_TRACE_RECEIVE,
+
+    // Local delivery of a received message. arg0: target; arg1: command.
+    MESH_BRIDGE_TRACE_DELIVER,
+
+} mesh_bridge_trace_evt_t;
+
+// A trace record, as sent to the host.
+typedef struct __attribute__((__packed__))
+{
+    // App timer counter value when the event occured.
+    uint32_t    timestamp;
+
+    // Traced event.
+    uint8_t     event;
+
+    // Always MESH_BRIDGE_TRACE_MAGIC.
+    uint8_t     magic;
+
+    // Event arguments.
+    uint16_t    arg0;
+    uint32_t    arg1;
+
+} mesh_bridge_trace_record_t;
+
+/* Function called to send drained records to the host. Returns the
+** number of bytes actually sent, lower than the given size if the host
+** link could not take them all.
+*/
+typedef uint16_t (*mesh_bridge_trace_write_t)(const uint8_t* data,
+                                              uint16_t size);
+
+/* Records the given event with the given arguments. Can be called from
+** any context.
+*/
+void mesh_bridge_trace_record(mesh_bridge_trace_evt_t event,
+                              uint16_t arg0, uint32_t arg1);
+
+/* Sends every record not drained yet through the given function,
+** preceded by a MESH_BRIDGE_TRACE_LOST record if some were overwritten.
+** Records the function could not send stay in the ring for the next
+** drain, and are counted as lost if they are overwritten before. Shall
+** be called from the lowest priority context only.
+*/
+void mesh_bridge_trace_drain(mesh_bridge_trace_write_t write);
+
+#endif /* ! MESH_BRIDGE_TRACE_H */
@@ -0,0 +1,55 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>                // bool
+#include <stdint.h>                 // uint*_t
+
+// LUOS
+#include "luos.h"                   // container_t
+#include "robus_struct.h"           // msg_t
+
+// CUSTOM
+#include "remote_container_table.h" // REMOTE_CONTAINER_TABLE_MAX_NB_ENTRIES
+
+/*      DEFINES                                                     */
+
+/* Maximum age in ms of the cached values of a remote container served
+** in answer to an `ASK_PUB_CMD` request, 0 to always forward requests.
+*/
+#ifndef RESPONSE_CACHE_MAX_AGE_MS
+#define RESPONSE_CACHE_MAX_AGE_MS       500
+#endif /* ! RESPONSE_CACHE_MAX_AGE_MS */
+
+/* Time in ms after a forwarded `ASK_PUB_CMD` request during which the
+** messages of the remote container are cached as its values.
+*/
+#ifndef RESPONSE_CACHE_REPLY_WINDOW_MS
+#define RESPONSE_CACHE_REPLY_WINDOW_MS  1000
+#endif /* ! RESPONSE_CACHE_REPLY_WINDOW_MS */
+
+// Maximum number of cached values for each remote container, one per command.
+#ifndef RESPONSE_CACHE_MAX_NB_VALUES
+#define RESPONSE_CACHE_MAX_NB_VALUES    4
+#endif /* ! RESPONSE_CACHE_MAX_NB_VALUES */
+
+/* Answers the given `ASK_PUB_CMD` request, received by the given local
+** instance of a remote container, with its cached values if none of
+** them is older than RESPONSE_CACHE_MAX_AGE_MS. Returns true if it was
+** answered, false if it shall be forwarded to the remote container.
+*/
+bool response_cache_answer(container_t* instance, const msg_t* ask_pub);
+
+/* Caches the given message, received from the remote container with the
+** given local ID, if it carries one of its values: it answers the last
+** forwarded `ASK_PUB_CMD` request and targets its requester, or the
+** remote container pushes its values to its subscriber.
+*/
+void response_cache_store(uint16_t local_id, const msg_t* msg);
+
+// Clears the response cache.
+void response_cache_clear(void);
+
+#endif /* ! RESPONSE_CACHE_H */
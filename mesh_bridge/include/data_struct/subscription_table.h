@@ -0,0 +1,55 @@
+#ifndef SUBSCRIPTION_TABLE_H
+#define SUBSCRIPTION_TABLE_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>                // bool
+#include <stdint.h>                 // uint*_t
+
+// LUOS
+#include "robus_struct.h"           // msg_t
+
+// CUSTOM
+#include "luos_rtb_model_common.h"  // LUOS_RTB_MODEL_MAX_RTB_ENTRY
+#include "mesh_bridge.h"            // mesh_bridge_subscription_t
+
+/*      DEFINES                                                     */
+
+/* Maximum number of subscriptions to local containers: by default, one
+** for each exposed container.
+*/
+#ifndef SUBSCRIPTION_TABLE_MAX_NB_ENTRIES
+#define SUBSCRIPTION_TABLE_MAX_NB_ENTRIES   LUOS_RTB_MODEL_MAX_RTB_ENTRY
+#endif /* ! SUBSCRIPTION_TABLE_MAX_NB_ENTRIES */
+
+/* Maximum number of last sent values kept for each subscription, one per
+** command. Values of other commands are always sent.
+*/
+#ifndef SUBSCRIPTION_TABLE_MAX_NB_VALUES
+#define SUBSCRIPTION_TABLE_MAX_NB_VALUES    4
+#endif /* ! SUBSCRIPTION_TABLE_MAX_NB_VALUES */
+
+/* Applies the given subscription of the remote container with the given
+** local ID to the local container with the given local ID, and returns
+** the applied period: 0 if it was removed or the table is full.
+*/
+uint16_t subscription_table_set(uint16_t local_id, uint16_t subscriber_id,
+                                const mesh_bridge_subscription_t* subscription);
+
+/* Asks each subscribed container for its values if its period elapsed.
+** Shall be called from the main loop.
+*/
+void subscription_table_poll(void);
+
+/* Returns true if the given message, sent by a local container to a
+** remote one, shall be sent through the Mesh network: always, unless it
+** answers a subscription and its value did not change by more than the
+** subscription deadband since it was last sent.
+*/
+bool subscription_table_filter(const msg_t* msg);
+
+// Clears the subscription table.
+void subscription_table_clear(void);
+
+#endif /* ! SUBSCRIPTION_TABLE_H */
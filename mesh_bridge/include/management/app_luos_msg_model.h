@@ -4,7 +4,7 @@
 /*      INCLUDES                                                    */
 
 // C STANDARD
-#include <stdint.h>         // uint16_t
+#include <stdint.h>         // uint*_t
 
 // LUOS
 #include "robus_struct.h"   // msg_t
@@ -24,4 +24,9 @@ void app_luos_msg_model_address_set(uint16_t device_address);
 */
 void app_luos_msg_model_send_msg(const msg_t* msg);
 
+/* Returns the number of received commands dropped by the internal model
+** instance as already handled.
+*/
+uint32_t app_luos_msg_model_get_nb_duplicates(void);
+
 #endif /* ! APP_LUOS_MSG_MODEL_H */
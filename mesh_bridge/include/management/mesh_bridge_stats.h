@@ -0,0 +1,40 @@
+#ifndef MESH_BRIDGE_STATS_H
+#define MESH_BRIDGE_STATS_H
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdint.h>         // uint*_t
+
+// CUSTOM
+#include "mesh_bridge.h"    // mesh_bridge_stats_t
+
+// Counts a Luos message sent to a remote container.
+void mesh_bridge_stats_msg_to_mesh(void);
+
+// Counts a Luos message received from a remote container.
+void mesh_bridge_stats_msg_from_mesh(void);
+
+/* Updates the TX queue high-water mark with the given number of queued
+** elements.
+*/
+void mesh_bridge_stats_queue_size(uint16_t nb_elements);
+
+// Counts a message dropped because the TX queue was full.
+void mesh_bridge_stats_enqueue_failure(void);
+
+/* Records the given delay between the sending and the TX complete event
+** of a message, and the given number of sent bytes.
+*/
+void mesh_bridge_stats_tx_complete(uint32_t latency_ms, uint16_t nb_bytes);
+
+// Records the start of an Ext-RTB procedure.
+void mesh_bridge_stats_rtb_sync_start(void);
+
+// Records the end of the current Ext-RTB procedure.
+void mesh_bridge_stats_rtb_sync_end(void);
+
+// Fills the given struct with the current statistics.
+void mesh_bridge_stats_get(mesh_bridge_stats_t* stats);
+
+#endif /* ! MESH_BRIDGE_STATS_H */
@@ -3,6 +3,9 @@
 
 /*      INCLUDES                                                    */
 
+// C STANDARD
+#include <stdbool.h>                // bool
+
 // CUSTOM
 #include "luos_mesh_msg_queue.h"    // tx_queue_elm_t
 
@@ -10,8 +13,9 @@
 void luos_mesh_msg_queue_manager_init(void);
 
 /* Enqueues the given message, then sends the last message in the queue
-** if possible.
+** if possible. Returns false if the queue was full and the message was
+** dropped, true otherwise.
 */
-void luos_mesh_msg_prepare(const tx_queue_elm_t* message);
+bool luos_mesh_msg_prepare(const tx_queue_elm_t* message);
 
 #endif /* ! MESH_MSG_QUEUE_MANAGER_H */
@@ -3,6 +3,9 @@
 
 /*      INCLUDES                                                    */
 
+// C STANDARD
+#include <stdint.h>         // uint*_t
+
 // LUOS
 #include "app_luos_list.h"  // MESH_BRIDGE_MOD, MESH_BRIDGE_MSG_BEGIN
 #include "luos_list.h"      // LUOS_PROTOCOL_NB, LUOS_LAST_TYPE
@@ -23,6 +26,11 @@
 #define MESH_BRIDGE_TYPE        MESH_BRIDGE_MOD
 #define MESH_BRIDGE_ALIAS       "mesh_bridge"
 
+/* Largest payload of an echo request, which is the largest Luos Mesh
+** message payload (`LUOS_MESH_MSG_MAX_DATA_SIZE`).
+*/
+#define MESH_BRIDGE_ECHO_MAX_SIZE   7
+
 /*      TYPEDEFS                                                    */
 
 typedef enum
@@ -60,17 +68,97 @@ typedef enum
     */
     MESH_BRIDGE_INTERNAL_TABLES_UPDATED,
 
+    // Received commands:
+    // Request for the runtime statistics of the Mesh Bridge.
+    MESH_BRIDGE_GET_STATS,
+
+    // Sent messages:
+    // Runtime statistics, as a `mesh_bridge_stats_t` payload.
+    MESH_BRIDGE_STATS,
+
+    // Received commands:
+    /* Subscription to the changed values of a remote container, as a
+    ** `mesh_bridge_subscription_t` payload. Sent to the remote
+    ** container, and applied by the Mesh Bridge of its network.
+    */
+    MESH_BRIDGE_SUBSCRIBE,
+
+    // Sent messages:
+    /* Subscription applied, sent by the subscribed container. Payload is
+    ** the applied period in ms as an `uint16_t`, 0 if not subscribed.
+    */
+    MESH_BRIDGE_SUBSCRIBED,
+
+    // Received commands:
+    /* Round-trip measurement request sent to a remote container, with a
+    ** payload of up to `MESH_BRIDGE_ECHO_MAX_SIZE` bytes. It is not
+    ** delivered: the Mesh Bridge of the remote network answers it on
+    ** behalf of the container, with the same command and payload.
+    */
+    MESH_BRIDGE_ECHO,
+
     // Start index for next messages.
     MESH_BRIDGE_MSG_END,
 
 } mesh_bridge_msg_t;
 
+// Runtime statistics of a Mesh Bridge, sent as a message payload.
+typedef struct __attribute__((__packed__))
+{
+    // Luos messages sent to remote containers through the Mesh network.
+    uint32_t    nb_msg_to_mesh;
+
+    // Luos messages received from remote containers.
+    uint32_t    nb_msg_from_mesh;
+
+    // Maximum number of elements in the Mesh TX queue.
+    uint16_t    queue_high_water;
+
+    // Mesh messages dropped because the TX queue was full.
+    uint32_t    nb_enqueue_failures;
+
+    // Received Luos MSG commands dropped as already handled.
+    uint32_t    nb_duplicate_drops;
+
+    // Delay in ms between the sending and TX complete event of messages.
+    uint32_t    tx_latency_min_ms;
+    uint32_t    tx_latency_avg_ms;
+    uint32_t    tx_latency_max_ms;
+
+    // Completed Ext-RTB procedures, and duration in ms of the last one.
+    uint32_t    nb_rtb_sync;
+    uint32_t    last_rtb_sync_ms;
+
+    // Access layer payload bytes (opcodes included) sent on air.
+    uint32_t    bytes_on_air;
+
+} mesh_bridge_stats_t;
+
+/* Subscription to the values of a remote container, sent as a message
+** payload. The Mesh Bridge hosting the container asks it for its values
+** at the given period, and only sends the changed ones through the Mesh
+** network.
+*/
+typedef struct __attribute__((__packed__))
+{
+    // Time in ms between two requests, 0 to unsubscribe.
+    uint16_t    period_ms;
+
+    /* Minimum change of float values to send them again, 0 to send any
+    ** change.
+    */
+    float       deadband;
+
+} mesh_bridge_subscription_t;
+
 /* Initializes and starts the Mesh stack, and initializes the low-level
 ** container, then starts listening for a provisioning link.
 */
 void MeshBridge_Init(void);
 
-// Does nothing.
+/* Asks subscribed containers for their values when due, and sends the
+** trace records to the host if MESH_BRIDGE_TRACE is defined.
+*/
 void MeshBridge_Loop(void);
 
 #endif /* MESH_BRIDGE_H */
@@ -3,7 +3,9 @@
 /*      INCLUDES                                                    */
 
 // C STANDARD
+#include <stdatomic.h>              // atomic_*
 #include <stdbool.h>                // bool
+#include <stdint.h>                 // uint32_t
 #include <string.h>                 // memcpy
 
 // LUOS
@@ -16,19 +18,45 @@
 
 /*      STATIC VARIABLES & CONSTANTS                                */
 
-// Max queue size: at most one message for each remote container.
-#define MSG_QUEUE_MAX_SIZE  REMOTE_CONTAINER_TABLE_MAX_NB_ENTRIES
-
-// The message queue.
+/* Max queue size: at least one message for each remote container,
+** rounded up to a power of two so that the free-running indexes can
+** wrap around without breaking the modulo.
+*/
+#define MSG_QUEUE_MAX_SIZE  32
+#define MSG_QUEUE_IDX_MASK  (MSG_QUEUE_MAX_SIZE - 1)
+
+/* Slots only available to Luos RTB messages, so that Luos MSG messages
+** filling the queue never drop a step of a routing table extension: a
+** GET request, then one STATUS message per exposed entry.
+*/
+#define MSG_QUEUE_RTB_RESERVED  (1 + LUOS_RTB_MODEL_MAX_RTB_ENTRY)
+
+_Static_assert((MSG_QUEUE_MAX_SIZE & MSG_QUEUE_IDX_MASK) == 0,
+               "Message queue size must be a power of two!");
+_Static_assert((MSG_QUEUE_MAX_SIZE - MSG_QUEUE_RTB_RESERVED)
+               >= REMOTE_CONTAINER_TABLE_MAX_NB_ENTRIES,
+               "Message queue cannot hold one message per remote container!");
+
+/* The message queue.
+**
+** Producers reserve a slot by moving `insertion_index` forward with a
+** compare-and-swap, copy their element in it, then publish it by
+** setting its `ready` flag. The single consumer only reads the slot at
+** `peek_index` once its flag is set, and releases it by clearing the
+** flag before moving `peek_index` forward.
+*/
 static struct
 {
-    // Insertion index in the queue.
-    uint16_t        insertion_index;
+    // Next slot to reserve, shared by all producers (free-running).
+    atomic_uint_fast32_t    insertion_index;
+
+    // Peek/pop slot, only moved by the consumer (free-running).
+    atomic_uint_fast32_t    peek_index;
 
-    // Peek/pop index in the queue.
-    uint16_t        peek_index;
+    // Describes if the element at the same index is fully written.
+    atomic_bool             ready[MSG_QUEUE_MAX_SIZE];
 
-    tx_queue_elm_t  elements[MSG_QUEUE_MAX_SIZE];
+    tx_queue_elm_t          elements[MSG_QUEUE_MAX_SIZE];
 
 } s_msg_queue   =
 {
@@ -41,21 +69,47 @@ bool luos_mesh_msg_queue_enqueue(const tx_queue_elm_t* elm)
     // Check parameter.
     LUOS_ASSERT(elm != NULL);
 
-    // Insertion spot in the queue.
-    tx_queue_elm_t* insert_spot = s_msg_queue.elements + s_msg_queue.insertion_index;
-
-    if (insert_spot->model != TX_QUEUE_MODEL_EMPTY)
+    // Number of slots available to the element.
+    uint_fast32_t   capacity    = MSG_QUEUE_MAX_SIZE;
+    if (elm->model != TX_QUEUE_MODEL_LUOS_RTB)
     {
-        // Insertion spot is occupied: queue is full.
-        return false;
+        capacity    -= MSG_QUEUE_RTB_RESERVED;
     }
 
+    // Reserve an insertion index.
+    uint_fast32_t   insertion_index;
+    insertion_index = atomic_load_explicit(&(s_msg_queue.insertion_index),
+                                           memory_order_relaxed);
+    do
+    {
+        uint_fast32_t   peek_index;
+        peek_index  = atomic_load_explicit(&(s_msg_queue.peek_index),
+                                           memory_order_acquire);
+
+        if ((insertion_index - peek_index) >= capacity)
+        {
+            // Every available slot is reserved: queue is full.
+            return false;
+        }
+
+        /* On failure, the insertion index is reloaded with the value
+        ** reserved by a concurrent producer.
+        */
+    } while (!atomic_compare_exchange_weak_explicit(
+                &(s_msg_queue.insertion_index), &insertion_index,
+                insertion_index + 1,
+                memory_order_acq_rel, memory_order_relaxed
+             ));
+
+    // Slot is now owned by this producer.
+    uint32_t        slot        = insertion_index & MSG_QUEUE_IDX_MASK;
+
     // Copy element in insertion spot.
-    memcpy(insert_spot, elm, sizeof(tx_queue_elm_t));
+    memcpy(s_msg_queue.elements + slot, elm, sizeof(tx_queue_elm_t));
 
-    // Increase insertion index and loop if necessary.
-    s_msg_queue.insertion_index++;
-    s_msg_queue.insertion_index %= MSG_QUEUE_MAX_SIZE;
+    // Publish element to the consumer.
+    atomic_store_explicit(s_msg_queue.ready + slot, true,
+                          memory_order_release);
 
     return true;
 }
@@ -63,34 +117,64 @@ bool luos_mesh_msg_queue_enqueue(const tx_queue_elm_t* elm)
 tx_queue_elm_t* luos_mesh_msg_queue_peek(void)
 {
     // Peek spot in the queue.
-    tx_queue_elm_t* peek_spot;
-    peek_spot   = s_msg_queue.elements + s_msg_queue.peek_index;
+    uint_fast32_t   peek_index;
+    peek_index  = atomic_load_explicit(&(s_msg_queue.peek_index),
+                                       memory_order_relaxed);
+    uint32_t        slot        = peek_index & MSG_QUEUE_IDX_MASK;
 
-    if (peek_spot->model == TX_QUEUE_MODEL_EMPTY)
+    if (!atomic_load_explicit(s_msg_queue.ready + slot,
+                              memory_order_acquire))
     {
-        // Peek spot is empty: queue is empty.
+        // Peek spot is not written yet: queue is empty.
         return NULL;
     }
 
-    return peek_spot;
+    return s_msg_queue.elements + slot;
 }
 
 void luos_mesh_msg_queue_pop(void)
 {
     // Pop spot in the queue.
-    tx_queue_elm_t* pop_spot;
-    pop_spot                = s_msg_queue.elements + s_msg_queue.peek_index;
+    uint_fast32_t   peek_index;
+    peek_index  = atomic_load_explicit(&(s_msg_queue.peek_index),
+                                       memory_order_relaxed);
+    uint32_t        slot        = peek_index & MSG_QUEUE_IDX_MASK;
 
-    if (pop_spot->model == TX_QUEUE_MODEL_EMPTY)
+    if (!atomic_load_explicit(s_msg_queue.ready + slot,
+                              memory_order_acquire))
     {
         // Pop spot is empty: no need to continue.
         return;
     }
 
-    // Just mark the last index as empty.
-    pop_spot->model = TX_QUEUE_MODEL_EMPTY;
+    // Release the slot before handing it back to the producers.
+    atomic_store_explicit(s_msg_queue.ready + slot, false,
+                          memory_order_relaxed);
+
+    // Increase peek index, it loops with the slot mask.
+    atomic_store_explicit(&(s_msg_queue.peek_index), peek_index + 1,
+                          memory_order_release);
+}
+
+bool luos_mesh_msg_queue_is_empty(void)
+{
+    uint_fast32_t   peek_index;
+    peek_index  = atomic_load_explicit(&(s_msg_queue.peek_index),
+                                       memory_order_acquire);
+    uint32_t        slot        = peek_index & MSG_QUEUE_IDX_MASK;
 
-    // Increase peek index and loop if necessary.
-    s_msg_queue.peek_index++;
-    s_msg_queue.peek_index  %= MSG_QUEUE_MAX_SIZE;
+    return !atomic_load_explicit(s_msg_queue.ready + slot,
+                                 memory_order_acquire);
+}
+
+uint16_t luos_mesh_msg_queue_get_nb_elements(void)
+{
+    uint_fast32_t   peek_index;
+    peek_index      = atomic_load_explicit(&(s_msg_queue.peek_index),
+                                           memory_order_acquire);
+    uint_fast32_t   insertion_index;
+    insertion_index = atomic_load_explicit(&(s_msg_queue.insertion_index),
+                                           memory_order_acquire);
+
+    return (uint16_t)(insertion_index - peek_index);
 }
@@ -0,0 +1,136 @@
+#include "mesh_bridge_trace.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdatomic.h>          // atomic_*
+#include <stdint.h>             // uint*_t
+#include <string.h>             // memset
+
+// NRF APPS
+#include "app_timer.h"          // app_timer_cnt_get
+
+// LUOS
+#include "luos_utils.h"         // LUOS_ASSERT
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+#define TRACE_IDX_MASK  (MESH_BRIDGE_TRACE_SIZE - 1)
+
+_Static_assert((MESH_BRIDGE_TRACE_SIZE & TRACE_IDX_MASK) == 0,
+               "Trace ring size must be a power of two!");
+
+/* The trace ring.
+**
+** Writers reserve a record by moving `write_index` forward, then fill
+** it: a writer preempting the drain completes its record before the
+** drain resumes. Only records lapped during a drain can be torn.
+*/
+static struct
+{
+    // Next record to write, shared by all writers (free-running).
+    atomic_uint_fast32_t        write_index;
+
+    // Next record to drain, only moved by the drain (free-running).
+    uint32_t                    read_index;
+
+    // Number of overwritten records not signaled to the host yet.
+    uint32_t                    nb_lost;
+
+    mesh_bridge_trace_record_t  records[MESH_BRIDGE_TRACE_SIZE];
+
+} s_trace   =
+{
+    // Ring starts as empty.
+    0
+};
+
+void mesh_bridge_trace_record(mesh_bridge_trace_evt_t event,
+                              uint16_t arg0, uint32_t arg1)
+{
+    /* Date the event before reserving its record: a preempting event
+    ** can then only be dated after a record written before it, and the
+    ** host sees at worst a small step back in time.
+    */
+    uint32_t                    timestamp   = app_timer_cnt_get();
+
+    uint_fast32_t               index;
+    index   = atomic_fetch_add_explicit(&(s_trace.write_index), 1,
+                                        memory_order_relaxed);
+
+    mesh_bridge_trace_record_t* record;
+    record  = s_trace.records + (index & TRACE_IDX_MASK);
+
+    record->timestamp   = timestamp;
+    record->event       = event;
+    record->magic       = MESH_BRIDGE_TRACE_MAGIC;
+    record->arg0        = arg0;
+    record->arg1        = arg1;
+}
+
+void mesh_bridge_trace_drain(mesh_bridge_trace_write_t write)
+{
+    // Check parameter.
+    LUOS_ASSERT(write != NULL);
+
+    uint32_t    write_index;
+    write_index = atomic_load_explicit(&(s_trace.write_index),
+                                       memory_order_acquire);
+
+    uint32_t    nb_pending  = write_index - s_trace.read_index;
+    if (nb_pending > MESH_BRIDGE_TRACE_SIZE)
+    {
+        // Oldest records were overwritten.
+        s_trace.nb_lost         += nb_pending - MESH_BRIDGE_TRACE_SIZE;
+        s_trace.read_index      = write_index - MESH_BRIDGE_TRACE_SIZE;
+    }
+
+    if (s_trace.nb_lost > 0)
+    {
+        // Signal lost records to the host.
+        mesh_bridge_trace_record_t  lost;
+        memset(&lost, 0, sizeof(mesh_bridge_trace_record_t));
+        lost.timestamp          = app_timer_cnt_get();
+        lost.event              = MESH_BRIDGE_TRACE_LOST;
+        lost.magic              = MESH_BRIDGE_TRACE_MAGIC;
+        lost.arg1               = s_trace.nb_lost;
+
+        uint16_t    written;
+        written = write((const uint8_t*)&lost,
+                        sizeof(mesh_bridge_trace_record_t));
+        if (written < sizeof(mesh_bridge_trace_record_t))
+        {
+            // Host link is full: signal them at the next drain.
+            return;
+        }
+
+        s_trace.nb_lost         = 0;
+    }
+
+    while (s_trace.read_index != write_index)
+    {
+        uint32_t    slot        = s_trace.read_index & TRACE_IDX_MASK;
+
+        // Send contiguous records at once, up to the end of the ring.
+        uint32_t    nb_records  = write_index - s_trace.read_index;
+        if (nb_records > (MESH_BRIDGE_TRACE_SIZE - slot))
+        {
+            nb_records  = MESH_BRIDGE_TRACE_SIZE - slot;
+        }
+
+        uint16_t    size        = nb_records * sizeof(mesh_bridge_trace_record_t);
+        uint16_t    written;
+        written = write((const uint8_t*)(s_trace.records + slot), size);
+
+        // Only whole records are sent: the host drops partial ones.
+        s_trace.read_index      += written / sizeof(mesh_bridge_trace_record_t);
+
+        if (written < size)
+        {
+            /* Host link is full: keep the other records for the next
+            ** drain.
+            */
+            return;
+        }
+    }
+}
@@ -19,6 +19,8 @@
 #include "app_luos_msg_model.h"     // app_luos_msg_model_send_msg
 #include "local_container_table.h"  // local_container_table_*
 #include "mesh_bridge_utils.h"      // find_mesh_bridge_node_id
+#include "response_cache.h"         // response_cache_*
+#include "subscription_table.h"     // subscription_table_filter
 
 // NRF
 #ifdef DEBUG
@@ -134,6 +136,9 @@ void remote_container_table_clear(void)
     // Empty table.
     memset(&s_remote_container_table, 0,
            sizeof(s_remote_container_table));
+
+    // Cached values are indexed by local IDs.
+    response_cache_clear();
 }
 
 void remote_container_table_clear_address(uint16_t node_address)
@@ -184,6 +189,9 @@ void remote_container_table_clear_address(uint16_t node_address)
         // Decrease number of remote containers.
         s_remote_container_table.nb_remote_containers--;
     }
+
+    // Cached values are indexed by local IDs.
+    response_cache_clear();
 }
 
 remote_container_t* remote_container_table_get_entry_from_local_id(uint16_t local_id)
@@ -241,6 +249,9 @@ void remote_container_table_update_local_ids(uint16_t dtx_container_id)
         // Update local ID.
         entry->local_id = new_id;
     }
+
+    // Cached values are indexed by local IDs.
+    response_cache_clear();
 }
 
 void remote_container_table_print(void)
@@ -325,6 +336,19 @@ static void RemoteContainer_MsgHandler(container_t* container,
         return;
     }
 
+    if ((msg->header.cmd == ASK_PUB_CMD)
+        && response_cache_answer(container, msg))
+    {
+        // Answered with recent enough values: nothing to send.
+        return;
+    }
+
+    if (!subscription_table_filter(msg))
+    {
+        // Unchanged subscription value: spare the Mesh network.
+        return;
+    }
+
     // Send message through Luos MSG model.
     app_luos_msg_model_send_msg(msg);
 }
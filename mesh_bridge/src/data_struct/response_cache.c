@@ -0,0 +1,261 @@
+#include "response_cache.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>                // bool
+#include <stdint.h>                 // uint*_t
+#include <string.h>                 // memcpy, memset
+
+// LUOS
+#include "luos.h"                   // Luos_SendMsg, Luos_GetSystick
+#include "luos_utils.h"             // LUOS_ASSERT
+
+// CUSTOM
+#include "luos_mesh_msg.h"          // LUOS_MESH_MSG_MAX_DATA_SIZE
+#include "mesh_bridge.h"            // MESH_BRIDGE_*
+
+/*      TYPEDEFS                                                    */
+
+// Last value received from a remote container for a command.
+typedef struct
+{
+    // Luos systick value at reception.
+    uint32_t    timestamp;
+
+    uint8_t     cmd;
+    uint8_t     size;
+    uint8_t     data[LUOS_MESH_MSG_MAX_DATA_SIZE];
+
+} cached_value_t;
+
+// Cached values of a remote container.
+typedef struct
+{
+    // Local ID of the remote container.
+    uint16_t        local_id;
+
+    // Luos systick value at which a request was last forwarded.
+    uint32_t        forward_time;
+
+    // Describes if a request was forwarded since the entry was created.
+    bool            forwarded;
+
+    // Local ID of the container whose request was last forwarded.
+    uint16_t        requester;
+
+    // Describes if the remote container pushes its values.
+    bool            subscribed;
+
+    // Local ID of the container the values are pushed to.
+    uint16_t        subscriber;
+
+    uint8_t         nb_values;
+    cached_value_t  values[RESPONSE_CACHE_MAX_NB_VALUES];
+
+} cache_entry_t;
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+// The internal response cache.
+static struct
+{
+    // Number of entries contained in the cache.
+    uint16_t        nb_entries;
+
+    // Array of cache entries.
+    cache_entry_t   entries[REMOTE_CONTAINER_TABLE_MAX_NB_ENTRIES];
+
+} s_response_cache  =
+{
+    // Cache starts as empty.
+    0
+};
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Returns the entry of the remote container with the given local ID,
+** creating it if needed, or NULL if the cache is full.
+*/
+static cache_entry_t* get_entry(uint16_t local_id);
+
+// Returns true if the given command carries a value of a container.
+static bool is_value_cmd(uint8_t cmd);
+
+bool response_cache_answer(container_t* instance, const msg_t* ask_pub)
+{
+    // Check parameters.
+    LUOS_ASSERT(instance != NULL);
+    LUOS_ASSERT(ask_pub != NULL);
+
+    cache_entry_t*  entry   = get_entry(ask_pub->header.target);
+    if ((RESPONSE_CACHE_MAX_AGE_MS == 0) || (entry == NULL))
+    {
+        return false;
+    }
+
+    uint32_t        now         = Luos_GetSystick();
+    bool            fresh       = (entry->nb_values > 0);
+
+    for (uint8_t value_idx = 0; (value_idx < entry->nb_values) && fresh;
+         value_idx++)
+    {
+        // A partial answer would miss the other values.
+        fresh   = ((now - entry->values[value_idx].timestamp) <= RESPONSE_CACHE_MAX_AGE_MS);
+    }
+
+    if (!fresh)
+    {
+        /* Forwarded: its answers rebuild the cache, so that values no
+        ** longer published do not keep it from answering.
+        */
+        entry->forward_time = now;
+        entry->forwarded    = true;
+        entry->requester    = ask_pub->header.source;
+        entry->nb_values    = 0;
+
+        return false;
+    }
+
+    for (uint8_t value_idx = 0; value_idx < entry->nb_values; value_idx++)
+    {
+        const cached_value_t*   value   = entry->values + value_idx;
+
+        msg_t   answer;
+        memset(&answer, 0, sizeof(msg_t));
+        answer.header.target_mode   = ID;
+        answer.header.target        = ask_pub->header.source;
+        answer.header.cmd           = value->cmd;
+        answer.header.size          = value->size;
+        memcpy(answer.data, value->data, value->size);
+
+        Luos_SendMsg(instance, &answer);
+    }
+
+    return true;
+}
+
+void response_cache_store(uint16_t local_id, const msg_t* msg)
+{
+    // Check parameter.
+    LUOS_ASSERT(msg != NULL);
+
+    if (msg->header.cmd == MESH_BRIDGE_SUBSCRIBED)
+    {
+        // Pushed values are cached from now on.
+        uint16_t        period_ms   = 0;
+        memcpy(&period_ms, msg->data, sizeof(uint16_t));
+
+        cache_entry_t*  entry       = get_entry(local_id);
+        if (entry != NULL)
+        {
+            entry->subscribed   = (period_ms != 0);
+            entry->subscriber   = msg->header.target;
+        }
+
+        return;
+    }
+
+    if (!is_value_cmd(msg->header.cmd)
+        || (msg->header.size > LUOS_MESH_MSG_MAX_DATA_SIZE))
+    {
+        return;
+    }
+
+    cache_entry_t*  entry   = get_entry(local_id);
+    if (entry == NULL)
+    {
+        return;
+    }
+
+    // Only values sent to the requester or to the subscriber are known to be published ones.
+    uint32_t        now     = Luos_GetSystick();
+    bool            answer  = entry->forwarded
+                              && ((now - entry->forward_time) <= RESPONSE_CACHE_REPLY_WINDOW_MS)
+                              && (msg->header.target == entry->requester);
+    bool            pushed  = entry->subscribed
+                              && (msg->header.target == entry->subscriber);
+    if (!answer && !pushed)
+    {
+        // Not a published value.
+        return;
+    }
+
+    cached_value_t* value   = NULL;
+    for (uint8_t value_idx = 0; value_idx < entry->nb_values; value_idx++)
+    {
+        if (entry->values[value_idx].cmd == msg->header.cmd)
+        {
+            value   = entry->values + value_idx;
+            break;
+        }
+    }
+
+    if (value == NULL)
+    {
+        if (entry->nb_values >= RESPONSE_CACHE_MAX_NB_VALUES)
+        {
+            // No room left for this command.
+            return;
+        }
+
+        value       = entry->values + entry->nb_values;
+        value->cmd  = msg->header.cmd;
+        entry->nb_values++;
+    }
+
+    value->timestamp    = now;
+    value->size         = msg->header.size;
+    memcpy(value->data, msg->data, msg->header.size);
+}
+
+void response_cache_clear(void)
+{
+    // Empty cache.
+    memset(&s_response_cache, 0, sizeof(s_response_cache));
+}
+
+static cache_entry_t* get_entry(uint16_t local_id)
+{
+    for (uint16_t entry_idx = 0; entry_idx < s_response_cache.nb_entries;
+         entry_idx++)
+    {
+        cache_entry_t*  entry   = s_response_cache.entries + entry_idx;
+
+        if (entry->local_id == local_id)
+        {
+            return entry;
+        }
+    }
+
+    if (s_response_cache.nb_entries >= REMOTE_CONTAINER_TABLE_MAX_NB_ENTRIES)
+    {
+        // Cache is full: insertion is not possible.
+        return NULL;
+    }
+
+    cache_entry_t*  entry   = s_response_cache.entries + s_response_cache.nb_entries;
+    memset(entry, 0, sizeof(cache_entry_t));
+    entry->local_id = local_id;
+    s_response_cache.nb_entries++;
+
+    return entry;
+}
+
+static bool is_value_cmd(uint8_t cmd)
+{
+    if ((cmd >= MESH_BRIDGE_MSG_BEGIN) && (cmd < MESH_BRIDGE_MSG_END))
+    {
+        // Mesh Bridge messages are not values.
+        return false;
+    }
+
+    switch (cmd)
+    {
+    case ASSERT:
+    case ASK_PUB_CMD:
+        return false;
+    default:
+        return true;
+    }
+}
@@ -0,0 +1,284 @@
+#include "subscription_table.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdbool.h>                // bool
+#include <stdint.h>                 // uint*_t
+#include <string.h>                 // memcmp, memcpy, memset
+
+// LUOS
+#include "luos.h"                   // Luos_SendMsg, Luos_GetSystick
+#include "luos_utils.h"             // LUOS_ASSERT
+
+// CUSTOM
+#include "luos_mesh_msg.h"          // LUOS_MESH_MSG_MAX_DATA_SIZE
+#include "remote_container_table.h" // remote_container_table_*
+
+// NRF
+#ifdef DEBUG
+#include "nrf_log.h"                // NRF_LOG_INFO
+#endif /* DEBUG */
+
+/*      TYPEDEFS                                                    */
+
+// Last value sent through the Mesh network for a command.
+typedef struct
+{
+    uint8_t     cmd;
+    uint8_t     size;
+    uint8_t     data[LUOS_MESH_MSG_MAX_DATA_SIZE];
+
+} sent_value_t;
+
+// Subscription of a remote container to a local one.
+typedef struct
+{
+    // Local ID of the subscribed container.
+    uint16_t        local_id;
+
+    // Local ID of the instance of the subscribing remote container.
+    uint16_t        subscriber_id;
+
+    // Subscription parameters.
+    uint16_t        period_ms;
+    float           deadband;
+
+    // Luos systick value at which values are asked next.
+    uint32_t        next_poll;
+
+    // Last values sent through the Mesh network.
+    uint8_t         nb_values;
+    sent_value_t    values[SUBSCRIPTION_TABLE_MAX_NB_VALUES];
+
+} subscription_t;
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+_Static_assert(sizeof(mesh_bridge_subscription_t) <= LUOS_MESH_MSG_MAX_DATA_SIZE,
+               "Subscriptions do not fit in a Luos Mesh message!");
+
+// The internal table of subscriptions.
+static struct
+{
+    // Number of entries contained in the subscription table.
+    uint16_t        nb_subscriptions;
+
+    // Array of subscriptions.
+    subscription_t  subscriptions[SUBSCRIPTION_TABLE_MAX_NB_ENTRIES];
+
+} s_subscription_table  =
+{
+    // Table starts as empty.
+    0
+};
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Returns the subscription of the given remote container to the given
+** local one, or NULL if it does not exist.
+*/
+static subscription_t* find_subscription(uint16_t local_id,
+                                         uint16_t subscriber_id);
+
+/* Returns true if the given value differs from the given sent one by
+** more than the given deadband.
+*/
+static bool value_changed(const sent_value_t* sent, const msg_t* msg,
+                          float deadband);
+
+uint16_t subscription_table_set(uint16_t local_id, uint16_t subscriber_id,
+                                const mesh_bridge_subscription_t* subscription)
+{
+    // Check parameter.
+    LUOS_ASSERT(subscription != NULL);
+
+    subscription_t* entry   = find_subscription(local_id, subscriber_id);
+
+    if (subscription->period_ms == 0)
+    {
+        if (entry != NULL)
+        {
+            // Remove entry, replacing it by the last one.
+            subscription_t* last_entry;
+            last_entry  = s_subscription_table.subscriptions + s_subscription_table.nb_subscriptions - 1;
+            if (entry != last_entry)
+            {
+                memcpy(entry, last_entry, sizeof(subscription_t));
+            }
+
+            s_subscription_table.nb_subscriptions--;
+        }
+
+        return 0;
+    }
+
+    if (entry == NULL)
+    {
+        if (s_subscription_table.nb_subscriptions >= SUBSCRIPTION_TABLE_MAX_NB_ENTRIES)
+        {
+            // Table is full: insertion is not possible.
+            return 0;
+        }
+
+        entry   = s_subscription_table.subscriptions + s_subscription_table.nb_subscriptions;
+        s_subscription_table.nb_subscriptions++;
+    }
+
+    // (Re)start subscription, first values are always sent.
+    memset(entry, 0, sizeof(subscription_t));
+    entry->local_id         = local_id;
+    entry->subscriber_id    = subscriber_id;
+    entry->period_ms        = subscription->period_ms;
+    entry->deadband         = subscription->deadband;
+    entry->next_poll        = Luos_GetSystick();
+
+    #ifdef DEBUG
+    NRF_LOG_INFO("Container %u subscribed to container %u every %u ms!",
+                 subscriber_id, local_id, subscription->period_ms);
+    #endif /* DEBUG */
+
+    return entry->period_ms;
+}
+
+void subscription_table_poll(void)
+{
+    uint32_t    now = Luos_GetSystick();
+
+    for (uint16_t entry_idx = 0;
+         entry_idx < s_subscription_table.nb_subscriptions;
+         entry_idx++)
+    {
+        subscription_t* entry   = s_subscription_table.subscriptions + entry_idx;
+
+        if ((int32_t)(now - entry->next_poll) < 0)
+        {
+            // Not due yet.
+            continue;
+        }
+
+        entry->next_poll    = now + entry->period_ms;
+
+        // Instance of the subscribing container, asking on its behalf.
+        remote_container_t* subscriber;
+        subscriber  = remote_container_table_get_entry_from_local_id(entry->subscriber_id);
+        if (subscriber == NULL)
+        {
+            continue;
+        }
+
+        // Answers are filtered when sent back to the subscriber.
+        msg_t   ask_pub;
+        memset(&ask_pub, 0, sizeof(msg_t));
+        ask_pub.header.target_mode  = ID;
+        ask_pub.header.target       = entry->local_id;
+        ask_pub.header.cmd          = ASK_PUB_CMD;
+
+        Luos_SendMsg(subscriber->local_instance, &ask_pub);
+    }
+}
+
+bool subscription_table_filter(const msg_t* msg)
+{
+    // Check parameter.
+    LUOS_ASSERT(msg != NULL);
+
+    subscription_t* entry   = find_subscription(msg->header.source,
+                                                msg->header.target);
+    if ((entry == NULL) || (msg->header.size > LUOS_MESH_MSG_MAX_DATA_SIZE))
+    {
+        // Not a subscription value.
+        return true;
+    }
+
+    sent_value_t*   sent    = NULL;
+    for (uint8_t value_idx = 0; value_idx < entry->nb_values; value_idx++)
+    {
+        if (entry->values[value_idx].cmd == msg->header.cmd)
+        {
+            sent    = entry->values + value_idx;
+            break;
+        }
+    }
+
+    if (sent == NULL)
+    {
+        if (entry->nb_values >= SUBSCRIPTION_TABLE_MAX_NB_VALUES)
+        {
+            // Value cannot be kept: always send it.
+            return true;
+        }
+
+        // First value of this command.
+        sent        = entry->values + entry->nb_values;
+        sent->cmd   = msg->header.cmd;
+        entry->nb_values++;
+    }
+    else if (!value_changed(sent, msg, entry->deadband))
+    {
+        return false;
+    }
+
+    // Keep the sent value, so that slow drifts are sent once large enough.
+    sent->size  = msg->header.size;
+    memcpy(sent->data, msg->data, msg->header.size);
+
+    return true;
+}
+
+void subscription_table_clear(void)
+{
+    // Empty table.
+    memset(&s_subscription_table, 0, sizeof(s_subscription_table));
+}
+
+static subscription_t* find_subscription(uint16_t local_id,
+                                         uint16_t subscriber_id)
+{
+    for (uint16_t entry_idx = 0;
+         entry_idx < s_subscription_table.nb_subscriptions;
+         entry_idx++)
+    {
+        subscription_t* entry   = s_subscription_table.subscriptions + entry_idx;
+
+        if ((entry->local_id == local_id)
+            && (entry->subscriber_id == subscriber_id))
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+static bool value_changed(const sent_value_t* sent, const msg_t* msg,
+                          float deadband)
+{
+    if (sent->size != msg->header.size)
+    {
+        return true;
+    }
+
+    if ((deadband <= 0.0f) || ((sent->size % sizeof(float)) != 0))
+    {
+        // Any change, or not a float value.
+        return memcmp(sent->data, msg->data, sent->size) != 0;
+    }
+
+    // Float values, compared one by one.
+    for (uint8_t offset = 0; offset < sent->size; offset += sizeof(float))
+    {
+        float   sent_value;
+        float   new_value;
+        memcpy(&sent_value, sent->data + offset, sizeof(float));
+        memcpy(&new_value, msg->data + offset, sizeof(float));
+
+        float   change  = new_value - sent_value;
+        if ((change > deadband) || (change < -deadband))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
@@ -15,8 +15,13 @@
 #include "local_container_table.h"  // local_container_table_*
 #include "luos_mesh_msg.h"          // luos_mesh_msg_t
 #include "luos_msg_model.h"         // luos_msg_model_*
+#include "mesh_bridge.h"            // MESH_BRIDGE_SUBSCRIBE*, MESH_BRIDGE_ECHO*
+#include "mesh_bridge_stats.h"      // mesh_bridge_stats_msg_*
+#include "mesh_bridge_trace.h"      // MESH_BRIDGE_TRACE_*
 #include "mesh_msg_queue_manager.h" // tx_queue_*, luos_mesh_msg_prepare
 #include "remote_container_table.h" // remote_container_table_*
+#include "response_cache.h"         // response_cache_store
+#include "subscription_table.h"     // subscription_table_set
 
 // NRF
 #ifdef DEBUG
@@ -25,6 +30,9 @@
 
 /*      STATIC VARIABLES & CONSTANTS                                */
 
+_Static_assert(MESH_BRIDGE_ECHO_MAX_SIZE == LUOS_MESH_MSG_MAX_DATA_SIZE,
+               "Echo requests do not match Luos Mesh messages!");
+
 // Static Luos MSG model instance.
 static luos_msg_model_t s_msg_model;
 
@@ -39,6 +47,20 @@ static void msg_to_luos_mesh_msg(const msg_t* msg,
 static void luos_mesh_msg_to_msg(const luos_mesh_msg_t* mesh_msg,
                                  msg_t* msg, uint16_t target);
 
+/* Applies the given subscription of the given remote container to the
+** local container with the given local ID, and answers with the applied
+** period.
+*/
+static void subscribe(const luos_mesh_msg_t* mesh_msg,
+                      const remote_container_t* remote_entry,
+                      uint16_t local_id);
+
+/* Answers the given echo request of the given remote container on behalf
+** of the local container with the given local ID.
+*/
+static void echo(const luos_mesh_msg_t* mesh_msg,
+                 const remote_container_t* remote_entry, uint16_t local_id);
+
 /*      CALLBACKS                                                   */
 
 // Prepares the queue element and enqueues it.
@@ -75,6 +97,9 @@ void app_luos_msg_model_send_msg(const msg_t* msg)
     uint16_t            src_id          = msg->header.source;
     uint16_t            target_id       = msg->header.target;
 
+    MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_SEND, target_id,
+                          msg->header.cmd);
+
     #ifdef DEBUG
     NRF_LOG_INFO("Message received by container %u, from container %u!",
                  target_id, src_id);
@@ -113,10 +138,17 @@ void app_luos_msg_model_send_msg(const msg_t* msg)
     luos_mesh_msg_t mesh_msg;
     msg_to_luos_mesh_msg(msg, &mesh_msg, exposed_src, remote_id);
 
-    // Send message as Luos MSG SET command.
+    /* Send message as Luos MSG SET command, counted once enqueued by
+    ** `msg_model_set_send`.
+    */
     luos_msg_model_set(&s_msg_model, node_addr, &mesh_msg);
 }
 
+uint32_t app_luos_msg_model_get_nb_duplicates(void)
+{
+    return s_msg_model.nb_duplicates;
+}
+
 static void msg_to_luos_mesh_msg(const msg_t* msg,
                                  luos_mesh_msg_t* mesh_msg,
                                  uint16_t source, uint16_t target)
@@ -197,8 +229,11 @@ static void msg_model_set_send(luos_msg_model_t* instance,
     memcpy(&(new_msg.content.luos_msg_model_msg), &msg_model_msg,
            sizeof(tx_queue_luos_msg_model_elm_t));
 
-    // Enqueue given element.
-    luos_mesh_msg_prepare(&new_msg);
+    // Enqueue given element: if the queue is full, it is dropped.
+    if (luos_mesh_msg_prepare(&new_msg))
+    {
+        mesh_bridge_stats_msg_to_mesh();
+    }
 }
 
 static void msg_model_set_cb(uint16_t src_addr,
@@ -210,6 +245,9 @@ static void msg_model_set_cb(uint16_t src_addr,
     // Received message header.
     luos_mesh_header_t  recv_header = recv_msg->header;
 
+    MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_RECEIVE, src_addr,
+                          (recv_header.cmd << 8) | recv_header.size);
+
     // Exposed source and destination IDs.
     uint16_t            msg_src     = recv_header.source;
     uint16_t            msg_dst     = recv_header.target;
@@ -234,17 +272,19 @@ static void msg_model_set_cb(uint16_t src_addr,
                         src_addr, msg_src
                       );
 
-    // Check result.
-    LUOS_ASSERT(remote_entry != NULL);
-
     /* Local container table entry corresponding to the exposed target
     ** ID.
     */
     local_container_t*  local_entry;
     local_entry     = local_container_table_get_entry_from_exposed_id(msg_dst);
 
-    // Check result.
-    LUOS_ASSERT(local_entry != NULL);
+    if ((remote_entry == NULL) || (local_entry == NULL))
+    {
+        /* Source or target missing from the tables, e.g. after a lost
+        ** routing table entry: drop the message.
+        */
+        return;
+    }
 
     // Local target ID.
     uint16_t            local_dst   = local_entry->local_id;
@@ -257,12 +297,74 @@ static void msg_model_set_cb(uint16_t src_addr,
                  local_src, local_dst);
     #endif /* DEBUG */
 
+    if (recv_header.cmd == MESH_BRIDGE_SUBSCRIBE)
+    {
+        // Subscriptions are applied here, not by the target container.
+        subscribe(recv_msg, remote_entry, local_dst);
+        return;
+    }
+
+    if (recv_header.cmd == MESH_BRIDGE_ECHO)
+    {
+        // Round-trip measurements do not involve the target container.
+        echo(recv_msg, remote_entry, local_dst);
+        return;
+    }
+
     // Translate the lightweight Luos Mesh message into a Luos message.
     msg_t               local_msg;
     luos_mesh_msg_to_msg(recv_msg, &local_msg, local_dst);
 
+    // Keep remote values to answer the next requests locally.
+    response_cache_store(remote_entry->local_id, &local_msg);
+
     /* Send message in network through local instance of remote
     ** container.
     */
     Luos_SendMsg(remote_entry->local_instance, &local_msg);
+
+    MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_DELIVER, local_dst,
+                          recv_header.cmd);
+
+    mesh_bridge_stats_msg_from_mesh();
+}
+
+static void subscribe(const luos_mesh_msg_t* mesh_msg,
+                      const remote_container_t* remote_entry,
+                      uint16_t local_id)
+{
+    mesh_bridge_subscription_t  subscription;
+    memset(&subscription, 0, sizeof(mesh_bridge_subscription_t));
+    if (mesh_msg->header.size >= sizeof(mesh_bridge_subscription_t))
+    {
+        memcpy(&subscription, mesh_msg->data,
+               sizeof(mesh_bridge_subscription_t));
+    }
+
+    uint16_t    period_ms   = subscription_table_set(local_id,
+                                                     remote_entry->local_id,
+                                                     &subscription);
+
+    // Answer on behalf of the subscribed container.
+    msg_t       answer;
+    memset(&answer, 0, sizeof(msg_t));
+    answer.header.target_mode   = ID;
+    answer.header.source        = local_id;
+    answer.header.target        = remote_entry->local_id;
+    answer.header.cmd           = MESH_BRIDGE_SUBSCRIBED;
+    answer.header.size          = sizeof(uint16_t);
+    memcpy(answer.data, &period_ms, sizeof(uint16_t));
+
+    app_luos_msg_model_send_msg(&answer);
+}
+
+static void echo(const luos_mesh_msg_t* mesh_msg,
+                 const remote_container_t* remote_entry, uint16_t local_id)
+{
+    // Send the request back, from the requested container.
+    msg_t       answer;
+    luos_mesh_msg_to_msg(mesh_msg, &answer, remote_entry->local_id);
+    answer.header.source        = local_id;
+
+    app_luos_msg_model_send_msg(&answer);
 }
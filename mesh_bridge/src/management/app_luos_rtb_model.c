@@ -3,6 +3,7 @@
 /*      INCLUDES                                                    */
 
 // C STANDARD
+#include <stdbool.h>                // bool
 #include <stdint.h>                 // uint16_t
 #include <string.h>                 // memset
 
@@ -27,6 +28,7 @@
 #include "luos_rtb_model.h"         // luos_rtb_model_*
 #include "luos_rtb_model_common.h"  // LUOS_RTB_MODEL_MAX_RTB_ENTRY
 #include "mesh_bridge.h"            // MESH_BRIDGE_*
+#include "mesh_bridge_stats.h"      // mesh_bridge_stats_rtb_sync_*
 #include "mesh_bridge_utils.h"      /* find_mesh_bridge_container_id,
                                     ** indicate_ext_rtb_*
                                     */
@@ -233,6 +235,8 @@ void app_luos_rtb_model_engage_ext_rtb(uint16_t src_id,
     // Update current state.
     s_luos_rtb_model_ctx.curr_state             = LUOS_RTB_MODEL_STATE_GETTING;
 
+    mesh_bridge_stats_rtb_sync_start();
+
     /* Mesh Bridge container ID, for internal tables update at
     ** detection.
     */
@@ -370,6 +374,8 @@ static void ext_rtb_complete(void)
 
     // Switch status back to Idle.
     s_luos_rtb_model_ctx.curr_state = LUOS_RTB_MODEL_STATE_IDLE;
+
+    mesh_bridge_stats_rtb_sync_end();
 }
 
 static void rtb_model_get_send(luos_rtb_model_t* instance,
@@ -392,8 +398,9 @@ static void rtb_model_get_send(luos_rtb_model_t* instance,
     new_msg.model_handle                = instance->handle;
     new_msg.content.luos_rtb_model_msg  = rtb_model_msg;
 
-    // Enqueue given element.
-    luos_mesh_msg_prepare(&new_msg);
+    // Enqueue given element, in the slots kept for Luos RTB messages.
+    bool    enqueued    = luos_mesh_msg_prepare(&new_msg);
+    LUOS_ASSERT(enqueued);
 }
 
 static void rtb_model_status_send(luos_rtb_model_t* instance,
@@ -418,8 +425,9 @@ static void rtb_model_status_send(luos_rtb_model_t* instance,
     memcpy(&(new_msg.content.luos_rtb_model_msg), &rtb_model_msg,
            sizeof(tx_queue_luos_rtb_model_elm_t));
 
-    // Enqueue given element.
-    luos_mesh_msg_prepare(&new_msg);
+    // Enqueue given element, in the slots kept for Luos RTB messages.
+    bool    enqueued    = luos_mesh_msg_prepare(&new_msg);
+    LUOS_ASSERT(enqueued);
 }
 
 static void rtb_model_status_reply(luos_rtb_model_t* instance,
@@ -448,8 +456,9 @@ static void rtb_model_status_reply(luos_rtb_model_t* instance,
     memcpy(&(new_msg.content.luos_rtb_model_msg),
            &rtb_model_msg, sizeof(tx_queue_luos_rtb_model_elm_t));
 
-    // Enqueue given element.
-    luos_mesh_msg_prepare(&new_msg);
+    // Enqueue given element, in the slots kept for Luos RTB messages.
+    bool    enqueued    = luos_mesh_msg_prepare(&new_msg);
+    LUOS_ASSERT(enqueued);
 }
 
 static void rtb_model_get_cb(uint16_t src_addr)
@@ -488,6 +497,8 @@ static void rtb_model_get_cb(uint16_t src_addr)
     #endif /* DEBUG */
 
     s_luos_rtb_model_ctx.curr_state = LUOS_RTB_MODEL_STATE_REPLYING;
+
+    mesh_bridge_stats_rtb_sync_start();
 }
 
 static void rtb_model_status_cb(uint16_t src_addr,
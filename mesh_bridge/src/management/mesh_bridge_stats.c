@@ -0,0 +1,177 @@
+#include "mesh_bridge_stats.h"
+
+/*      INCLUDES                                                    */
+
+// C STANDARD
+#include <stdatomic.h>              // atomic_*
+#include <stdint.h>                 // uint*_t
+#include <string.h>                 // memset
+
+// LUOS
+#include "luos.h"                   // Luos_GetSystick
+#include "luos_utils.h"             // LUOS_ASSERT
+
+// CUSTOM
+#include "app_luos_msg_model.h"     // app_luos_msg_model_get_nb_duplicates
+
+/*      STATIC VARIABLES & CONSTANTS                                */
+
+/* Every counter is updated from one or several contexts (Luos, Mesh
+** events, timers, any TX queue producer) and read from the Luos context
+** by `mesh_bridge_stats_get`: all of them are atomic.
+*/
+
+// Luos message counters.
+static atomic_uint_fast32_t s_nb_msg_to_mesh        = 0;
+static atomic_uint_fast32_t s_nb_msg_from_mesh      = 0;
+
+// TX queue counters.
+static atomic_uint_fast32_t s_nb_enqueue_failures   = 0;
+static atomic_uint_fast32_t s_queue_high_water      = 0;
+
+// TX complete statistics.
+static struct
+{
+    atomic_uint_fast32_t    nb_complete;
+    atomic_uint_fast32_t    latency_sum_ms;
+    atomic_uint_fast32_t    latency_min_ms;
+    atomic_uint_fast32_t    latency_max_ms;
+    atomic_uint_fast32_t    bytes_on_air;
+
+} s_tx_stats    =
+{
+    // No message sent yet.
+    .latency_min_ms = UINT32_MAX,
+};
+
+// Ext-RTB statistics.
+static struct
+{
+    // Systick value at the start of the current procedure.
+    atomic_uint_fast32_t    start_tick;
+
+    atomic_uint_fast32_t    nb_sync;
+    atomic_uint_fast32_t    last_sync_ms;
+
+} s_rtb_stats;
+
+/*      STATIC FUNCTIONS                                            */
+
+// Increments the given counter.
+static void counter_increment(atomic_uint_fast32_t* counter);
+
+// Stores the given value in the given counter if it is lower.
+static void counter_min(atomic_uint_fast32_t* counter, uint32_t value);
+
+// Stores the given value in the given counter if it is greater.
+static void counter_max(atomic_uint_fast32_t* counter, uint32_t value);
+
+void mesh_bridge_stats_msg_to_mesh(void)
+{
+    counter_increment(&s_nb_msg_to_mesh);
+}
+
+void mesh_bridge_stats_msg_from_mesh(void)
+{
+    counter_increment(&s_nb_msg_from_mesh);
+}
+
+void mesh_bridge_stats_queue_size(uint16_t nb_elements)
+{
+    counter_max(&s_queue_high_water, nb_elements);
+}
+
+void mesh_bridge_stats_enqueue_failure(void)
+{
+    counter_increment(&s_nb_enqueue_failures);
+}
+
+void mesh_bridge_stats_tx_complete(uint32_t latency_ms, uint16_t nb_bytes)
+{
+    counter_increment(&(s_tx_stats.nb_complete));
+    atomic_fetch_add_explicit(&(s_tx_stats.latency_sum_ms), latency_ms,
+                              memory_order_relaxed);
+    atomic_fetch_add_explicit(&(s_tx_stats.bytes_on_air), nb_bytes,
+                              memory_order_relaxed);
+
+    counter_min(&(s_tx_stats.latency_min_ms), latency_ms);
+    counter_max(&(s_tx_stats.latency_max_ms), latency_ms);
+}
+
+void mesh_bridge_stats_rtb_sync_start(void)
+{
+    atomic_store_explicit(&(s_rtb_stats.start_tick), Luos_GetSystick(),
+                          memory_order_relaxed);
+}
+
+void mesh_bridge_stats_rtb_sync_end(void)
+{
+    uint32_t    start_tick  = atomic_load_explicit(&(s_rtb_stats.start_tick),
+                                                   memory_order_relaxed);
+
+    atomic_store_explicit(&(s_rtb_stats.last_sync_ms),
+                          Luos_GetSystick() - start_tick,
+                          memory_order_relaxed);
+    counter_increment(&(s_rtb_stats.nb_sync));
+}
+
+void mesh_bridge_stats_get(mesh_bridge_stats_t* stats)
+{
+    // Check parameter.
+    LUOS_ASSERT(stats != NULL);
+
+    memset(stats, 0, sizeof(mesh_bridge_stats_t));
+    stats->nb_msg_to_mesh       = atomic_load(&s_nb_msg_to_mesh);
+    stats->nb_msg_from_mesh     = atomic_load(&s_nb_msg_from_mesh);
+    stats->queue_high_water     = (uint16_t)atomic_load(&s_queue_high_water);
+    stats->nb_enqueue_failures  = atomic_load(&s_nb_enqueue_failures);
+    stats->nb_duplicate_drops   = app_luos_msg_model_get_nb_duplicates();
+    stats->nb_rtb_sync          = atomic_load(&(s_rtb_stats.nb_sync));
+    stats->last_rtb_sync_ms     = atomic_load(&(s_rtb_stats.last_sync_ms));
+    stats->bytes_on_air         = atomic_load(&(s_tx_stats.bytes_on_air));
+
+    /* The sum may already count a TX complete event that the number does
+    ** not, which only shifts the average by a fraction of a latency.
+    */
+    uint32_t    nb_complete     = atomic_load(&(s_tx_stats.nb_complete));
+    if (nb_complete > 0)
+    {
+        stats->tx_latency_min_ms    = atomic_load(&(s_tx_stats.latency_min_ms));
+        stats->tx_latency_avg_ms    = atomic_load(&(s_tx_stats.latency_sum_ms))
+                                      / nb_complete;
+        stats->tx_latency_max_ms    = atomic_load(&(s_tx_stats.latency_max_ms));
+    }
+}
+
+static void counter_increment(atomic_uint_fast32_t* counter)
+{
+    atomic_fetch_add_explicit(counter, 1, memory_order_relaxed);
+}
+
+static void counter_min(atomic_uint_fast32_t* counter, uint32_t value)
+{
+    uint_fast32_t   current;
+    current = atomic_load_explicit(counter, memory_order_relaxed);
+
+    // On failure, the current value is reloaded.
+    while ((value < current)
+           && !atomic_compare_exchange_weak_explicit(
+                counter, &current, value,
+                memory_order_relaxed, memory_order_relaxed
+              ))
+    {}
+}
+
+static void counter_max(atomic_uint_fast32_t* counter, uint32_t value)
+{
+    uint_fast32_t   current;
+    current = atomic_load_explicit(counter, memory_order_relaxed);
+
+    // On failure, the current value is reloaded.
+    while ((value > current)
+           && !atomic_compare_exchange_weak_explicit(
+                counter, &current, value,
+                memory_order_relaxed, memory_order_relaxed
+              ))
+    {}
+}
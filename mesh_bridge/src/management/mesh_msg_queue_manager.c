@@ -3,7 +3,9 @@
 /*      INCLUDES                                                    */
 
 // C STANDARD
+#include <stdatomic.h>              // atomic_*
 #include <stdbool.h>                // bool
+#include <string.h>                 // memset
 
 // NRF
 #include "sdk_errors.h"             // ret_code_t
@@ -18,6 +20,7 @@
 #include "nrf_mesh.h"               // NRF_MESH_TRANSMIC_SIZE_DEFAULT
 
 // LUOS
+#include "luos.h"                   // Luos_GetSystick
 #include "luos_utils.h"             // LUOS_ASSERT
 
 // CUSTOM
@@ -25,6 +28,8 @@
 #include "local_container_table.h"  // local_container_table_get_nb_entries
 #include "luos_mesh_msg.h"          // LUOS_MESH_MSG_MAX_DATA_SIZE
 #include "luos_mesh_msg_queue.h"    // tx_queue_elm_t
+#include "mesh_bridge_stats.h"      // mesh_bridge_stats_*
+#include "mesh_bridge_trace.h"      // MESH_BRIDGE_TRACE_*
 #include "luos_msg_model.h"         // luos_msg_model_*
 #include "luos_msg_model_common.h"  // LUOS_MSG_MODEL_*_ACCESS_OPCODE
 #include "luos_rtb_model.h"         // luos_rtb_model_*
@@ -32,14 +37,20 @@
 
 /*      STATIC VARIABLES & CONSTANTS                                */
 
-// Describes if a message can be sent.
-static bool                 s_is_possible_to_send   = true;
+/* Describes if a message can be sent. The context swapping it from true
+** to false owns the right to send, and is the only one allowed to peek
+** and pop the message queue until the right is given back.
+*/
+static atomic_bool          s_is_possible_to_send   = true;
 
 // Default value for currently sent message token.
 #define                     DEFAULT_STATIC_TOKEN    0xFFFF;
 
 // Token of the currently sent message.
-static nrf_mesh_tx_token_t  s_curr_tx_token         = DEFAULT_STATIC_TOKEN;
+static volatile nrf_mesh_tx_token_t s_curr_tx_token = DEFAULT_STATIC_TOKEN;
+
+// Systick value when the current message was sent, for statistics.
+static volatile uint32_t    s_curr_tx_tick          = 0;
 
 // Wait time between TX complete event and next message sent.
 #define                     WAIT_TIME_MS            5
@@ -47,8 +58,15 @@ static const uint32_t       WAIT_TIME_TICKS         = APP_TIMER_TICKS(WAIT_TIME_
 
 /*      STATIC FUNCTIONS                                            */
 
-// Publishes or replies the last queue element if there is one.
-static void send_mesh_msg(void);
+/* Takes the right to send if it is available and sends the last queue
+** element, or gives the right back if the queue is empty.
+*/
+static void try_send_mesh_msg(void);
+
+/* Publishes or replies the last queue element if there is one. Returns
+** true if a message was sent, false otherwise.
+*/
+static bool send_mesh_msg(void);
 
 // Prepares the given Luos RTB message with the given characteristics.
 static void send_luos_rtb_model_msg(const tx_queue_elm_t* elm,
@@ -66,6 +84,11 @@ static void send_luos_msg_model_msg(const tx_queue_elm_t* elm,
 */
 static bool is_last_published_rtb_entry(const tx_queue_elm_t* elm);
 
+/* Returns the access layer payload size of the given queue element:
+** vendor opcode (company ID and opcode byte) and parameters.
+*/
+static uint16_t get_access_payload_size(const tx_queue_elm_t* elm);
+
 /*      CALLBACKS                                                   */
 
 /* If the event token matches the current one, toggles the send boolean
@@ -101,7 +124,7 @@ void luos_mesh_msg_queue_manager_init(void)
     APP_ERROR_CHECK(err_code);
 }
 
-void luos_mesh_msg_prepare(const tx_queue_elm_t* message)
+bool luos_mesh_msg_prepare(const tx_queue_elm_t* message)
 {
     // Check parameter.
     LUOS_ASSERT(message != NULL);
@@ -109,24 +132,66 @@ void luos_mesh_msg_prepare(const tx_queue_elm_t* message)
     // Enqueue given TX queue element.
     bool    insert_success  = luos_mesh_msg_queue_enqueue(message);
 
-    // Check insertion result.
-    LUOS_ASSERT(insert_success);
+    if (insert_success)
+    {
+        uint16_t    nb_elements = luos_mesh_msg_queue_get_nb_elements();
+
+        MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_ENQUEUE, message->model,
+                              nb_elements);
+
+        mesh_bridge_stats_queue_size(nb_elements);
+    }
+    else
+    {
+        MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_ENQUEUE_FAIL,
+                              message->model, 0);
+
+        /* Queue is full: drop the message, but keep sending the queued
+        ** ones.
+        */
+        mesh_bridge_stats_enqueue_failure();
+    }
+
+    // Send last message in queue if sending is possible.
+    try_send_mesh_msg();
+
+    return insert_success;
+}
 
-    if (s_is_possible_to_send)
+static void try_send_mesh_msg(void)
+{
+    while (atomic_exchange(&s_is_possible_to_send, false))
     {
-        // Send last message in queue if sending is possible.
-        send_mesh_msg();
+        // Right to send acquired: this context is the queue consumer.
+        bool    msg_sent    = send_mesh_msg();
+        if (msg_sent)
+        {
+            // Right will be given back after the TX complete event.
+            return;
+        }
+
+        // Queue is empty: give the right back.
+        atomic_store(&s_is_possible_to_send, true);
+
+        if (luos_mesh_msg_queue_is_empty())
+        {
+            return;
+        }
+
+        /* A producer enqueued a message while the right was taken, and
+        ** could not send it: try again.
+        */
     }
 }
 
-static void send_mesh_msg(void)
+static bool send_mesh_msg(void)
 {
     // Fetch last queue element.
     tx_queue_elm_t*     last_queue_elm  = luos_mesh_msg_queue_peek();
     if (last_queue_elm == NULL)
     {
         // Queue is empty: nothing to send.
-        return;
+        return false;
     }
 
     // Message to send on Access layer.
@@ -134,6 +199,16 @@ static void send_mesh_msg(void)
     memset(&message, 0, sizeof(access_message_tx_t));
     message.transmic_size   = NRF_MESH_TRANSMIC_SIZE_DEFAULT;   // Size of transmission check data.
     message.access_token    = nrf_mesh_unique_token_get();      // Token identifying Mesh stack transaction.
+
+    /* Set current Mesh stack transaction identifier for TX complete
+    ** ID check before sending, as the event may preempt this context.
+    */
+    s_curr_tx_token         = message.access_token;
+    s_curr_tx_tick          = Luos_GetSystick();
+
+    MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_PUBLISH, last_queue_elm->model,
+                          message.access_token);
+
     switch (last_queue_elm->model)
     {
     case TX_QUEUE_MODEL_LUOS_RTB:
@@ -149,16 +224,11 @@ static void send_mesh_msg(void)
     default:
         // Unknown type: break down.
         LUOS_ASSERT(false);
-        return;
+        return false;
     }
 
-    /* Set current Mesh stack transaction identifier for TX complete
-    ** ID check.
-    */
-    s_curr_tx_token         = message.access_token;
-
-    // Send operation is occuring: impossible to send a new message.
-    s_is_possible_to_send   = false;
+    // Send operation is occuring: the right to send stays taken.
+    return true;
 }
 
 static void send_luos_rtb_model_msg(const tx_queue_elm_t* elm,
@@ -328,6 +398,28 @@ static bool is_last_published_rtb_entry(const tx_queue_elm_t* elm)
     return false;
 }
 
+static uint16_t get_access_payload_size(const tx_queue_elm_t* elm)
+{
+    // Check parameter.
+    LUOS_ASSERT(elm != NULL);
+
+    // Vendor-specific opcode size.
+    uint16_t    opcode_size = sizeof(uint16_t) + sizeof(uint8_t);
+
+    if (elm->model == TX_QUEUE_MODEL_LUOS_MSG)
+    {
+        return opcode_size + sizeof(luos_msg_model_set_t);
+    }
+
+    if (elm->content.luos_rtb_model_msg.cmd == TX_QUEUE_CMD_GET)
+    {
+        return opcode_size + sizeof(luos_rtb_model_get_t);
+    }
+
+    // STATUS message or reply.
+    return opcode_size + sizeof(luos_rtb_model_status_t);
+}
+
 static void mesh_tx_complete_event_cb(const nrf_mesh_evt_t* event)
 {
     switch (event->type)
@@ -341,6 +433,8 @@ static void mesh_tx_complete_event_cb(const nrf_mesh_evt_t* event)
         {
             // Completed transaction is the last sent message.
 
+            MESH_BRIDGE_TRACE_EVT(MESH_BRIDGE_TRACE_TX_COMPLETE, 0, token);
+
             // Reset current transaction token.
             s_curr_tx_token = DEFAULT_STATIC_TOKEN;
 
@@ -350,6 +444,9 @@ static void mesh_tx_complete_event_cb(const nrf_mesh_evt_t* event)
             // Check result.
             LUOS_ASSERT(sent_elm != NULL);
 
+            mesh_bridge_stats_tx_complete(Luos_GetSystick() - s_curr_tx_tick,
+                                          get_access_payload_size(sent_elm));
+
             // Check if sent message was the last exposed entry.
             bool            is_last_entry   = is_last_published_rtb_entry(sent_elm);
             if (is_last_entry)
@@ -385,8 +482,8 @@ static void mesh_tx_complete_event_cb(const nrf_mesh_evt_t* event)
 static void timer_to_send_event_cb(void* context)
 {
     // It is now possible to send a new message.
-    s_is_possible_to_send = true;
+    atomic_store(&s_is_possible_to_send, true);
 
     // Try sending a new message.
-    send_mesh_msg();
+    try_send_mesh_msg();
 }
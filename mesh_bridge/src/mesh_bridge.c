@@ -4,6 +4,7 @@
 
 // C STANDARD
 #include <stdint.h>                 // uint16_t
+#include <string.h>                 // memset, memcpy
 
 // LUOS
 #include "luos.h"                   /* container_t,
@@ -15,29 +16,56 @@
 #include "app_luos_rtb_model.h"     // app_luos_rtb_model_get
 #include "local_container_table.h"  // local_container_table_*
 #include "luos_mesh_common.h"       // mesh_start
+#include "mesh_bridge_stats.h"      // mesh_bridge_stats_get
+#include "mesh_bridge_trace.h"      // mesh_bridge_trace_drain
 #include "mesh_init.h"              // mesh_init, g_device_provisioned
 #include "provisioning.h"           /* provisioning_init,
                                     ** persistent_conf_init,
                                     ** prov_listening_start
                                     */
 #include "remote_container_table.h" // remote_container_table_print
+#include "subscription_table.h"     // subscription_table_*
 
 // NRF
 #ifdef DEBUG
 #include "nrf_log.h"                // NRF_LOG_INFO
 #endif /* DEBUG */
 
+#ifdef MESH_BRIDGE_TRACE
+#include "SEGGER_RTT.h"             // SEGGER_RTT_*
+#endif /* MESH_BRIDGE_TRACE */
+
 /*      STATIC/GLOBAL VARIABLES & CONSTANTS                         */
 
 #ifndef REV
 #define REV {0,0,1}
 #endif
 
+_Static_assert(sizeof(mesh_bridge_stats_t) <= MAX_DATA_MSG_SIZE,
+               "Mesh Bridge statistics do not fit in a Luos message!");
+
 /*      STATIC VARIABLE & CONSTANTS                                 */
 
 // Static container instance.
 container_t*    s_mesh_bridge_instance;
 
+#ifdef MESH_BRIDGE_TRACE
+// RTT up channel dedicated to trace records.
+#ifndef MESH_BRIDGE_TRACE_RTT_CHANNEL
+#define MESH_BRIDGE_TRACE_RTT_CHANNEL   1
+#endif /* ! MESH_BRIDGE_TRACE_RTT_CHANNEL */
+
+// Buffer of the trace RTT channel, holding a full trace ring.
+static uint8_t  s_trace_rtt_buffer[MESH_BRIDGE_TRACE_SIZE * sizeof(mesh_bridge_trace_record_t)];
+
+/*      STATIC FUNCTIONS                                            */
+
+/* Sends the given trace records on the trace RTT channel, and returns
+** the number of bytes it took.
+*/
+static uint16_t trace_rtt_write(const uint8_t* data, uint16_t size);
+#endif /* MESH_BRIDGE_TRACE */
+
 /*      CALLBACKS                                                   */
 
 /* EXT-RTB:             Engages EXT-RTB procedure.
@@ -47,6 +75,7 @@ container_t*    s_mesh_bridge_instance;
 **                      entries.
 ** Update tables:       Update the local IDs of entries from internal
 **                      tables.
+** Get stats:           Answers with the runtime statistics.
 */
 static void MeshBridge_MsgHandler(container_t* container, msg_t* msg);
 
@@ -57,6 +86,14 @@ void MeshBridge_Init(void)
     NRF_LOG_INFO("Mesh MSG begin: 0x%x!", MESH_BRIDGE_MSG_BEGIN);
     #endif /* DEBUG */
 
+    #ifdef MESH_BRIDGE_TRACE
+    // Records are dropped rather than blocking when the host is slow.
+    SEGGER_RTT_ConfigUpBuffer(MESH_BRIDGE_TRACE_RTT_CHANNEL, "trace",
+                              s_trace_rtt_buffer,
+                              sizeof(s_trace_rtt_buffer),
+                              SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+    #endif /* MESH_BRIDGE_TRACE */
+
     // Initialize Mesh stack.
     mesh_init();
 
@@ -103,7 +140,24 @@ void MeshBridge_Init(void)
 }
 
 void MeshBridge_Loop(void)
-{}
+{
+    // Ask subscribed containers for their values.
+    subscription_table_poll();
+
+    #ifdef MESH_BRIDGE_TRACE
+    // Send trace records to the host.
+    mesh_bridge_trace_drain(trace_rtt_write);
+    #endif /* MESH_BRIDGE_TRACE */
+}
+
+#ifdef MESH_BRIDGE_TRACE
+static uint16_t trace_rtt_write(const uint8_t* data, uint16_t size)
+{
+    // Nothing is written if the channel cannot take the whole buffer.
+    return (uint16_t)SEGGER_RTT_Write(MESH_BRIDGE_TRACE_RTT_CHANNEL, data,
+                                      size);
+}
+#endif /* MESH_BRIDGE_TRACE */
 
 static void MeshBridge_MsgHandler(container_t* container, msg_t* msg)
 {
@@ -134,6 +188,7 @@ static void MeshBridge_MsgHandler(container_t* container, msg_t* msg)
         // Clear internal tables.
         local_container_table_clear();
         remote_container_table_clear();
+        subscription_table_clear();
 
         response.header.cmd     = MESH_BRIDGE_INTERNAL_TABLES_CLEARED;
 
@@ -161,10 +216,25 @@ static void MeshBridge_MsgHandler(container_t* container, msg_t* msg)
         local_container_table_update_local_ids(dtx_container_id);
         remote_container_table_update_local_ids(dtx_container_id);
 
+        // Subscriptions use local IDs: subscribers shall subscribe again.
+        subscription_table_clear();
+
         response.header.cmd     = MESH_BRIDGE_INTERNAL_TABLES_UPDATED;
     }
         break;
 
+    case MESH_BRIDGE_GET_STATS:
+    {
+        mesh_bridge_stats_t stats;
+        mesh_bridge_stats_get(&stats);
+
+        // Answer with current statistics.
+        response.header.cmd     = MESH_BRIDGE_STATS;
+        response.header.size    = sizeof(mesh_bridge_stats_t);
+        memcpy(response.data, &stats, sizeof(mesh_bridge_stats_t));
+    }
+        break;
+
     default:
         // Nothing to do: return.
         return;
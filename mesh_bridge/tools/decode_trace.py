@@ -0,0 +1,104 @@
+#!/usr/bin/env python3
+"""Decodes a Mesh Bridge binary trace, as drained on its RTT trace channel.
+
+Usage: decode_trace.py TRACE_FILE [--freq HZ] [--timer-bits BITS]
+
+The trace file is the raw content of the RTT trace channel, for example
+recorded with `JLinkRTTLogger -RTTChannel 1`. Each record is 12 bytes,
+little-endian: timestamp (u32), event (u8), magic (u8), arg0 (u16),
+arg1 (u32). See `mesh_bridge_trace.h`.
+"""
+
+import argparse
+import struct
+import sys
+
+RECORD = struct.Struct("<IBBHI")
+MAGIC = 0x5A
+
+EVENTS = [
+    "LOST",
+    "SEND",
+    "ENQUEUE",
+    "ENQUEUE_FAIL",
+    "PUBLISH",
+    "TX_COMPLETE",
+    "RECEIVE",
+    "DELIVER",
+]
+
+MODELS = {1: "RTB", 2: "MSG"}
+
+
+def describe(event, arg0, arg1):
+    """Returns a readable description of the event arguments."""
+    name = EVENTS[event] if event < len(EVENTS) else "EVT_%u" % event
+
+    if name == "LOST":
+        return "%u records lost" % arg1
+    if name in ("SEND", "DELIVER"):
+        return "container %u, cmd 0x%x" % (arg0, arg1)
+    if name == "ENQUEUE":
+        return "model %s, %u queued" % (MODELS.get(arg0, arg0), arg1)
+    if name == "ENQUEUE_FAIL":
+        return "model %s" % MODELS.get(arg0, arg0)
+    if name == "PUBLISH":
+        return "model %s, token %u" % (MODELS.get(arg0, arg0), arg1)
+    if name == "TX_COMPLETE":
+        return "token %u" % arg1
+    if name == "RECEIVE":
+        return "node 0x%x, cmd 0x%x, %u bytes" % (arg0, arg1 >> 8,
+                                                 arg1 & 0xFF)
+    return "arg0 %u, arg1 %u" % (arg0, arg1)
+
+
+def records(data):
+    """Yields decoded records, skipping bytes until records align."""
+    offset = 0
+    while offset + RECORD.size <= len(data):
+        timestamp, event, magic, arg0, arg1 = RECORD.unpack_from(data,
+                                                                 offset)
+        if magic != MAGIC:
+            # Stream started mid-record: resynchronize.
+            offset += 1
+            continue
+
+        yield timestamp, event, arg0, arg1
+        offset += RECORD.size
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("trace_file")
+    parser.add_argument("--freq", type=float, default=32768.0,
+                        help="app timer frequency in Hz (default: 32768)")
+    parser.add_argument("--timer-bits", type=int, default=24,
+                        help="app timer counter width (default: 24)")
+    args = parser.parse_args()
+
+    with open(args.trace_file, "rb") as trace_file:
+        data = trace_file.read()
+
+    wrap = 1 << args.timer_bits
+    elapsed = 0
+    previous = None
+
+    for timestamp, event, arg0, arg1 in records(data):
+        if previous is not None:
+            # An event preempting the recording of another one is dated
+            # before it: read deltas over half the counter as negative.
+            delta = (timestamp - previous) % wrap
+            if delta >= wrap // 2:
+                delta -= wrap
+            elapsed += delta
+        previous = timestamp
+
+        name = EVENTS[event] if event < len(EVENTS) else "EVT_%u" % event
+        print("%12.3f ms  %-12s %s" % (elapsed * 1000.0 / args.freq, name,
+                                       describe(event, arg0, arg1)))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())